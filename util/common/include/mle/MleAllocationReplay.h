@@ -0,0 +1,201 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleAllocationReplay.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_ALLOCATIONREPLAY_H_
+#define __MLE_ALLOCATIONREPLAY_H_
+
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+// The decoded trace, defined in the implementation.
+struct MleReplayTrace;
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleReplayStats holds the measurements taken while replaying an
+ * allocation trace.
+ */
+struct MleReplayStats
+{
+	MlULong m_operations;            /**< Requests replayed. */
+	MlULong m_failures;              /**< Requests that failed in the replay but not when recorded. */
+	MlULong m_elapsedNanoseconds;    /**< Time spent in the manager. */
+	double m_nanosecondsPerOperation; /**< m_elapsedNanoseconds over m_operations. */
+
+	// The following are only gathered when memory is measured.
+	MlULong m_peakRequestedBytes;    /**< High water mark of the bytes requested. */
+	MlULong m_peakUsableBytes;       /**< High water mark of the bytes usable in the blocks. */
+	MlULong m_baseResidentSize;      /**< Resident set size before the replay. */
+	MlULong m_peakResidentSize;      /**< Highest resident set size seen during the replay. */
+
+	/**
+	 * Bytes lost to rounding up requests, as a fraction of the usable
+	 * bytes at their peak.
+	 */
+	double m_internalFragmentation;
+
+	/**
+	 * Resident bytes not accounted for by usable bytes, as a fraction of
+	 * the growth of the resident set. Includes the manager's own
+	 * bookkeeping.
+	 */
+	double m_externalFragmentation;
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleAllocationReplay drives a memory manager from an allocation
+ * trace written by MleRecordingMemoryManager.
+ *
+ * The requests in the trace are replayed on the calling thread in the order
+ * they were recorded, whichever threads made them, so a replay is
+ * deterministic. Requests that failed when recorded are skipped. Failures can
+ * be injected into a replay with MleMemoryManager::setThreadAllocationLimit().
+ *
+ * Timing and memory are measured in separate replays, since measuring memory
+ * queries the manager after every request. The resident set is sampled every
+ * RESIDENT_SAMPLE_INTERVAL requests and at the peak of the requested bytes, so
+ * a short lived peak in between may be missed. For comparable figures, replay
+ * each manager in a fresh process: memory released by one replay is not
+ * necessarily returned to the system before the next.
+ */
+class MleAllocationReplay
+{
+	public:
+
+		/**
+		 * The number of requests between samples of the resident set size.
+		 */
+		static const uint_t RESIDENT_SAMPLE_INTERVAL = 1024;
+
+		/**
+		 * Constructor.
+		 */
+		MleAllocationReplay();
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~MleAllocationReplay();
+
+		/**
+		 * Load an allocation trace.
+		 *
+		 * A trace cut short in the middle of a record, as by a crash, is
+		 * loaded up to the last whole record.
+		 *
+		 * @param filename The name of the trace file.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the trace was loaded.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the file could not be read
+		 *     or is not a trace of a supported version.
+		 * </ul>
+		 */
+		MlResult load(const char *filename);
+
+		/**
+		 * Get the number of records in the loaded trace.
+		 *
+		 * @return The number of records is returned.
+		 */
+		MlULong getRecordCount();
+
+		/**
+		 * Get the number of records of failed requests in the loaded trace.
+		 *
+		 * @return The number of failed requests is returned.
+		 */
+		MlULong getRecordedFailureCount();
+
+		/**
+		 * Get the number of threads that made requests in the loaded trace.
+		 *
+		 * @return The number of threads is returned.
+		 */
+		uint_t getThreadCount();
+
+		/**
+		 * Get the largest number of blocks live at once in the loaded trace.
+		 *
+		 * @return The number of blocks is returned.
+		 */
+		uint_t getObjectCount();
+
+		/**
+		 * Replay the loaded trace.
+		 *
+		 * Blocks still live at the end of the trace are released after the
+		 * measurements are taken.
+		 *
+		 * @param manager The manager to replay the requests on.
+		 * @param stats The measurements are returned.
+		 * @param measureMemory If <b>TRUE</b>, the requested, usable and
+		 * resident bytes are measured, which slows the replay down.
+		 * Otherwise only the time is.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the trace was replayed.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if no trace is loaded.
+		 * </ul>
+		 */
+		MlResult run(MleMemoryManager *manager, MleReplayStats &stats,
+		             MlBoolean measureMemory = FALSE);
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleAllocationReplay(const MleAllocationReplay &);
+		MleAllocationReplay &operator=(const MleAllocationReplay &);
+
+		//
+		// The loaded trace, or NULL.
+		//
+		MleReplayTrace *m_trace;
+};
+
+
+#endif /* __MLE_ALLOCATIONREPLAY_H_ */
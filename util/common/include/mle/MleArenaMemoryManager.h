@@ -0,0 +1,270 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleArenaMemoryManager.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_ARENAMEMORYMANAGER_H_
+#define __MLE_ARENAMEMORYMANAGER_H_
+
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleArenaMemoryManager is a monotonic memory manager.
+ *
+ * Memory is handed out by bumping a pointer through large chunks obtained
+ * from the base memory manager. release() does nothing; instead all memory
+ * allocated after a marker is dropped at once by rewind(), or all of it by
+ * reset(). This suits a phase of work, such as a template run or a title
+ * load, that creates many short lived objects and is finished with them
+ * together.
+ *
+ * An arena is not thread-safe; it is meant to be used by one thread for
+ * the duration of a phase.
+ */
+class MleArenaMemoryManager : public MleMemoryManager
+{
+	public:
+
+		/**
+		 * The default size, in bytes, of the chunks carved up by the arena.
+		 */
+		static const uint_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		/**
+		 * A position in the arena, see getMarker() and rewind().
+		 */
+		struct Marker
+		{
+			void *m_chunk;
+			uint_t m_offset;
+		};
+
+		/**
+		 * @brief Scope rewinds an arena when it goes out of scope.
+		 *
+		 * Everything allocated from the arena during the lifetime of the
+		 * scope is dropped when the scope is destroyed.
+		 */
+		class Scope
+		{
+			public:
+
+				/**
+				 * Constructor.
+				 *
+				 * @param arena The arena to rewind on destruction.
+				 */
+				Scope(MleArenaMemoryManager &arena)
+				  : m_arena(arena), m_marker(arena.getMarker())
+				{}
+
+				/**
+				 * Destructor.
+				 */
+				~Scope()
+				{ m_arena.rewind(m_marker); }
+
+			private:
+
+				// Hide the copy constructor and assignment operator.
+				Scope(const Scope &);
+				Scope &operator=(const Scope &);
+
+				MleArenaMemoryManager &m_arena;
+				Marker m_marker;
+		};
+
+		/**
+		 * Constructor.
+		 *
+		 * @param chunkSize The size of the chunks obtained from the base memory
+		 * manager. Requests that do not fit in a chunk get a chunk of their own.
+		 */
+		MleArenaMemoryManager(uint_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+		/**
+		 * Destructor.
+		 *
+		 * All chunks are returned to the base memory manager.
+		 */
+		virtual ~MleArenaMemoryManager();
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocate(void **memory, uint_t size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * The most recent allocation is grown or shrunk in place when its
+		 * chunk has room; any other memory is copied to a new allocation.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resize(void **memory, uint_t newSize);
+
+		/**
+		 * Releases an allocated chunk of memory.  See base class description.
+		 *
+		 * The memory is not reused until the arena is rewound or reset.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is not NULL.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult release(void **memory);
+
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 *
+		 * The most recent allocation can grow while its chunk has room;
+		 * others only within their alignment padding.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 * See base class description.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * Requests must fit in 32 bits.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * Requests must fit in 32 bits.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+		/**
+		 * Get the current position of the arena.
+		 *
+		 * @return A marker that can be passed to rewind() is returned.
+		 */
+		Marker getMarker() const;
+
+		/**
+		 * Drop all memory allocated after a marker was taken.
+		 *
+		 * Markers must be rewound in the reverse order they were taken;
+		 * a marker taken after this one becomes invalid.
+		 *
+		 * @param marker The marker returned by getMarker().
+		 */
+		void rewind(const Marker &marker);
+
+		/**
+		 * Drop all memory allocated from the arena.
+		 *
+		 * The first chunk is kept for reuse.
+		 */
+		void reset();
+
+		/**
+		 * Get the number of bytes handed out, including alignment padding.
+		 */
+		MlULong getAllocatedSize() const;
+
+		/**
+		 * Get the number of bytes held from the base memory manager.
+		 */
+		MlULong getReservedSize() const;
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleArenaMemoryManager(const MleArenaMemoryManager &);
+		MleArenaMemoryManager &operator=(const MleArenaMemoryManager &);
+
+		struct Chunk;
+
+		// Get a chunk with room for at least size bytes and make it current.
+		Chunk *addChunk(uint_t size);
+
+		// Release the chunks allocated after the given one.
+		void releaseChunks(Chunk *last);
+
+		// The chunk being carved; earlier chunks are linked from it.
+		Chunk *m_current;
+
+		// An empty chunk kept after a rewind to avoid going back to the base manager.
+		Chunk *m_spare;
+
+		// The start of the most recent allocation, for resizing in place.
+		void *m_last;
+
+		uint_t m_chunkSize;
+		MlULong m_reserved;
+};
+
+
+#endif /* __MLE_ARENAMEMORYMANAGER_H_ */
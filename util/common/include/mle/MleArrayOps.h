@@ -0,0 +1,333 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file MleArrayOps.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_ARRAYOPS_H_
+#define __MLE_ARRAYOPS_H_
+
+
+// Include standard header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/mlArray.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleArrayOps provides vectorized bulk operations on arrays of
+ * float, double and int.
+ *
+ * Each operation comes in a version for SSE2, AVX2 (with FMA) and AVX-512,
+ * and a scalar one for other processors. The best version the processor
+ * and operating system support is picked the first time an operation is
+ * used. The <b>MleInstructionSet</b> environment variable, set to
+ * "scalar", "sse2", "avx2" or "avx512", caps the choice, as does
+ * setInstructionSet().
+ *
+ * The operations accept any alignment, but they run faster on storage
+ * aligned to the vector size, such as that of an
+ * <code>MleArray<float, MleAlignedAllocator<64> ></code>.
+ *
+ * Results are the same as those of a plain loop, except that sum() and
+ * axpy() may round differently for float and double: sum() adds the
+ * elements in several interleaved runs, and axpy() rounds a*x+y once
+ * where fused multiply-add is available. Arithmetic on int wraps around.
+ * If the data holds NaNs, the results of minMax() are unspecified.
+ */
+class MleArrayOps
+{
+	public:
+
+		/**
+		 * The instruction sets the operations are written for.
+		 */
+		enum InstructionSet
+		{
+			SCALAR = 0,   /**< Plain C++. */
+			SSE2,         /**< 128 bit vectors. */
+			AVX2,         /**< 256 bit vectors, with fused multiply-add. */
+			AVX512        /**< 512 bit vectors. */
+		};
+
+		/**
+		 * Get the instruction set the operations use.
+		 */
+		static InstructionSet getInstructionSet();
+
+		/**
+		 * Get the best instruction set the processor supports.
+		 */
+		static InstructionSet getSupportedInstructionSet();
+
+		/**
+		 * Choose the instruction set the operations use, for example to
+		 * compare their speed.
+		 *
+		 * @param instructionSet The instruction set to use. It is lowered to
+		 * the best one the processor supports.
+		 *
+		 * @return The instruction set now in use is returned.
+		 */
+		static InstructionSet setInstructionSet(InstructionSet instructionSet);
+
+		/**
+		 * Get the name of an instruction set, as used by the
+		 * <b>MleInstructionSet</b> environment variable.
+		 */
+		static const char *getInstructionSetName(InstructionSet instructionSet);
+
+		/**
+		 * Set every element to a value.
+		 *
+		 * @param data The elements.
+		 * @param value The value to store.
+		 * @param count The number of elements.
+		 */
+		static void fill(float *data, float value, size_t count);
+		static void fill(double *data, double value, size_t count);
+		static void fill(int *data, int value, size_t count);
+
+		/**
+		 * Copy elements. The C library's memcpy() is already vectorized
+		 * for the processor, so this is a typed convenience for it.
+		 *
+		 * @param to The elements to copy to. They must not overlap the source.
+		 * @param from The elements to copy from.
+		 * @param count The number of elements.
+		 */
+		static void copy(float *to, const float *from, size_t count);
+		static void copy(double *to, const double *from, size_t count);
+		static void copy(int *to, const int *from, size_t count);
+
+		/**
+		 * Find the first element equal to a value.
+		 *
+		 * @param data The elements.
+		 * @param count The number of elements.
+		 * @param value The value to look for.
+		 *
+		 * @return The index of the first element equal to the value is
+		 * returned, or count if there is none.
+		 */
+		static size_t find(const float *data, size_t count, float value);
+		static size_t find(const double *data, size_t count, double value);
+		static size_t find(const int *data, size_t count, int value);
+
+		/**
+		 * Find the smallest and largest elements.
+		 *
+		 * @param data The elements.
+		 * @param count The number of elements.
+		 * @param minimum The smallest element is returned.
+		 * @param maximum The largest element is returned.
+		 *
+		 * @return <b>FALSE</b> is returned, and the results are left alone,
+		 * if there are no elements; otherwise <b>TRUE</b> is returned.
+		 */
+		static MlBoolean minMax(const float *data, size_t count, float &minimum, float &maximum);
+		static MlBoolean minMax(const double *data, size_t count, double &minimum, double &maximum);
+		static MlBoolean minMax(const int *data, size_t count, int &minimum, int &maximum);
+
+		/**
+		 * Add up the elements.
+		 *
+		 * @param data The elements.
+		 * @param count The number of elements.
+		 *
+		 * @return The sum is returned; 0 if there are no elements.
+		 */
+		static float sum(const float *data, size_t count);
+		static double sum(const double *data, size_t count);
+		static int sum(const int *data, size_t count);
+
+		/**
+		 * Multiply every element by a factor.
+		 *
+		 * @param data The elements.
+		 * @param factor The factor to multiply by.
+		 * @param count The number of elements.
+		 */
+		static void scale(float *data, float factor, size_t count);
+		static void scale(double *data, double factor, size_t count);
+		static void scale(int *data, int factor, size_t count);
+
+		/**
+		 * Add elements to the corresponding elements of another array,
+		 * to[i] += from[i].
+		 *
+		 * @param to The elements to add to.
+		 * @param from The elements to add.
+		 * @param count The number of elements.
+		 */
+		static void add(float *to, const float *from, size_t count);
+		static void add(double *to, const double *from, size_t count);
+		static void add(int *to, const int *from, size_t count);
+
+		/**
+		 * Add a multiple of one array to another, y[i] += a * x[i].
+		 *
+		 * @param y The elements to add to.
+		 * @param a The factor to multiply x by.
+		 * @param x The elements to multiply and add.
+		 * @param count The number of elements.
+		 */
+		static void axpy(float *y, float a, const float *x, size_t count);
+		static void axpy(double *y, double a, const double *x, size_t count);
+		static void axpy(int *y, int a, const int *x, size_t count);
+
+		/**
+		 * Compare two arrays element by element.
+		 *
+		 * @param a The first elements.
+		 * @param b The second elements.
+		 * @param count The number of elements.
+		 *
+		 * @return The index of the first element of a that is not equal to
+		 * the one in b is returned, or count if all are equal.
+		 */
+		static size_t compare(const float *a, const float *b, size_t count);
+		static size_t compare(const double *a, const double *b, size_t count);
+		static size_t compare(const int *a, const int *b, size_t count);
+
+		/**
+		 * Set every element of an array to a value.
+		 */
+		template <class T, class A> static void fill(MleArray<T, A> &array, T value)
+		{ fill(array + 0, value, (size_t) array.size()); }
+
+		/**
+		 * Make an array a copy of another one, reusing its storage if it
+		 * is large enough.
+		 *
+		 * @return <b>FALSE</b> is returned if memory could not be allocated.
+		 */
+		template <class T, class A, class B> static MlBoolean copy(MleArray<T, A> &to, const MleArray<T, B> &from)
+		{
+		    if (to.resize(from.size()) == NULL)
+		        return (from.size() == 0) ? TRUE : FALSE;
+		    copy(to + 0, &from[0], (size_t) from.size());
+		    return TRUE;
+		}
+
+		/**
+		 * Find the first element of an array equal to a value.
+		 *
+		 * @return The index of the element is returned, or -1 if there
+		 * is none.
+		 */
+		template <class T, class A> static int find(const MleArray<T, A> &array, T value)
+		{
+		    if (array.size() == 0)
+		        return -1;
+		    size_t index = find(&array[0], (size_t) array.size(), value);
+		    return (index < (size_t) array.size()) ? (int) index : -1;
+		}
+
+		/**
+		 * Find the smallest and largest elements of an array.
+		 *
+		 * @return <b>FALSE</b> is returned if the array is empty.
+		 */
+		template <class T, class A> static MlBoolean minMax(const MleArray<T, A> &array, T &minimum, T &maximum)
+		{
+		    if (array.size() == 0)
+		        return FALSE;
+		    return minMax(&array[0], (size_t) array.size(), minimum, maximum);
+		}
+
+		/**
+		 * Add up the elements of an array.
+		 */
+		template <class T, class A> static T sum(const MleArray<T, A> &array)
+		{
+		    if (array.size() == 0)
+		        return 0;
+		    return sum(&array[0], (size_t) array.size());
+		}
+
+		/**
+		 * Multiply every element of an array by a factor.
+		 */
+		template <class T, class A> static void scale(MleArray<T, A> &array, T factor)
+		{ scale(array + 0, factor, (size_t) array.size()); }
+
+		/**
+		 * Add the elements of one array to those of another. The arrays
+		 * should be the same size; extra elements of either are left out.
+		 */
+		template <class T, class A, class B> static void add(MleArray<T, A> &to, const MleArray<T, B> &from)
+		{
+		    int count = (to.size() < from.size()) ? to.size() : from.size();
+		    if (count > 0)
+		        add(to + 0, &from[0], (size_t) count);
+		}
+
+		/**
+		 * Add a multiple of one array to another, y[i] += a * x[i]. The
+		 * arrays should be the same size; extra elements of either are
+		 * left out.
+		 */
+		template <class T, class A, class B> static void axpy(MleArray<T, A> &y, T a, const MleArray<T, B> &x)
+		{
+		    int count = (y.size() < x.size()) ? y.size() : x.size();
+		    if (count > 0)
+		        axpy(y + 0, a, &x[0], (size_t) count);
+		}
+
+		/**
+		 * Compare two arrays element by element.
+		 *
+		 * @return -1 is returned if the arrays are equal. Otherwise the
+		 * index of the first element that differs is returned, which is the
+		 * size of the shorter array if it matches the start of the longer.
+		 */
+		template <class T, class A, class B> static int compare(const MleArray<T, A> &a, const MleArray<T, B> &b)
+		{
+		    int count = (a.size() < b.size()) ? a.size() : b.size();
+		    size_t index = (count > 0) ? compare(&a[0], &b[0], (size_t) count) : 0;
+		    if (index < (size_t) count)
+		        return (int) index;
+		    return (a.size() == b.size()) ? -1 : count;
+		}
+};
+
+
+#endif /* __MLE_ARRAYOPS_H_ */
@@ -0,0 +1,208 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file MleAtom.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_ATOM_H_
+#define __MLE_ATOM_H_
+
+
+// Include system header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/MleUtil.h"
+#include "mle/mlHashTable.h"
+
+
+/**
+ * The stored form of an interned string. Entries are created by MleAtom
+ * and never change or go away.
+ */
+struct MleAtomEntry
+{
+    size_t m_hash;        // The hash of the string.
+    uint_t m_id;          // The atom's number, from 1; 0 for the null atom.
+    uint_t m_length;      // The length of the string.
+    char m_string[1];     // The characters, and a terminating null.
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleAtom is an interned string.
+ *
+ * Every string is stored once, application wide, and equal strings get the
+ * same atom. Comparing two atoms compares a pointer rather than the
+ * characters, and an atom carries its length and a hash computed when the
+ * string was interned, so it makes a cheap key for MleHashMap. An atom is
+ * the size of a pointer and may be copied freely.
+ *
+ * Each atom also has a small number, its id, which can index an array and
+ * be turned back into the atom with fromId(). The default atom is the null
+ * atom, with id 0, which stands for the empty string.
+ *
+ * Atoms may be created and used by any number of threads. Looking up a
+ * string that is already interned takes no locks; interning a new one
+ * takes a lock. The strings live until the program exits, so atoms are
+ * meant for names drawn from a bounded set, such as class, property and
+ * binding names, rather than for arbitrary text.
+ */
+class MLE_UTIL_API MleAtom
+{
+	public:
+
+		/**
+		 * Constructor. The atom is the null atom.
+		 */
+		MleAtom()
+		  : m_entry(&s_null)
+		{}
+
+		/**
+		 * Constructor. Interns a string.
+		 *
+		 * @param string The string, which is copied. NULL and the empty
+		 * string give the null atom, as does running out of memory.
+		 */
+		explicit MleAtom(const char *string);
+
+		/**
+		 * Constructor. Interns the first characters of a string.
+		 *
+		 * @param string The characters, which need not be null terminated.
+		 * @param length The number of characters.
+		 */
+		MleAtom(const char *string, size_t length);
+
+		/**
+		 * Find the atom of a string without interning it.
+		 *
+		 * @return The atom is returned, or the null atom if the string has
+		 * not been interned.
+		 */
+		static MleAtom find(const char *string);
+
+		/**
+		 * Get the atom with an id.
+		 *
+		 * @return The atom is returned, or the null atom if there is no
+		 * atom with the id.
+		 */
+		static MleAtom fromId(uint_t id);
+
+		/**
+		 * Get the number of strings interned so far, which is also the
+		 * largest id.
+		 */
+		static uint_t getCount();
+
+		/**
+		 * Get the string, which is null terminated and stays valid until the
+		 * program exits.
+		 */
+		const char *getString() const
+		{ return m_entry->m_string; }
+
+		/**
+		 * Get the length of the string.
+		 */
+		size_t getLength() const
+		{ return m_entry->m_length; }
+
+		/**
+		 * Get the hash of the string, computed when it was interned.
+		 */
+		size_t getHash() const
+		{ return m_entry->m_hash; }
+
+		/**
+		 * Get the atom's id: 0 for the null atom, otherwise from 1 up in the
+		 * order the strings were interned.
+		 */
+		uint_t getId() const
+		{ return m_entry->m_id; }
+
+		/**
+		 * Check whether this is the null atom.
+		 */
+		bool isNull() const
+		{ return m_entry == &s_null; }
+
+		bool operator==(const MleAtom &atom) const
+		{ return m_entry == atom.m_entry; }
+
+		bool operator!=(const MleAtom &atom) const
+		{ return m_entry != atom.m_entry; }
+
+		/**
+		 * Order atoms by id, which is the order they were interned in
+		 * rather than the order of their strings.
+		 */
+		bool operator<(const MleAtom &atom) const
+		{ return m_entry->m_id < atom.m_entry->m_id; }
+
+	private:
+
+		explicit MleAtom(const MleAtomEntry *entry)
+		  : m_entry(entry)
+		{}
+
+		// Find a string's entry, adding it if asked to. Returns NULL if the
+		// string is not found or cannot be added.
+		static const MleAtomEntry *lookup(const char *string, size_t length, MlBoolean add);
+
+		const MleAtomEntry *m_entry;
+
+		// The entry of the null atom.
+		static const MleAtomEntry s_null;
+};
+
+
+/**
+ * Atoms hash to the hash computed when they were interned.
+ */
+template <> struct MleHash<MleAtom>
+{
+    size_t operator()(const MleAtom &atom) const
+    { return atom.getHash(); }
+};
+
+
+#endif /* __MLE_ATOM_H_ */
@@ -42,6 +42,12 @@
 #define __MLE_MEMORY_MANAGER_H_
 
 
+// Include system header files.
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+
 // Include Magic Lantern header files.
 #include "mle/mlTypes.h"
 #include "mle/mlMalloc.h"
@@ -92,10 +98,90 @@ class MleMemoryManager
 		/**
 		 * Get the memory manager.
 		 *
-		 * @return A pointer to the singleton manager is returned that is shared application wide.
+		 * The manager on top of the calling thread's manager stack is
+		 * returned if there is one, see pushManager(). Otherwise the
+		 * application wide singleton is returned; it is created on first
+		 * use, and concurrent first calls create it only once.
+		 *
+		 * @return A pointer to the current manager is returned.
 		 */
 		static  MleMemoryManager * getManager();
 
+		/**
+		 * Set the memory manager.
+		 *
+		 * Installs a new application wide singleton manager. This should be
+		 * done before any memory has been allocated through getManager(),
+		 * since memory must be released by the manager that allocated it.
+		 * The caller retains ownership of the previous manager. Once a
+		 * manager has been set, the default one is never created, so
+		 * installing NULL leaves the application without a manager.
+		 *
+		 * @param manager A pointer to the manager to install.
+		 *
+		 * @return A pointer to the previously installed manager is returned.
+		 * It may be NULL if no manager has been created yet.
+		 */
+		static  MleMemoryManager * setManager(MleMemoryManager *manager);
+
+		/**
+		 * Make a manager current for the calling thread.
+		 *
+		 * Until it is popped, getManager() returns this manager on the
+		 * calling thread, while other threads keep using theirs. Memory
+		 * allocated through it must be released through it, so it should
+		 * not escape the scope of the push. See MleMemoryManagerScope.
+		 *
+		 * @param manager A pointer to the manager. The caller retains ownership.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	   <li><b>MLE_S_OK</b> is returned if the manager is pushed.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the thread's stack is full.
+		 * </ul>
+		 */
+		static  MlResult pushManager(MleMemoryManager *manager);
+
+		/**
+		 * Restore the manager that was current for the calling thread
+		 * before the last pushManager().
+		 *
+		 * @return A pointer to the popped manager is returned, or NULL if
+		 * the thread's stack is empty.
+		 */
+		static  MleMemoryManager * popManager();
+
+		/**
+		 * Set the allocation failure injection limit.
+		 *
+		 * Once maxAllocations allocations and resizes have been counted
+		 * across all threads, the rest fail. The count is restarted. The
+		 * initial limit comes from the <b>MleMaxAllocation</b> environment
+		 * variable.
+		 *
+		 * @param maxAllocations The limit, or 0 for no limit.
+		 */
+		static  void setAllocationLimit(uint_t maxAllocations);
+
+		/**
+		 * Set the allocation failure injection limit for the calling thread.
+		 *
+		 * Like setAllocationLimit(), but counting only the allocations and
+		 * resizes of the calling thread, so that a test is not disturbed by
+		 * other threads.
+		 *
+		 * @param maxAllocations The limit, or 0 for no limit.
+		 */
+		static  void setThreadAllocationLimit(uint_t maxAllocations);
+
+		/**
+		 * Get the resident set size of the process.
+		 *
+		 * @return The number of bytes of physical memory the process is
+		 * using is returned, or 0 if the platform cannot tell.
+		 */
+		static  MlULong getResidentSize();
+
 		/**
 		 * Allocates a chunk of memory.
 		 * 
@@ -144,6 +230,112 @@ class MleMemoryManager
 		 */
 		virtual MlResult release(void **memory);
 
+		/**
+		 * Resizes a chunk of memory only if it can be done without moving it.
+		 *
+		 * Shrinking always succeeds; growing succeeds when the block has
+		 * enough slack, see getUsableSize(). Unlike resize(), the caller
+		 * learns whether the memory stayed put, so a container can grow
+		 * without copying whenever the allocator allows it. Managers that
+		 * keep their own heaps must override this.
+		 *
+		 * @param memory A pointer to the allocated memory.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory now holds newSize bytes.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if it would have to move.
+		 * </ul>
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 *
+		 * This is at least the size that was requested, and may be more
+		 * if the allocator rounded the request up. Managers that keep their
+		 * own heaps must override this.
+		 *
+		 * @param memory A pointer to the allocated memory.
+		 *
+		 * @return The usable size in bytes is returned, or 0 if it is not known.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory whose size may not fit in 32 bits.
+		 *
+		 * The memory is resized with resizeLarge() or resize(), and released
+		 * with release(). Requests that fit in 32 bits are passed to
+		 * allocate(); larger ones go to the platform allocator. Managers
+		 * that keep their own heaps must override this for larger requests.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory to a size that may not fit in 32 bits.
+		 *
+		 * Requests that fit in 32 bits are passed to resize(). Managers
+		 * that keep their own heaps must override this for larger requests.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+		/**
+		 * Allocates a chunk of memory on an alignment boundary.
+		 *
+		 * The memory comes from the platform allocator, whatever the
+		 * manager, and must be released with releaseAligned(). It cannot
+		 * be resized.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 * @param alignment The alignment in bytes, a power of two. Smaller
+		 * values than the size of a pointer are rounded up.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocateAligned(void **memory, MlULong size, uint_t alignment);
+
+		/**
+		 * Releases memory returned by allocateAligned().
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL if release succeeds.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult releaseAligned(void **memory);
+
 		/**
 		 * Duplicates a string.
 		 *
@@ -157,6 +349,44 @@ class MleMemoryManager
 		 * </ul>
 		 */
 		virtual MlResult dupString(const MlChar *source, MlChar **destination);
+
+	protected:
+
+		/**
+		 * Check the allocation failure injection limit.
+		 *
+		 * Each call counts as one allocation against the limits set by
+		 * setAllocationLimit() and setThreadAllocationLimit(). Managers that
+		 * satisfy requests without calling the base class allocate() or
+		 * resize() should call this so that failure injection still applies.
+		 *
+		 * @return <b>TRUE</b> is returned if the allocation may proceed.
+		 * <b>FALSE</b> is returned if it should fail.
+		 */
+		static MlBoolean allocationAllowed();
+
+		/**
+		 * Capture the return addresses on the stack of the calling thread.
+		 *
+		 * @param frames The return addresses are returned, innermost first.
+		 * @param maxFrames The capacity of frames.
+		 *
+		 * @return The number of addresses captured is returned. It is 0 on
+		 * platforms without stack capture.
+		 */
+		static uint_t platformBacktrace(void **frames, uint_t maxFrames);
+
+		/**
+		 * Look up the name of the function containing a code address.
+		 *
+		 * @param address The code address.
+		 * @param name The function name is returned, truncated to fit.
+		 * @param size The capacity of name.
+		 *
+		 * @return <b>TRUE</b> is returned if a name was found.
+		 * <b>FALSE</b> is returned otherwise.
+		 */
+		static MlBoolean platformSymbolName(void *address, char *name, uint_t size);
     
 	private:
 
@@ -167,7 +397,7 @@ class MleMemoryManager
 		//
 		// The global memory manager singleton.
 		//
-		static MleMemoryManager * g_GlobalManager;
+		static std::atomic<MleMemoryManager *> g_GlobalManager;
     
 		//
 		// Initialize/cleanup cookie containing platform specific info.
@@ -180,10 +410,29 @@ class MleMemoryManager
 		// return pointers to new memory (much like malloc and realloc)
 		// or MLE_S_OK on success.  Return NULL or MLE_E_FAIL on error.
 		//
-		static void * platformAllocate(void *cookie, uint_t size);
-		static void * platformResize(void *cookie, void *memory, uint_t newSize);
+		static void * platformAllocate(void *cookie, MlULong size);
+		static void * platformResize(void *cookie, void *memory, MlULong newSize);
 		static MlResult platformRelease(void *cookie, void *memory);
 
+		//
+		// Platform implementation of the usable size query. Returns 0 if
+		// the size is not known.
+		//
+		static MlULong platformUsableSize(void *cookie, void *memory);
+
+		//
+		// Platform implementations of aligned allocation. The alignment is
+		// a power of two no smaller than the size of a pointer.
+		//
+		static void * platformAllocateAligned(void *cookie, MlULong size, uint_t alignment);
+		static MlResult platformReleaseAligned(void *cookie, void *memory);
+
+		//
+		// Platform implementation of the resident set size query. Returns
+		// 0 if the size is not known.
+		//
+		static MlULong platformResidentSize();
+
 		//
 		// Platform specific cookie.
 		//
@@ -191,10 +440,60 @@ class MleMemoryManager
 };
 
 
+/**
+ * @ingroup MleCore
+ * @brief MleMemoryManagerScope makes a manager current for the calling
+ * thread for its lifetime.
+ *
+ * For example, a phase of work can use an arena:
+ * <pre>
+ *     MleArenaMemoryManager arena;
+ *     MleMemoryManagerScope scope(&arena);
+ * </pre>
+ */
+class MleMemoryManagerScope
+{
+	public:
+
+		/**
+		 * Constructor.
+		 *
+		 * @param manager The manager to push, see MleMemoryManager::pushManager().
+		 */
+		MleMemoryManagerScope(MleMemoryManager *manager)
+		  : m_pushed(MleMemoryManager::pushManager(manager) == MLE_S_OK)
+		{}
+
+		/**
+		 * Destructor. Pops the manager.
+		 */
+		~MleMemoryManagerScope()
+		{ if (m_pushed) MleMemoryManager::popManager(); }
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleMemoryManagerScope(const MleMemoryManagerScope &);
+		MleMemoryManagerScope &operator=(const MleMemoryManagerScope &);
+
+		bool m_pushed;
+};
+
+
 /**
  * @ingroup MleCore
  * @brief MleBlockMemoryManager is a template for block based memory manager.
  *
+ * Blocks are carved out of chunks obtained from the base memory manager on
+ * demand with allocateAligned(). Each chunk is aligned to its own size, so
+ * the chunk owning a block is found by masking the block address, and it
+ * records how many of its blocks are in use. Free blocks are kept on a
+ * lock-free list shared by all threads; the list head carries a version
+ * tag next to the block index so that a concurrent pop and push of the
+ * same block cannot corrupt it. The list links live in the chunk header
+ * rather than in the blocks, so they are never overwritten by the
+ * application. Only growing the heap takes a lock.
+ *
  * @param blockSize Provides a hint to the memory manager that memory need only be
  * allocated in chunks that are multiples of blockSize.  Manager
  * can use this hint to set up a more efficient private heap for
@@ -209,31 +508,57 @@ template <uint_t blockSize>
 		/**
 		 * Constructor.
 		 *
-		 * @param heapSize The size of initial heap for block allocations
+		 * @param heapSize The size of initial heap for block allocations.
+		 * The heap grows past this size as needed.
 		 */
 		MleBlockMemoryManager(uint_t heapSize)
 		{
-		    MleMemoryManager::allocate(m_FreeList, heapSize);
+		    m_freeHead.store(0);
+		    for (uint_t i = 0; i < CHUNK_PAGES; i++)
+			{
+			    m_chunkPages[i].store(NULL);
+			}
+		    m_chunkSet.store(NULL);
+		    m_numChunks = 0;
 
-		    // Determine how many blocks will fit in heap.
-		    int numBlocks = heapSize / blockSize;
-    
-		    // Initialize the chained pointers of free list.
-		    for (MlInt i = 0; i < numBlocks - 1 ; i++)
+		    // Carve enough chunks up front to hold heapSize bytes of blocks.
+		    uint_t numBlocks = heapSize / blockSize;
+		    std::lock_guard<std::mutex> guard(m_growLock);
+		    for (uint_t i = 0; i < numBlocks; i += BLOCKS_PER_CHUNK)
 			{
-			    m_FreeList[i].next = &m_FreeList[i + 1];
+			    if (! grow()) break;
 			}
-    
-		    // Terminate the free list.
-		    m_FreeList[numBlocks - 1].next = NULL;
 		}
 		
 		/**
 		 * Destructor.
+		 *
+		 * All chunks are returned to the base memory manager.
 		 */
 		virtual ~MleBlockMemoryManager()
 		{
-		    MleMemoryManager::release(m_FreeList);
+		    for (uint_t i = 0; i < CHUNK_PAGES; i++)
+			{
+			    Chunk **page = m_chunkPages[i].load();
+			    if (page == NULL) continue;
+			    for (uint_t j = 0; j < CHUNKS_PER_PAGE; j++)
+				{
+				    if (page[j] != NULL)
+					{
+					    void *chunk = page[j];
+					    MleMemoryManager::releaseAligned(&chunk);
+					}
+				}
+			    void *memory = page;
+			    MleMemoryManager::release(&memory);
+			}
+		    ChunkSet *set = m_chunkSet.load();
+		    if (set != NULL)
+			{
+			    releaseRetired(set);
+			    void *memory = set;
+			    MleMemoryManager::release(&memory);
+			}
 		}
 
 		/**
@@ -241,6 +566,11 @@ template <uint_t blockSize>
 		 */
 		uint_t getBlockSize() { return blockSize; }
 
+		/**
+		 * Gets the number of chunks currently backing the heap.
+		 */
+		uint_t getChunkCount() { return m_numChunks; }
+
 		/**
 		 * Allocates a chunk of memory.  See base class description.
 		 *
@@ -259,14 +589,28 @@ template <uint_t blockSize>
 		{
 	    	MLE_ASSERT(size > 0);
 
-		    if (size == 0 || m_FreeList == NULL || size > blockSize)
+		    if (size == 0 || size > blockSize || ! allocationAllowed())
 			{
 			    return MLE_E_FAIL;
 			}
-    
-            *memory = (void *) m_FreeList;
-		    m_FreeList = m_FreeList->next;
-    
+
+		    Block *block = pop();
+		    while (block == NULL)
+			{
+			    {
+				    std::lock_guard<std::mutex> guard(m_growLock);
+				    // Another thread may have grown the heap while we waited.
+				    if ((m_freeHead.load(std::memory_order_acquire) & INDEX_MASK) == 0 && ! grow())
+					{
+					    return MLE_E_FAIL;
+					}
+				}
+			    block = pop();
+			}
+
+		    chunkOf(block)->m_used.fetch_add(1, std::memory_order_relaxed);
+		    *memory = (void *) block;
+
 		    return MLE_S_OK;    
 		}
 
@@ -290,7 +634,7 @@ template <uint_t blockSize>
 		    MLE_ASSERT(memory != NULL);
 		    MLE_ASSERT(newSize > 0);
 
-		    if (memory == NULL || newSize == 0 || newSize > blockSize)
+		    if (memory == NULL || *memory == NULL || newSize == 0 || newSize > blockSize)
 			{
 			    return MLE_E_FAIL;
 			}
@@ -307,37 +651,484 @@ template <uint_t blockSize>
 		 * @return A MlResult is returned.
 		 * <ul>
 		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released.
+		 *     <li><b>MLE_E_FAIL</b> is returned if the memory does not belong to this manager.
 		 * </ul>
 		 */
 		virtual MlResult release(void **memory)
 		{
 		    MLE_ASSERT(memory != NULL);
 
-		    Block * block = (Block *) memory;
-            block->next = m_FreeList;
-		    m_FreeList = block;
+		    if (memory == NULL || *memory == NULL)
+			{
+			    return MLE_E_FAIL;
+			}
+
+		    // Only look at the chunk header once the chunk is known to be ours.
+		    Block *block = (Block *) *memory;
+		    Chunk *chunk = findChunk(block);
+		    if (chunk == NULL)
+			{
+			    return MLE_E_FAIL;
+			}
+		    size_t offset = (MlChar *) block - (MlChar *) chunk;
+		    if (offset < CHUNK_HEADER || (offset - CHUNK_HEADER) % BLOCK_STRIDE != 0 ||
+			    offset - CHUNK_HEADER >= BLOCKS_PER_CHUNK * BLOCK_STRIDE)
+			{
+			    return MLE_E_FAIL;
+			}
+
+		    uint_t index = indexOf(chunk, block);
+		    push(index, index);
+		    chunk->m_used.fetch_sub(1, std::memory_order_relaxed);
     
-		    memory = NULL;
+		    *memory = NULL;
+
+		    return MLE_S_OK;
+		}
 
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 *
+		 * Succeeds if newSize fits in blockSize.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize)
+		{
+		    if (memory == NULL || newSize == 0 || newSize > blockSize)
+			{
+			    return MLE_E_FAIL;
+			}
 		    return MLE_S_OK;
 		}
 
+		/**
+		 * Get the number of bytes that may be used in a block.
+		 *
+		 * @return blockSize is returned.
+		 */
+		virtual MlULong getUsableSize(void *memory)
+		{
+		    return (memory != NULL) ? blockSize : 0;
+		}
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * Requests must fit in blockSize.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size)
+		{
+		    if (size > blockSize)
+			{
+			    return MLE_E_FAIL;
+			}
+		    return allocate(memory, (uint_t) size);
+		}
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * Requests must fit in blockSize.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize)
+		{
+		    if (newSize > blockSize)
+			{
+			    return MLE_E_FAIL;
+			}
+		    return resize(memory, (uint_t) newSize);
+		}
+
+		/**
+		 * Returns chunks with no blocks in use to the base memory manager.
+		 *
+		 * This walks the whole free list, and must not run while other
+		 * threads are allocating from or releasing to this manager.
+		 *
+		 * @return The number of chunks released is returned.
+		 */
+		uint_t trim()
+		{
+		    std::lock_guard<std::mutex> guard(m_growLock);
+
+		    // Detach the whole free list.
+		    MlULong head = m_freeHead.load(std::memory_order_acquire);
+		    while (! m_freeHead.compare_exchange_weak(head, nextTag(head)))
+			    ;
+
+		    // Keep the blocks of chunks that are still in use.
+		    uint_t first = 0, last = 0;
+		    for (uint_t index = (uint_t) (head & INDEX_MASK); index != 0; )
+			{
+			    std::atomic<uint_t> *link = linkAt(index);
+			    uint_t next = link->load(std::memory_order_relaxed);
+			    if (chunkOf(blockAt(index))->m_used.load(std::memory_order_relaxed) != 0)
+				{
+				    link->store(first, std::memory_order_relaxed);
+				    if (last == 0) last = index;
+				    first = index;
+				}
+			    index = next;
+			}
+
+		    uint_t released = 0;
+		    for (uint_t i = 0; i < CHUNK_PAGES; i++)
+			{
+			    Chunk **page = m_chunkPages[i].load();
+			    if (page == NULL) continue;
+			    for (uint_t j = 0; j < CHUNKS_PER_PAGE; j++)
+				{
+				    Chunk *chunk = page[j];
+				    if (chunk != NULL && chunk->m_used.load() == 0)
+					{
+					    removeChunk(chunk);
+					    page[j] = NULL;
+					    void *memory = chunk;
+					    MleMemoryManager::releaseAligned(&memory);
+					    m_numChunks--;
+					    released++;
+					}
+				}
+			}
+
+		    if (first != 0)
+			{
+			    push(first, last);
+			}
+
+		    // No release can be looking at an old chunk set now.
+		    ChunkSet *set = m_chunkSet.load();
+		    if (set != NULL)
+			{
+			    releaseRetired(set);
+			}
+
+		    return released;
+		}
+
 	private:
 
 		/*
 		 * Block data structure definition.
 		 */
 		struct Block {
-		    union {
-			    Block *next;
-			    MlChar data[blockSize];
-			};
+		    MlChar m_data[blockSize];
+		};
+
+		/*
+		 * Chunk header, stored at the start of each aligned chunk and
+		 * followed by the free list link of each block.
+		 */
+		struct Chunk {
+		    uint_t m_index;                // Position in the chunk table.
+		    std::atomic<uint_t> m_used;    // Number of blocks handed out.
+		};
+
+		/*
+		 * Heap geometry. Blocks keep 16 byte alignment and chunks hold at
+		 * least 64 blocks. Each block costs its stride plus a 4 byte link.
+		 */
+		static constexpr uint_t nextChunkSize(uint_t minimum, uint_t size)
+		{
+		    return (size >= minimum) ? size : nextChunkSize(minimum, size * 2);
+		}
+
+		static const uint_t BLOCK_STRIDE = (blockSize + 15) & ~15u;
+		static const uint_t CHUNK_SIZE = nextChunkSize(128 + 64 * (BLOCK_STRIDE + 4), 64 * 1024);
+		static const uint_t BLOCKS_PER_CHUNK = (CHUNK_SIZE - 128) / (BLOCK_STRIDE + 4);
+		static const uint_t CHUNK_HEADER = (sizeof(Chunk) + BLOCKS_PER_CHUNK * 4 + 63) & ~63u;
+		static const uint_t CHUNKS_PER_PAGE = 256;
+		static const uint_t CHUNK_PAGES = 256;
+		static const MlULong INDEX_MASK = 0xffffffff;
+
+		static_assert(blockSize > 0 && blockSize <= (1u << 24), "unsupported block size");
+		static_assert(sizeof(std::atomic<uint_t>) == 4, "unsupported link size");
+
+		/*
+		 * Block indices start at 1 so that 0 can terminate the free list.
+		 */
+		Chunk *chunkAt(uint_t chunkIndex)
+		{
+		    if (chunkIndex >= CHUNKS_PER_PAGE * CHUNK_PAGES) return NULL;
+		    Chunk **page = m_chunkPages[chunkIndex / CHUNKS_PER_PAGE].load(std::memory_order_acquire);
+		    return (page == NULL) ? NULL : page[chunkIndex % CHUNKS_PER_PAGE];
+		}
+
+		Block *blockAt(uint_t index)
+		{
+		    index--;
+		    Chunk *chunk = chunkAt(index / BLOCKS_PER_CHUNK);
+		    return (Block *) ((MlChar *) chunk + CHUNK_HEADER + (index % BLOCKS_PER_CHUNK) * BLOCK_STRIDE);
+		}
+
+		std::atomic<uint_t> *linkAt(uint_t index)
+		{
+		    index--;
+		    Chunk *chunk = chunkAt(index / BLOCKS_PER_CHUNK);
+		    return linksOf(chunk) + (index % BLOCKS_PER_CHUNK);
+		}
+
+		static std::atomic<uint_t> *linksOf(Chunk *chunk)
+		{
+		    return (std::atomic<uint_t> *) (chunk + 1);
+		}
+
+		static Chunk *chunkOf(Block *block)
+		{
+		    return (Chunk *) ((size_t) block & ~((size_t) CHUNK_SIZE - 1));
+		}
+
+		/*
+		 * Open addressed set of chunk addresses, so that release() can tell
+		 * its own chunks from foreign memory without locking. Entries are
+		 * added and removed with the grow lock held; a full rebuild publishes
+		 * a new table and keeps the old one until trim() or destruction.
+		 */
+		struct ChunkSet {
+		    ChunkSet *m_retired;           // Previous table, still readable.
+		    uint_t m_mask;                 // Number of slots minus one.
+		    uint_t m_used;                 // Live entries plus removed ones.
+		    std::atomic<Chunk *> m_slots[1];
 		};
 
+		static Chunk *removedChunk()
+		{
+		    return (Chunk *) (size_t) 1;
+		}
+
+		static uint_t hashChunk(Chunk *chunk)
+		{
+		    return (uint_t) ((((MlULong) (size_t) chunk / CHUNK_SIZE) * 0x9e3779b97f4a7c15ULL) >> 32);
+		}
+
+		/*
+		 * Return the chunk holding block if it belongs to this heap, or NULL.
+		 */
+		Chunk *findChunk(Block *block)
+		{
+		    Chunk *chunk = chunkOf(block);
+		    ChunkSet *set = m_chunkSet.load(std::memory_order_acquire);
+		    if (set == NULL) return NULL;
+		    for (uint_t i = hashChunk(chunk) & set->m_mask; ; i = (i + 1) & set->m_mask)
+			{
+			    Chunk *entry = set->m_slots[i].load(std::memory_order_acquire);
+			    if (entry == chunk) return chunk;
+			    if (entry == NULL) return NULL;
+			}
+		}
+
+		/*
+		 * Add a chunk to the set, rebuilding it when it is half full.
+		 * Called with the grow lock held.
+		 */
+		MlBoolean addChunk(Chunk *chunk)
+		{
+		    ChunkSet *set = m_chunkSet.load(std::memory_order_relaxed);
+		    if (set == NULL || (set->m_used + 1) * 2 > set->m_mask + 1)
+			{
+			    uint_t capacity = 64;
+			    while (capacity < (m_numChunks + 1) * 4) capacity *= 2;
+
+			    void *memory;
+			    if (MleMemoryManager::allocate(&memory,
+				    sizeof(ChunkSet) + (capacity - 1) * sizeof(std::atomic<Chunk *>)) != MLE_S_OK)
+				{
+				    return FALSE;
+				}
+			    ChunkSet *rebuilt = (ChunkSet *) memory;
+			    rebuilt->m_retired = set;
+			    rebuilt->m_mask = capacity - 1;
+			    rebuilt->m_used = 0;
+			    for (uint_t i = 0; i < capacity; i++)
+				{
+				    new (&rebuilt->m_slots[i]) std::atomic<Chunk *>(NULL);
+				}
+			    for (uint_t i = 0; set != NULL && i <= set->m_mask; i++)
+				{
+				    Chunk *entry = set->m_slots[i].load(std::memory_order_relaxed);
+				    if (entry != NULL && entry != removedChunk())
+					{
+					    insertChunk(rebuilt, entry);
+					}
+				}
+			    m_chunkSet.store(rebuilt, std::memory_order_release);
+			    set = rebuilt;
+			}
+		    insertChunk(set, chunk);
+		    return TRUE;
+		}
+
+		static void insertChunk(ChunkSet *set, Chunk *chunk)
+		{
+		    uint_t i = hashChunk(chunk) & set->m_mask;
+		    while (set->m_slots[i].load(std::memory_order_relaxed) != NULL)
+			{
+			    i = (i + 1) & set->m_mask;
+			}
+		    set->m_slots[i].store(chunk, std::memory_order_release);
+		    set->m_used++;
+		}
+
+		/*
+		 * Remove a chunk from the set. Called with the grow lock held.
+		 */
+		void removeChunk(Chunk *chunk)
+		{
+		    ChunkSet *set = m_chunkSet.load(std::memory_order_relaxed);
+		    for (uint_t i = hashChunk(chunk) & set->m_mask; ; i = (i + 1) & set->m_mask)
+			{
+			    if (set->m_slots[i].load(std::memory_order_relaxed) == chunk)
+				{
+				    set->m_slots[i].store(removedChunk(), std::memory_order_release);
+				    return;
+				}
+			}
+		}
+
+		void releaseRetired(ChunkSet *set)
+		{
+		    ChunkSet *retired = set->m_retired;
+		    set->m_retired = NULL;
+		    while (retired != NULL)
+			{
+			    void *memory = retired;
+			    retired = retired->m_retired;
+			    MleMemoryManager::release(&memory);
+			}
+		}
+
+		static uint_t indexOf(Chunk *chunk, Block *block)
+		{
+		    uint_t slot = (uint_t) (((MlChar *) block - (MlChar *) chunk - CHUNK_HEADER) / BLOCK_STRIDE);
+		    return chunk->m_index * BLOCKS_PER_CHUNK + slot + 1;
+		}
+
+		static MlULong nextTag(MlULong head)
+		{
+		    return ((head >> 32) + 1) << 32;
+		}
+
+		/*
+		 * Pop a block off the free list, or return NULL if it is empty.
+		 */
+		Block *pop()
+		{
+		    MlULong head = m_freeHead.load(std::memory_order_acquire);
+		    for (;;)
+			{
+			    uint_t index = (uint_t) (head & INDEX_MASK);
+			    if (index == 0) return NULL;
+
+			    // The block may be handed out concurrently, in which case the
+			    // link read here is stale but the tag makes the exchange fail.
+			    uint_t next = linkAt(index)->load(std::memory_order_relaxed);
+			    if (m_freeHead.compare_exchange_weak(head, nextTag(head) | next,
+				    std::memory_order_acquire, std::memory_order_acquire))
+				{
+				    return blockAt(index);
+				}
+			}
+		}
+
+		/*
+		 * Push a chain of linked blocks, given by index, onto the free list.
+		 */
+		void push(uint_t first, uint_t last)
+		{
+		    std::atomic<uint_t> *link = linkAt(last);
+		    MlULong head = m_freeHead.load(std::memory_order_relaxed);
+		    do
+			{
+			    link->store((uint_t) (head & INDEX_MASK), std::memory_order_relaxed);
+			} while (! m_freeHead.compare_exchange_weak(head, nextTag(head) | first,
+			    std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/*
+		 * Add a chunk to the heap and put its blocks on the free list.
+		 * Called with the grow lock held.
+		 */
+		MlBoolean grow()
+		{
+		    // Find a free slot in the chunk table.
+		    uint_t chunkIndex = 0;
+		    Chunk **page = NULL;
+		    for ( ; chunkIndex < CHUNKS_PER_PAGE * CHUNK_PAGES; chunkIndex++)
+			{
+			    page = m_chunkPages[chunkIndex / CHUNKS_PER_PAGE].load();
+			    if (page == NULL || page[chunkIndex % CHUNKS_PER_PAGE] == NULL) break;
+			}
+		    if (chunkIndex == CHUNKS_PER_PAGE * CHUNK_PAGES)
+			{
+			    return FALSE;
+			}
+		    if (page == NULL)
+			{
+			    void *memory;
+			    if (MleMemoryManager::allocate(&memory, CHUNKS_PER_PAGE * sizeof(Chunk *)) != MLE_S_OK)
+				{
+				    return FALSE;
+				}
+			    page = (Chunk **) memory;
+			    memset(page, 0, CHUNKS_PER_PAGE * sizeof(Chunk *));
+			    m_chunkPages[chunkIndex / CHUNKS_PER_PAGE].store(page, std::memory_order_release);
+			}
+
+		    // Chunks are aligned to their size so that blocks can find them.
+		    void *memory;
+		    if (MleMemoryManager::allocateAligned(&memory, CHUNK_SIZE, CHUNK_SIZE) != MLE_S_OK)
+			{
+			    return FALSE;
+			}
+		    Chunk *chunk = new (memory) Chunk;
+		    chunk->m_index = chunkIndex;
+		    chunk->m_used.store(0);
+		    if (! addChunk(chunk))
+			{
+			    MleMemoryManager::releaseAligned(&memory);
+			    return FALSE;
+			}
+
+		    // Link the new blocks in address order.
+		    uint_t firstIndex = chunkIndex * BLOCKS_PER_CHUNK + 1;
+		    std::atomic<uint_t> *links = linksOf(chunk);
+		    for (uint_t i = 0; i < BLOCKS_PER_CHUNK - 1; i++)
+			{
+			    new (&links[i]) std::atomic<uint_t>(firstIndex + i + 1);
+			}
+		    new (&links[BLOCKS_PER_CHUNK - 1]) std::atomic<uint_t>(0);
+
+		    page[chunkIndex % CHUNKS_PER_PAGE] = chunk;
+		    m_numChunks++;
+
+		    push(firstIndex, firstIndex + BLOCKS_PER_CHUNK - 1);
+		    return TRUE;
+		}
+
+		/*
+		 * The free block list head: a version tag in the upper 32 bits
+		 * and the index of the first free block in the lower 32 bits.
+		 */
+		std::atomic<MlULong> m_freeHead;
+
+		/*
+		 * Two level table of chunks, indexed by chunk number.
+		 */
+		std::atomic<Chunk **> m_chunkPages[CHUNK_PAGES];
+
+		/*
+		 * Addresses of the chunks in the table, for validating releases.
+		 */
+		std::atomic<ChunkSet *> m_chunkSet;
+
+		/*
+		 * Serializes heap growth and trimming.
+		 */
+		std::mutex m_growLock;
+
 		/*
-		 * The free block list
+		 * The number of chunks backing the heap.
 		 */
-        Block *m_FreeList;
+		uint_t m_numChunks;
 };
 
 
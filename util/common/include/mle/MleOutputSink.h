@@ -0,0 +1,243 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file MleOutputSink.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_OUTPUTSINK_H_
+#define __MLE_OUTPUTSINK_H_
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/mlErrno.h"
+#include "mle/mlArray.h"
+#include "mle/MleUtil.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleOutputSink is a destination for generated text.
+ *
+ * Writers hand a sink runs of bytes; the sink decides whether to copy them
+ * to memory, gather them for a file or pass them to stdio. The data passed
+ * to write() need not outlive the call.
+ */
+class MLE_UTIL_API MleOutputSink
+{
+	public:
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~MleOutputSink();
+
+		/**
+		 * Write bytes to the sink.
+		 *
+		 * @param data The bytes to write.
+		 * @param length The number of bytes.
+		 *
+		 * @return MLE_S_OK is returned on success, otherwise MLE_E_FAIL.
+		 * Once a write fails the sink drops further writes and keeps
+		 * returning MLE_E_FAIL.
+		 */
+		virtual MlResult write(const void *data, size_t length) = 0;
+
+		/**
+		 * Write out anything the sink is holding.
+		 *
+		 * @return MLE_S_OK is returned if everything written so far has
+		 * reached its destination, otherwise MLE_E_FAIL.
+		 */
+		virtual MlResult flush();
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleBufferSink collects its output in a growable block of memory.
+ *
+ * The output is contiguous, so it can be inspected, hashed or rewritten
+ * before going anywhere else.
+ */
+class MLE_UTIL_API MleBufferSink : public MleOutputSink
+{
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		MleBufferSink();
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~MleBufferSink();
+
+		virtual MlResult write(const void *data, size_t length);
+
+		/**
+		 * Get the output written so far. The pointer is valid until the
+		 * next write or clear(), and is NULL if nothing has been written.
+		 */
+		const char *getData() const
+		{ return (m_data.size() > 0) ? &m_data[0] : NULL; }
+
+		/**
+		 * Get the number of bytes written so far.
+		 */
+		size_t getLength() const
+		{ return (size_t) m_data.size(); }
+
+		/**
+		 * Discard the output, keeping the memory for reuse.
+		 */
+		void clear();
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleBufferSink(const MleBufferSink &);
+		MleBufferSink &operator=(const MleBufferSink &);
+
+		/** The output. */
+		MleArray<char> m_data;
+
+		/** Whether a write has failed. */
+		MlBoolean m_failed;
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleFileSink writes its output to a file descriptor.
+ *
+ * Small writes are gathered in a staging buffer. A write too big to stage
+ * goes out together with the staged bytes in a single writev() call, and
+ * the rest goes out when the buffer fills or the sink is flushed. Output
+ * collected in an MleBufferSink therefore reaches the file in one system
+ * call.
+ */
+class MLE_UTIL_API MleFileSink : public MleOutputSink
+{
+	public:
+
+		/** The default size of the staging buffer. */
+		static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param fd The file descriptor to write to, which the sink does
+		 * not close.
+		 * @param bufferSize The size of the staging buffer.
+		 */
+		MleFileSink(int fd, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+		/**
+		 * Destructor. Flushes the sink.
+		 */
+		virtual ~MleFileSink();
+
+		virtual MlResult write(const void *data, size_t length);
+
+		virtual MlResult flush();
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleFileSink(const MleFileSink &);
+		MleFileSink &operator=(const MleFileSink &);
+
+		// Write the staged bytes followed by a block, if any.
+		MlResult writeOut(const void *data, size_t length);
+
+		/** The file descriptor. */
+		int m_fd;
+
+		/** The staging buffer, allocated on the first write. */
+		char *m_buffer;
+
+		/** The size of the staging buffer. */
+		size_t m_bufferSize;
+
+		/** The number of bytes staged. */
+		size_t m_staged;
+
+		/** Whether a write has failed. */
+		MlBoolean m_failed;
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleStdioSink passes its output to a stdio stream.
+ */
+class MLE_UTIL_API MleStdioSink : public MleOutputSink
+{
+	public:
+
+		/**
+		 * Constructor.
+		 *
+		 * @param fp The stream to write to, which the sink does not close.
+		 */
+		MleStdioSink(FILE *fp);
+
+		virtual MlResult write(const void *data, size_t length);
+
+		virtual MlResult flush();
+
+		/**
+		 * Get the stream.
+		 */
+		FILE *getFile() const
+		{ return m_fp; }
+
+	private:
+
+		/** The stream. */
+		FILE *m_fp;
+};
+
+
+#endif /* __MLE_OUTPUTSINK_H_ */
@@ -0,0 +1,404 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleProfilingMemoryManager.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_PROFILINGMEMORYMANAGER_H_
+#define __MLE_PROFILINGMEMORYMANAGER_H_
+
+
+// Include system header files.
+#include <stdio.h>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+// Counters shared by the threads using a manager, defined in the implementation.
+struct MleProfilingCounters;
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleAllocationStats is a snapshot of the statistics gathered by
+ * an MleProfilingMemoryManager.
+ */
+struct MleAllocationStats
+{
+	/**
+	 * The number of buckets in the size histogram. Bucket <i>i</i> counts
+	 * the requests larger than 2^(i-1) and no larger than 2^i bytes.
+	 */
+	static const uint_t HISTOGRAM_BUCKETS = 33;
+
+	/**
+	 * Statistics for a single allocation tag.
+	 */
+	struct Tag
+	{
+		const char *m_name;        /**< The tag name. */
+		MlULong m_allocations;     /**< Number of allocations. */
+		MlULong m_releases;        /**< Number of releases. */
+		MlULong m_bytesAllocated;  /**< Total bytes requested, including growth by resize. */
+		MlULong m_bytesLive;       /**< Bytes currently allocated. */
+	};
+
+	std::vector<Tag> m_tags;                 /**< Tags with any activity. */
+	MlULong m_histogram[HISTOGRAM_BUCKETS];  /**< Request sizes. */
+	MlULong m_allocations;                   /**< Number of allocations over all tags. */
+	MlULong m_releases;                      /**< Number of releases over all tags. */
+	MlULong m_bytesLive;                     /**< Bytes currently allocated over all tags. */
+	MlULong m_peakBytesLive;                 /**< High water mark of m_bytesLive. */
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleProfilingMemoryManager records allocation statistics for the
+ * memory manager it wraps.
+ *
+ * Each allocation is charged to the tag that is current on the calling
+ * thread, see MleAllocationTag. For every tag the manager counts the
+ * allocations, releases, bytes allocated and bytes live; it also keeps a
+ * histogram of request sizes and the peak number of bytes live. The counters
+ * are spread over several cache line aligned shards chosen by thread, so
+ * threads seldom contend on them. The peak is gathered in steps of
+ * PEAK_GRANULARITY bytes per shard and may lag the true peak by up to that
+ * much per shard.
+ *
+ * The manager can also sample allocations for heap profiling. When a sample
+ * interval is set, an allocation is picked on average once every interval
+ * bytes, with the distance between samples drawn from an exponential
+ * distribution so that allocations of every size are picked in proportion
+ * to their bytes. The stack of each picked allocation is captured and kept
+ * until the allocation is released, and dumpHeapProfile() reports the live
+ * samples by stack.
+ *
+ * The manager may be installed application wide with
+ * MleMemoryManager::setManager(), or by setting the <b>MleAllocationStats</b>
+ * environment variable before the first call to MleMemoryManager::getManager().
+ * If the variable is set to a file name rather than 1, the statistics are
+ * written to that file when the process exits, as JSON if the name ends in
+ * ".json" and as text otherwise. Setting <b>MleHeapProfile</b> to a file
+ * name likewise wraps the default manager and writes a heap profile to that
+ * file at exit, as folded stacks if the name ends in ".folded" and in pprof
+ * format otherwise. The sample interval is taken from
+ * <b>MleHeapProfileInterval</b>, or DEFAULT_SAMPLE_INTERVAL if it is unset.
+ */
+class MleProfilingMemoryManager : public MleMemoryManager
+{
+	public:
+
+		/**
+		 * The largest number of distinct tags. Tags beyond this are charged
+		 * to the untagged entry.
+		 */
+		static const uint_t MAX_TAGS = 64;
+
+		/**
+		 * The number of bytes a shard may drift from the live total before
+		 * it updates the peak.
+		 */
+		static const uint_t PEAK_GRANULARITY = 64 * 1024;
+
+		/**
+		 * The sample interval, in bytes, suggested for heap profiling.
+		 */
+		static const uint_t DEFAULT_SAMPLE_INTERVAL = 512 * 1024;
+
+		/**
+		 * The deepest stack recorded for a sampled allocation.
+		 */
+		static const uint_t MAX_SAMPLE_FRAMES = 32;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param target The manager that satisfies the requests. If NULL,
+		 * the platform allocator is used. The target is not owned by this
+		 * manager and must outlive it.
+		 */
+		MleProfilingMemoryManager(MleMemoryManager *target = NULL);
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~MleProfilingMemoryManager();
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocate(void **memory, uint_t size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * The memory stays charged to the tag it was allocated under.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resize(void **memory, uint_t newSize);
+
+		/**
+		 * Releases an allocated chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL if release succeeds.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released,
+		 *     or if it is NULL, in which case nothing is counted.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the memory was not allocated
+		 *     by this manager or could not be released.
+		 * </ul>
+		 */
+		virtual MlResult release(void **memory);
+
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 * See base class description.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory whose size may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory to a size that may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+		/**
+		 * Take a snapshot of the statistics.
+		 *
+		 * The shards are read without stopping other threads, so the
+		 * snapshot may be slightly inconsistent while they are allocating.
+		 *
+		 * @param stats The statistics are returned.
+		 */
+		void getStats(MleAllocationStats &stats);
+
+		/**
+		 * Write a snapshot of the statistics.
+		 *
+		 * @param file The file to write to.
+		 * @param json If <b>TRUE</b>, write a JSON object; otherwise write
+		 * a table of text.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the statistics are written.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		MlResult dumpStats(FILE *file, MlBoolean json = FALSE);
+
+		/**
+		 * Set the mean number of bytes allocated between samples.
+		 *
+		 * @param interval The sample interval in bytes, or 0 to stop
+		 * sampling. Allocations sampled earlier are still tracked.
+		 */
+		void setSampleInterval(MlULong interval);
+
+		/**
+		 * Get the mean number of bytes allocated between samples.
+		 *
+		 * @return The sample interval is returned; 0 means sampling is off.
+		 */
+		MlULong getSampleInterval();
+
+		/**
+		 * Get the number of sampled allocations that are still live.
+		 */
+		uint_t getLiveSampleCount();
+
+		/**
+		 * Write the live sampled allocations, grouped by stack.
+		 *
+		 * The pprof format is the legacy text heap profile ("heap_v2"),
+		 * which pprof scales by the sample interval itself; the mapped
+		 * libraries are appended where the platform lists them. The
+		 * folded format has one line per stack, outermost frame first,
+		 * weighted by the estimated live bytes, for use with flame graph
+		 * tools.
+		 *
+		 * @param file The file to write to.
+		 * @param folded If <b>TRUE</b>, write folded stacks; otherwise write
+		 * a pprof heap profile.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the profile is written.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		MlResult dumpHeapProfile(FILE *file, MlBoolean folded = FALSE);
+
+		/**
+		 * Get the identifier of a tag, registering it if necessary.
+		 *
+		 * Tags are shared by all profiling managers. The name is not copied
+		 * and must remain valid, so it is normally a string literal.
+		 *
+		 * @param name The tag name.
+		 *
+		 * @return The tag identifier is returned. It is 0, the untagged entry,
+		 * if no more tags can be registered.
+		 */
+		static uint_t getTagId(const char *name);
+
+		/**
+		 * Get the tag charged for allocations made by the calling thread.
+		 *
+		 * @return The tag identifier is returned.
+		 */
+		static uint_t getCurrentTag();
+
+		/**
+		 * Set the tag charged for allocations made by the calling thread.
+		 *
+		 * @param tag The tag identifier returned by getTagId().
+		 *
+		 * @return The previous tag identifier is returned.
+		 */
+		static uint_t setCurrentTag(uint_t tag);
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleProfilingMemoryManager(const MleProfilingMemoryManager &);
+		MleProfilingMemoryManager &operator=(const MleProfilingMemoryManager &);
+
+		MlResult targetAllocate(void **memory, MlULong size);
+		MlResult targetResize(void **memory, MlULong newSize);
+		MlResult targetRelease(void **memory);
+
+		// Record the stack of a sampled allocation.
+		void recordSample(void *block, MlULong size);
+
+		// The manager satisfying the requests, or NULL for the platform allocator.
+		MleMemoryManager *m_target;
+
+		// The sharded counters.
+		MleProfilingCounters *m_counters;
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleAllocationTag charges the allocations made by the calling thread
+ * to a tag for its lifetime.
+ *
+ * For example:
+ * <pre>
+ *     static uint_t tag = MleProfilingMemoryManager::getTagId("template");
+ *     MleAllocationTag scope(tag);
+ * </pre>
+ */
+class MleAllocationTag
+{
+	public:
+
+		/**
+		 * Constructor.
+		 *
+		 * @param tag The tag identifier returned by
+		 * MleProfilingMemoryManager::getTagId().
+		 */
+		MleAllocationTag(uint_t tag)
+		  : m_previous(MleProfilingMemoryManager::setCurrentTag(tag))
+		{}
+
+		/**
+		 * Constructor.
+		 *
+		 * @param name The tag name. Looking the name up takes a lock, so
+		 * code on a hot path should keep the identifier instead.
+		 */
+		MleAllocationTag(const char *name)
+		  : m_previous(MleProfilingMemoryManager::setCurrentTag(
+		        MleProfilingMemoryManager::getTagId(name)))
+		{}
+
+		/**
+		 * Destructor. Restores the previous tag.
+		 */
+		~MleAllocationTag()
+		{ MleProfilingMemoryManager::setCurrentTag(m_previous); }
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleAllocationTag(const MleAllocationTag &);
+		MleAllocationTag &operator=(const MleAllocationTag &);
+
+		uint_t m_previous;
+};
+
+
+#endif /* __MLE_PROFILINGMEMORYMANAGER_H_ */
@@ -0,0 +1,276 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleRecordingMemoryManager.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_RECORDINGMEMORYMANAGER_H_
+#define __MLE_RECORDINGMEMORYMANAGER_H_
+
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+// Recording state shared by the threads using a manager, defined in the implementation.
+struct MleRecordingState;
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleRecordingMemoryManager is a memory manager that records the
+ * requests it forwards to another manager in an allocation trace.
+ *
+ * Every allocate, resize, release and aligned request made while recording
+ * is appended to a compact binary trace, together with its size, the thread
+ * that made it and whether it failed. Failures injected with
+ * setAllocationLimit() or the <b>MleMaxAllocation</b> environment variable
+ * are recorded like any other, so a trace shows exactly which request a
+ * failure hit. Blocks are identified in the trace by small object numbers
+ * rather than by address, which lets MleAllocationReplay drive any manager
+ * from the trace and get the same sequence of requests.
+ *
+ * Recording serializes the requests on a lock; the order of the records is
+ * the order in which the requests were made.
+ *
+ * The trace starts with the 8 bytes "MLETRACE", a 4 byte little endian
+ * version and 4 reserved bytes. Each record then starts with a byte holding
+ * the operation in its low four bits, FAILED_FLAG and THREAD_FLAG. If
+ * THREAD_FLAG is set, the number of the thread making this and the following
+ * requests comes next. Then come the object number, unless the operation
+ * allocates, the size, if the operation takes one, and for ALIGNED_ALLOCATE
+ * a byte holding the base 2 logarithm of the alignment. Numbers are written
+ * as unsigned LEB128 variable length integers. An allocation takes the
+ * object number most recently given up by a release, or the next unused
+ * number if there is none; a failed request does not take or give up a
+ * number.
+ *
+ * The manager may be installed application wide with
+ * MleMemoryManager::setManager(), or by setting the <b>MleAllocationTrace</b>
+ * environment variable to a file name before the first call to
+ * MleMemoryManager::getManager(). The trace is then written to that file
+ * until the process exits.
+ */
+class MleRecordingMemoryManager : public MleMemoryManager
+{
+	public:
+
+		/**
+		 * The trace format version written by this manager.
+		 */
+		static const uint_t TRACE_VERSION = 1;
+
+		/**
+		 * The operations in a trace.
+		 */
+		enum Operation
+		{
+			ALLOCATE = 1,          /**< allocate() or allocateLarge(). */
+			RESIZE = 2,            /**< resize() or resizeLarge(). */
+			RELEASE = 3,           /**< release(). */
+			RESIZE_IN_PLACE = 4,   /**< tryResizeInPlace(). */
+			ALIGNED_ALLOCATE = 5,  /**< allocateAligned(). */
+			ALIGNED_RELEASE = 6    /**< releaseAligned(). */
+		};
+
+		/**
+		 * Record flag set if the request failed.
+		 */
+		static const uint_t FAILED_FLAG = 0x10;
+
+		/**
+		 * Record flag set if a thread number follows the operation.
+		 */
+		static const uint_t THREAD_FLAG = 0x20;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param target The manager that satisfies the requests. If NULL,
+		 * the platform allocator is used. The target is not owned by this
+		 * manager and must outlive it.
+		 */
+		MleRecordingMemoryManager(MleMemoryManager *target = NULL);
+
+		/**
+		 * Destructor.
+		 *
+		 * Recording is stopped.
+		 */
+		virtual ~MleRecordingMemoryManager();
+
+		/**
+		 * Start recording to a file.
+		 *
+		 * Only blocks allocated after this call are recorded; requests on
+		 * older blocks are forwarded without being recorded.
+		 *
+		 * @param filename The name of the trace file to create.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if recording has started.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the manager is already
+		 *     recording or the file could not be created.
+		 * </ul>
+		 */
+		MlResult startRecording(const char *filename);
+
+		/**
+		 * Stop recording and close the trace file.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the whole trace was written.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the manager was not
+		 *     recording or the file could not be written.
+		 * </ul>
+		 */
+		MlResult stopRecording();
+
+		/**
+		 * Get the number of records written since recording started.
+		 *
+		 * @return The number of records is returned.
+		 */
+		MlULong getRecordCount();
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocate(void **memory, uint_t size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resize(void **memory, uint_t newSize);
+
+		/**
+		 * Releases an allocated chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL if release succeeds.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult release(void **memory);
+
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 * See base class description.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory whose size may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory to a size that may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+		/**
+		 * Allocates a chunk of memory with the given alignment.
+		 * See base class description.
+		 */
+		virtual MlResult allocateAligned(void **memory, MlULong size, uint_t alignment);
+
+		/**
+		 * Releases a chunk of memory from allocateAligned().
+		 * See base class description.
+		 */
+		virtual MlResult releaseAligned(void **memory);
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleRecordingMemoryManager(const MleRecordingMemoryManager &);
+		MleRecordingMemoryManager &operator=(const MleRecordingMemoryManager &);
+
+		//
+		// Forward a request to the target.
+		//
+		MlResult targetAllocate(void **memory, MlULong size);
+		MlResult targetResize(void **memory, MlULong newSize);
+		MlResult targetRelease(void **memory);
+
+		//
+		// The manager satisfying the requests, or NULL for the platform.
+		//
+		MleMemoryManager *m_target;
+
+		//
+		// The trace being written.
+		//
+		MleRecordingState *m_state;
+};
+
+
+#endif /* __MLE_RECORDINGMEMORYMANAGER_H_ */
@@ -45,6 +45,14 @@
 
 // Include system header files.
 #include <stdio.h>
+#include <string>
+#include <mutex>
+
+// Include Magic Lantern header files.
+#include "mle/mlArray.h"
+#include "mle/mlHashTable.h"
+#include "mle/MleAtom.h"
+#include "mle/MleOutputSink.h"
 
 #define DUMP_CODE
 
@@ -55,6 +63,25 @@
 class MleTemplateBindings;
 class MleTemplateSection;
 class MleTemplateProcess;
+class MleThreadPool;
+
+
+/**
+ * @brief MleTemplateJob describes one section to process in a batch; see
+ * MleTemplate::process().
+ */
+struct MleTemplateJob
+{
+    /** The name of the section to process. */
+    const char *m_section;
+    /** The local bindings, or NULL. */
+    MleTemplateBindings *m_bindings;
+    /** Where the output goes. */
+    MleOutputSink *m_sink;
+    /** Set to 0 if the job succeeded, or -1 if the section was not found
+        or the output could not be written. */
+    int m_result;
+};
 
 
 /**
@@ -79,6 +106,8 @@ class MleTemplateProcess;
  * describing the macro expansions you want. There can be a "global"
  * bindings table that applies to all sections in the template, and
  * a "local" one that applies only to the section being processed.
+ * A local table may be chained to a parent table, whose bindings it
+ * inherits unless it redefines them.
  * </li>
  * <li>
  * Bundle the MleTemplate and MleTemplateBindings objects into a
@@ -135,6 +164,49 @@ class MleTemplate
      */
     virtual int read(char *filename);
 
+	/**
+	 * @brief Process a batch of sections in parallel.
+	 *
+	 * The jobs are handed out to a pool of threads, and each job's output
+	 * goes to its own sink, which is flushed when the job is done. The
+	 * template and every bindings table in use must not change while the
+	 * batch runs, and binding callbacks must be safe to call from several
+	 * threads at once. Jobs may share bindings tables, or use copies of
+	 * one table, each with bindings of its own.
+	 *
+	 * @param jobs The jobs.
+	 * @param numJobs The number of jobs.
+	 * @param pool The threads to use, or NULL for the default pool.
+	 *
+	 * @return The number of jobs that failed is returned.
+	 */
+    int process(MleTemplateJob *jobs, int numJobs, MleThreadPool *pool = NULL);
+
+	/**
+	 * @brief Compute the hash of the output a section would produce,
+	 * without producing it.
+	 *
+	 * The hash covers the section's text and the values of the bindings
+	 * its macros resolve to, and equals hashOutput() of the output itself.
+	 * Output written by callbacks cannot be known in advance, so sections
+	 * whose macros resolve to callbacks are not hashed.
+	 *
+	 * @param sectionName The name of the section.
+	 * @param bindings The local bindings, or NULL.
+	 * @param hash Set to the hash.
+	 *
+	 * @return TRUE is returned if the hash was computed. FALSE is returned
+	 * if the section does not exist or calls a callback.
+	 */
+    MlBoolean hashSection(const char *sectionName, MleTemplateBindings *bindings, MlULong *hash);
+
+	/**
+	 * @brief Compute the hash of generated output.
+	 *
+	 * The hash is a 64 bit FNV-1a hash, the same on every run and platform.
+	 */
+    static MlULong hashOutput(const char *data, size_t length);
+
 	/**
 	 * @brief Set the global bindings for the template.
 	 *
@@ -166,6 +238,8 @@ class MleTemplate
 	 */
 	void appendSection (MleTemplateSection *section);
 
+	/** The sections by name. */
+    MleHashMap<MleAtom, MleTemplateSection *> m_sections;
 	/** The head of the template section list. */
     MleTemplateSection *m_sectionHead;
 	/** The tail of the template section list. */
@@ -177,6 +251,12 @@ class MleTemplate
 /**
  * @brief MleTemplateSection stores a linked list of lines, zero terminated, 
  * each dynamically allocated.
+ *
+ * As each line is added it is also compiled into a flat list of
+ * instructions: runs of literal text, merged across lines, and references
+ * to macros with their names already interned. Processing the section
+ * executes the instructions, so a section expanded many times is parsed
+ * only once.
  */
 class MleTemplateSection
 {
@@ -191,6 +271,8 @@ class MleTemplateSection
 
     int copyOut(FILE *fd);
 
+    int copyOut(MleOutputSink *sink);
+
     void addStr(char *str);
 
     void addStrDup(char *str);
@@ -204,14 +286,53 @@ class MleTemplateSection
 	    Line *m_next;
     };
 
+    // An instruction of the compiled section. Text is kept in m_text and
+    // referred to by offset.
+    struct Op {
+        enum {TEXT, MACRO} m_type;
+
+        // The literal text or, for a macro, the text written when no
+        // binding matches.
+        int m_offset;
+        int m_length;
+
+        // The column after the text: the column itself if the text holds a
+        // newline, 0 if the text is plain and adds its length, or -1 if the
+        // text holds tabs and must be measured as it is written.
+        int m_column;
+
+        // For a macro, the name and the offset of the argument, or -1 if
+        // there is none.
+        MleAtom m_name;
+        int m_arg;
+    };
+
     char *m_name;
 
+    MleAtom m_atom;
+
     Line *m_head;
 
     Line *m_tail;
 
     MleTemplateSection *m_next;
 
+    // The compiled section.
+    MleArray<Op> m_code;
+
+    // The text the instructions refer to.
+    MleArray<char> m_text;
+
+    // Compile a line and append it to the instructions.
+    void compile(const char *line);
+
+    void appendText(const char *text, int length);
+
+    void appendMacro(const char *text, int length, const char *name, int nameLength,
+                     const char *arg, int argLength);
+
+    int addText(const char *text, int length);
+
 #ifdef DUMP_CODE
     void dump(FILE *fd, int tab=0);
 #endif
@@ -225,18 +346,42 @@ typedef void (MleTemplateBindingCallback)(MleTemplateProcess *proccess, char *ca
 
 /**
  * The MleTemplateBindings stores a set of bindings from names to values.
+ *
+ * Bindings are found by hashing their interned names. A table may have a
+ * parent, which is searched for names the table does not bind itself;
+ * a callback that processes a nested section can chain its own bindings
+ * to the ones in effect rather than copying them.
+ *
+ * Copies of a table share its bindings until one of them defines a name,
+ * so a table prepared once can be handed out to many jobs, each adding
+ * its own bindings. Tables that share bindings may be used by different
+ * threads; a single table must not be changed while it is in use.
  */
 class MleTemplateBindings
 {
+    friend class MleTemplate;
     friend class MleTemplateSection;
     friend class MleTemplateProcess;
 
   public:
 
-    MleTemplateBindings();
+    /**
+     * Constructor.
+     *
+     * @param parent The bindings to search for names not bound here, or
+     * NULL. The parent must outlive this table.
+     */
+    MleTemplateBindings(MleTemplateBindings *parent = NULL);
+
+    /**
+     * Copy constructor. The copy has the same bindings and parent.
+     */
+    MleTemplateBindings(const MleTemplateBindings &bindings);
 
     ~MleTemplateBindings();
 
+    MleTemplateBindings &operator=(const MleTemplateBindings &bindings);
+
     void defineConstant(const char *name, int value);
 
     void defineConstant(const char *name, double value);
@@ -245,6 +390,9 @@ class MleTemplateBindings
 
     void defineCallback(const char *name, MleTemplateBindingCallback *cb, void *clientdata = 0);
 
+    MleTemplateBindings *getParent()
+	{ return m_parent; }
+
 #ifdef DUMP_CODE
     void dump(FILE *fd, int tab=0);
 #endif
@@ -257,7 +405,7 @@ class MleTemplateBindings
 
     	enum {INT, DOUBLE, STR, PROC} m_type;
 
-	    char *m_pName;
+	    MleAtom m_name;
 
 	    union {
 	        int     m_ival;
@@ -271,22 +419,40 @@ class MleTemplateBindings
 		} m_value;
 
 	    Binding *m_next;
+	    Binding *m_prev;
     };
 
-    Binding *m_head;
-    Binding *m_tail;
+    // The bindings in the order they were defined, and indexed by name.
+    // Shared by copies of the table until one of them changes.
+    struct Table;
+
+    Table *m_table;
+
+    MleTemplateBindings *m_parent;
+
+    // Get the table to change, first copying it if it is shared.
+    Table *getWritableTable();
+
+    static void releaseTable(Table *table);
 
     void addBinding(Binding *binding);
 
-    void removeBinding(const char *binding);
+    void removeBinding(const MleAtom &name);
 
-    int processMacro(char *name, char *, MleTemplateProcess *process);
+    int processMacro(const MleAtom &name, char *, MleTemplateProcess *process);
+
+    const Binding *lookupBinding(const MleAtom &name) const;
+
+    int hashMacro(const MleAtom &name, MlULong *hash) const;
 };
 
 /**
  * @brief The MleTemplateProcess stores state information for the processing of a
  * template.  It exists to handle recursive calls to the process function
  * for MleTemplate.
+ *
+ * The output goes to an MleOutputSink, or to a stdio stream through an
+ * adapter when the process is constructed with a FILE pointer.
  */
 class MleTemplateProcess
 {
@@ -299,6 +465,8 @@ class MleTemplateProcess
 
     MleTemplateProcess(const char *name, MleTemplate *t, MleTemplateBindings *bindings, FILE *fd);
 
+    MleTemplateProcess(const char *name, MleTemplate *t, MleTemplateBindings *bindings, MleOutputSink *sink);
+
     ~MleTemplateProcess();
 
     int go();
@@ -306,9 +474,13 @@ class MleTemplateProcess
     MleTemplate *getTemplate()
 	{ return m_pTemplate; }
 
+    // Returns NULL if the output goes to a sink other than a stdio stream.
     FILE *getFileDescriptor()
 	{ return m_pFd; }
 
+    MleOutputSink *getSink()
+	{ return m_pSink; }
+
     void outchar(int c);
 
     void outstr(char *str);
@@ -322,6 +494,10 @@ class MleTemplateProcess
 
     FILE *m_pFd;
 
+    MleStdioSink m_fileSink;
+
+    MleOutputSink *m_pSink;
+
     MleTemplate *m_pTemplate;
 
     MleTemplateBindings *m_pBindings;
@@ -330,9 +506,107 @@ class MleTemplateProcess
 
     int m_column;
 
-    int goLine(char *lineno);
+    void outtext(const char *text, int length, int column);
+
+    int processMacro(const MleAtom &name, char *, MleTemplateBindings *bindings);
+
+    int expandMacro(const MleAtom &name, char *arg);
+};
+
+/**
+ * @brief MleTemplateManifest remembers the outputs generated from templates,
+ * so that a run can leave alone the files that would not change.
+ *
+ * The manifest records the hash of each output file's contents and is kept
+ * on disk between runs. generate() writes a file only if it is missing
+ * or its new contents hash differently, so unchanged files keep their
+ * modification times. Where it can, generate() hashes a section without
+ * expanding it; see MleTemplate::hashSection().
+ *
+ * The generate() and lookup functions may be called from several threads
+ * at once, for example from jobs run on an MleThreadPool.
+ */
+class MleTemplateManifest
+{
+  public:
+
+    /** Results of generate(). */
+    enum {
+        FAILED = -1,     /**< The output could not be generated or written. */
+        UNCHANGED = 0,   /**< The file was up to date and left alone. */
+        WRITTEN = 1      /**< The file was written. */
+    };
+
+    MleTemplateManifest();
+
+    ~MleTemplateManifest();
+
+    /**
+     * Read a manifest written by write(), replacing the entries.
+     *
+     * @param filename The name of the manifest file. A file that does not
+     * exist gives an empty manifest.
+     *
+     * @return Zero is returned on success, -1 if the file could not be read.
+     */
+    int read(const char *filename);
+
+    /**
+     * Write the manifest, if its entries have changed since it was read
+     * or last written.
+     *
+     * @return Zero is returned on success, -1 if the file could not be
+     * written.
+     */
+    int write(const char *filename);
+
+    /**
+     * Generate a file from a section of a template.
+     *
+     * @param t The template.
+     * @param sectionName The section to process.
+     * @param bindings The local bindings, or NULL.
+     * @param path The name of the file to generate. It is written under a
+     * temporary name in the same directory and renamed into place, so a
+     * failure leaves any previous file as it was.
+     *
+     * @return WRITTEN, UNCHANGED or FAILED is returned.
+     */
+    int generate(MleTemplate *t, const char *sectionName, MleTemplateBindings *bindings, const char *path);
+
+    /**
+     * Get the recorded hash of a file.
+     *
+     * @return TRUE is returned if the file has an entry.
+     */
+    MlBoolean lookup(const char *path, MlULong *hash);
+
+    /**
+     * Record the hash of a file.
+     */
+    void update(const char *path, MlULong hash);
+
+    /**
+     * Forget a file.
+     */
+    void remove(const char *path);
+
+    /**
+     * Get the number of entries.
+     */
+    int getCount();
+
+  private:
+
+    // Hide the copy constructor and assignment operator.
+    MleTemplateManifest(const MleTemplateManifest &);
+    MleTemplateManifest &operator=(const MleTemplateManifest &);
+
+    std::mutex m_lock;
+
+    MleHashMap<std::string, MlULong> m_entries;
 
-    int processMacro(char *name, char *, MleTemplateBindings *bindings);
+    MlBoolean m_changed;
 };
 
 #endif /* __MLE_TEMPLATE_H_ */
@@ -0,0 +1,193 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleThreadCacheMemoryManager.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_THREADCACHEMEMORYMANAGER_H_
+#define __MLE_THREADCACHEMEMORYMANAGER_H_
+
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+// Heap state shared by the threads using a manager, defined in the implementation.
+struct MleThreadCacheHeap;
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleThreadCacheMemoryManager is a memory manager with a per-thread
+ * cache in front of the platform allocator.
+ *
+ * Requests of up to MAX_CACHED_SIZE bytes are rounded up to one of a small
+ * set of size classes and served from free lists owned by the calling thread,
+ * so the common case takes no locks. The thread caches are refilled from, and
+ * drained back to, a central heap in batches. The central heap carves its
+ * blocks out of large spans obtained from the base memory manager; spans are
+ * kept until the manager is destroyed. Larger requests go straight to the
+ * base memory manager.
+ *
+ * The manager may be installed application wide with
+ * MleMemoryManager::setManager(), or by setting the <b>MleThreadCache</b>
+ * environment variable before the first call to MleMemoryManager::getManager().
+ */
+class MleThreadCacheMemoryManager : public MleMemoryManager
+{
+	public:
+
+		/**
+		 * The largest request, in bytes, that is served from the thread caches.
+		 */
+		static const uint_t MAX_CACHED_SIZE = 2048;
+
+		/**
+		 * Constructor.
+		 */
+		MleThreadCacheMemoryManager();
+
+		/**
+		 * Destructor.
+		 *
+		 * The spans backing the thread caches are returned to the base memory
+		 * manager. Blocks from this manager that are still in use become
+		 * invalid.
+		 */
+		virtual ~MleThreadCacheMemoryManager();
+
+		/**
+		 * Allocates a chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocate(void **memory, uint_t size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * A cached block is left in place when the new size still fits its
+		 * size class.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resize(void **memory, uint_t newSize);
+
+		/**
+		 * Releases an allocated chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL if release succeeds.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult release(void **memory);
+
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 *
+		 * A cached block can grow up to the size of its size class.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 * See base class description.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory whose size may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory to a size that may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+		/**
+		 * Return the blocks cached by the calling thread to the central heap.
+		 *
+		 * A thread's cache is flushed automatically when the thread exits.
+		 */
+		void flushThreadCache();
+
+		/**
+		 * Get the number of allocations made through this manager.
+		 *
+		 * Each thread keeps its own count; the counts are summed when this
+		 * is called, so the result is a snapshot while other threads are
+		 * still allocating.
+		 *
+		 * @return The number of successful calls to allocate() and resize()
+		 * is returned.
+		 */
+		MlULong getAllocationCount();
+
+	private:
+
+		//
+		// The heap shared by all threads using this manager.
+		//
+		MleThreadCacheHeap *m_heap;
+};
+
+
+#endif /* __MLE_THREADCACHEMEMORYMANAGER_H_ */
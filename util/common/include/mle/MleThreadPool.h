@@ -0,0 +1,148 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file MleThreadPool.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_THREADPOOL_H_
+#define __MLE_THREADPOOL_H_
+
+
+// Include system header files.
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/MleUtil.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleThreadPool runs the iterations of a loop on a fixed set of
+ * worker threads.
+ *
+ * The workers are started by the constructor and sleep until run() hands
+ * them a loop. The calling thread takes part in the loop too, and run()
+ * returns once every iteration is done, so a pool of N threads has N-1
+ * workers.
+ *
+ * A pool runs one loop at a time. When run() is called from inside a loop,
+ * or while another thread's loop is in progress, the iterations are run on
+ * the calling thread instead of waiting for the pool.
+ */
+class MLE_UTIL_API MleThreadPool
+{
+	public:
+
+		/**
+		 * Constructor.
+		 *
+		 * @param numThreads The number of threads that run a loop, counting
+		 * the caller of run(). Zero means one per processor.
+		 */
+		MleThreadPool(uint_t numThreads = 0);
+
+		/**
+		 * Destructor. Waits for the workers to finish.
+		 */
+		virtual ~MleThreadPool();
+
+		/**
+		 * Get the number of threads that run a loop, counting the caller
+		 * of run().
+		 */
+		uint_t getNumThreads() const
+		{ return (uint_t) m_workers.size() + 1; }
+
+		/**
+		 * Run the iterations of a loop in parallel.
+		 *
+		 * The iterations are handed out one at a time, in increasing order,
+		 * so each should be worth a thread's attention; give a worker a
+		 * range of elements rather than a single one. The body must not
+		 * throw.
+		 *
+		 * @param count The number of iterations.
+		 * @param body The loop body, called with the iteration number,
+		 * from 0 to count - 1.
+		 */
+		void run(int count, const std::function<void (int)> &body);
+
+		/**
+		 * Get a pool with one thread per processor, shared by the
+		 * application. It is created the first time it is asked for.
+		 */
+		static MleThreadPool *getDefault();
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleThreadPool(const MleThreadPool &);
+		MleThreadPool &operator=(const MleThreadPool &);
+
+		// The loop run by a worker thread.
+		void work();
+
+		// Run iterations until there are none left.
+		void runIterations();
+
+		std::vector<std::thread> m_workers;
+
+		// Held by the thread whose loop the workers are running.
+		std::mutex m_runLock;
+
+		// Guards the fields below, which hand a loop to the workers.
+		std::mutex m_lock;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		MlULong m_generation;
+		uint_t m_busy;
+		MlBoolean m_stop;
+
+		// The loop in progress.
+		const std::function<void (int)> *m_body;
+		int m_count;
+		std::atomic<int> m_next;
+};
+
+
+#endif /* __MLE_THREADPOOL_H_ */
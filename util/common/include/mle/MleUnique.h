@@ -0,0 +1,355 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file MleUnique.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_UNIQUE_CXX_H_
+#define __MLE_UNIQUE_CXX_H_
+
+
+// Include system header files.
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/mlMalloc.h"
+#include "mle/mlArray.h"
+#include "mle/MleThreadPool.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleUnique removes duplicate elements from arrays, keeping the
+ * first occurrence of each value in its original order.
+ *
+ * There are two strategies. The sort based one needs only an ordering of
+ * the elements; it sorts their indices with a merge sort spread over a
+ * thread pool, so its cost is O(n log n) compares divided among the
+ * threads. The hash based one needs a hash function and an equality test;
+ * it makes a single pass over the elements with an open addressing table,
+ * in O(n) on one thread. Both work in place and move each kept element at
+ * most once.
+ *
+ * The C function mlUnique() is built on the sort based strategy.
+ */
+class MleUnique
+{
+	public:
+
+		/**
+		 * Arrays with fewer elements than this are sorted on one thread.
+		 */
+		static const int PARALLEL_THRESHOLD = 16384;
+
+		/**
+		 * Remove duplicates from an array by sorting.
+		 *
+		 * @param data The elements. Those that are kept are moved to the
+		 * front; the rest are left moved from.
+		 * @param count The number of elements.
+		 * @param less A strict weak ordering of the elements, such as
+		 * std::less. Elements are duplicates when neither is less than the
+		 * other. It is called from several threads at once.
+		 * @param pool The threads to sort with. NULL means
+		 * MleThreadPool::getDefault().
+		 *
+		 * @return The number of elements kept is returned, or -1 if memory
+		 * could not be allocated, in which case the elements are unchanged.
+		 */
+		template <class T, class Less = std::less<T> >
+		static int sortBased(T *data, int count, Less less = Less(), MleThreadPool *pool = NULL);
+
+		/**
+		 * Remove duplicates from an array by sorting, and shrink it to the
+		 * elements kept.
+		 */
+		template <class T, class A, class Less = std::less<T> >
+		static int sortBased(MleArray<T, A> &array, Less less = Less(), MleThreadPool *pool = NULL)
+		{
+		    int count = sortBased(array + 0, array.size(), less, pool);
+		    if (count >= 0)
+		        array.resize(count);
+		    return count;
+		}
+
+		/**
+		 * Remove duplicates from an array with a hash table.
+		 *
+		 * @param data The elements. Those that are kept are moved to the
+		 * front; the rest are left moved from.
+		 * @param count The number of elements.
+		 * @param hash The hash function, such as std::hash.
+		 * @param equal The equality test, such as std::equal_to. It is only
+		 * called on elements with the same hash.
+		 *
+		 * @return The number of elements kept is returned, or -1 if memory
+		 * could not be allocated, in which case the elements are unchanged.
+		 */
+		template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T> >
+		static int hashBased(T *data, int count, Hash hash = Hash(), Equal equal = Equal());
+
+		/**
+		 * Remove duplicates from an array with a hash table, and shrink it
+		 * to the elements kept.
+		 */
+		template <class T, class A, class Hash = std::hash<T>, class Equal = std::equal_to<T> >
+		static int hashBased(MleArray<T, A> &array, Hash hash = Hash(), Equal equal = Equal())
+		{
+		    int count = hashBased(array + 0, array.size(), hash, equal);
+		    if (count >= 0)
+		        array.resize(count);
+		    return count;
+		}
+
+		/**
+		 * Sort the indices of a set of elements in parallel. Equal elements
+		 * keep their original order.
+		 *
+		 * @param indices Receives the indices 0 to count - 1, in the order
+		 * of the elements they refer to.
+		 * @param count The number of elements.
+		 * @param less Compares the elements at two indices, as a strict weak
+		 * ordering. It is called from several threads at once.
+		 * @param pool The threads to sort with. NULL means
+		 * MleThreadPool::getDefault().
+		 *
+		 * @return <b>FALSE</b> is returned if memory could not be allocated.
+		 */
+		template <class Less>
+		static MlBoolean sortIndices(int *indices, int count, Less less, MleThreadPool *pool = NULL);
+
+		/**
+		 * Find the first occurrence of each value in a set of elements.
+		 *
+		 * @param count The number of elements.
+		 * @param less Compares the elements at two indices, as for
+		 * sortIndices().
+		 * @param pool The threads to sort with. NULL means
+		 * MleThreadPool::getDefault().
+		 *
+		 * @return A flag per element is returned, non-zero for the first
+		 * occurrences, to be released with mlFree(). NULL is returned if
+		 * memory could not be allocated.
+		 */
+		template <class Less>
+		static MlUChar *findFirstOccurrences(int count, Less less, MleThreadPool *pool = NULL);
+
+	private:
+
+		// A slot of the hash table, with the index of a kept element.
+		struct Slot
+		{
+		    size_t hash;
+		    int index;
+		};
+
+		// The smallest number of elements sorted by one thread.
+		static const int MIN_CHUNK = 4096;
+};
+
+
+template <class Less> MlBoolean
+MleUnique::sortIndices(int *indices, int count, Less less, MleThreadPool *pool)
+{
+    if (count <= 0)
+        return TRUE;
+    if (pool == NULL)
+        pool = MleThreadPool::getDefault();
+
+    // Split the indices into a power of two of chunks, at most one per thread.
+    int numChunks = 1;
+    if (count >= PARALLEL_THRESHOLD)
+	{
+        while ((numChunks < (int) pool->getNumThreads()) && (count / (numChunks * 2) >= MIN_CHUNK))
+            numChunks *= 2;
+    }
+
+    int *scratch = NULL;
+    if (numChunks > 1)
+	{
+        scratch = (int *) mlMalloc(sizeof(int) * (size_t) count);
+        if (scratch == NULL)
+            return FALSE;
+    }
+
+    for (int i = 0; i < count; i++)
+        indices[i] = i;
+
+    auto bound = [count, numChunks](int chunk) -> int
+        { return (int) (((MlLong) count * chunk) / numChunks); };
+
+    // Sort the chunks, then merge them in pairs until one is left. Both
+    // steps are stable, and the indices start in order, so equal elements
+    // stay in the order of their indices.
+    pool->run(numChunks, [&](int chunk)
+	{
+        std::stable_sort(indices + bound(chunk), indices + bound(chunk + 1), less);
+    });
+
+    int *from = indices;
+    int *to = scratch;
+    for (int width = 1; width < numChunks; width *= 2)
+	{
+        pool->run(numChunks / (width * 2), [&](int pair)
+		{
+            int low = bound(pair * width * 2);
+            int middle = bound(pair * width * 2 + width);
+            int high = bound((pair + 1) * width * 2);
+            std::merge(from + low, from + middle, from + middle, from + high, to + low, less);
+        });
+        std::swap(from, to);
+    }
+
+    if (from != indices)
+        memcpy(indices, from, sizeof(int) * (size_t) count);
+    mlFree(scratch);
+
+    return TRUE;
+}
+
+
+template <class Less> MlUChar *
+MleUnique::findFirstOccurrences(int count, Less less, MleThreadPool *pool)
+{
+    if (count <= 0)
+        return NULL;
+    if (pool == NULL)
+        pool = MleThreadPool::getDefault();
+
+    int *indices = (int *) mlMalloc(sizeof(int) * (size_t) count);
+    MlUChar *first = (MlUChar *) mlMalloc((size_t) count);
+    if ((indices == NULL) || (first == NULL) || ! sortIndices(indices, count, less, pool))
+	{
+        mlFree(indices);
+        mlFree(first);
+        return NULL;
+    }
+
+    // Equal elements are next to each other, the first occurrence leading.
+    int numChunks = (count >= PARALLEL_THRESHOLD) ? (int) pool->getNumThreads() : 1;
+    pool->run(numChunks, [&](int chunk)
+	{
+        int low = (int) (((MlLong) count * chunk) / numChunks);
+        int high = (int) (((MlLong) count * (chunk + 1)) / numChunks);
+        for (int i = low; i < high; i++)
+            first[indices[i]] = ((i == 0) || less(indices[i - 1], indices[i])) ? 1 : 0;
+    });
+
+    mlFree(indices);
+    return first;
+}
+
+
+template <class T, class Less> int
+MleUnique::sortBased(T *data, int count, Less less, MleThreadPool *pool)
+{
+    if (count <= 1)
+        return (count > 0) ? count : 0;
+
+    auto lessIndex = [data, &less](int a, int b) -> bool
+        { return less(data[a], data[b]); };
+    MlUChar *first = findFirstOccurrences(count, lessIndex, pool);
+    if (first == NULL)
+        return -1;
+
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+	{
+        if (first[i])
+		{
+            if (kept != i)
+                data[kept] = std::move(data[i]);
+            kept++;
+        }
+    }
+
+    mlFree(first);
+    return kept;
+}
+
+
+template <class T, class Hash, class Equal> int
+MleUnique::hashBased(T *data, int count, Hash hash, Equal equal)
+{
+    if (count <= 1)
+        return (count > 0) ? count : 0;
+
+    // Keep the table at most half full.
+    int bits = 4;
+    while (((size_t) 1 << bits) < (size_t) count * 2)
+        bits++;
+    size_t mask = ((size_t) 1 << bits) - 1;
+
+    Slot *table = (Slot *) mlMalloc(sizeof(Slot) * (mask + 1));
+    if (table == NULL)
+        return -1;
+    for (size_t s = 0; s <= mask; s++)
+        table[s].index = -1;
+
+    // The kept elements are compacted as they are found, so the table
+    // refers to their new places, which later moves never touch.
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+	{
+        size_t h = hash(data[i]);
+
+        // Spread the hash over the table's bits; many hashes of integers
+        // are the identity.
+        size_t s = (size_t) (((MlULong) h * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+        while ((table[s].index >= 0) && ! ((table[s].hash == h) && equal(data[table[s].index], data[i])))
+            s = (s + 1) & mask;
+
+        if (table[s].index < 0)
+		{
+            if (kept != i)
+                data[kept] = std::move(data[i]);
+            table[s].hash = h;
+            table[s].index = kept++;
+        }
+    }
+
+    mlFree(table);
+    return kept;
+}
+
+
+#endif /* __MLE_UNIQUE_CXX_H_ */
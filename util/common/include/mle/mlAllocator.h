@@ -0,0 +1,230 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlAllocator.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_ALLOCATOR_H_
+#define __MLE_ALLOCATOR_H_
+
+
+// Include standard header files.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+#include "mle/MleMemoryManager.h"
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleMallocAllocator is the allocator policy used by the array
+ * templates unless told otherwise.
+ *
+ * An allocator policy supplies the storage for MleArray and MleSmallArray.
+ * It is a class with the members
+ * <pre>
+ *     void *allocate(size_t size);
+ *     void *reallocate(void *memory, size_t newSize);
+ *     void release(void *memory);
+ *     size_t usableSize(void *memory);
+ * </pre>
+ * where reallocate() is given only blocks from allocate(), allocate() and
+ * reallocate() return NULL on failure, leaving the
+ * original block intact, and usableSize() may return 0 if it cannot tell.
+ * A policy is copied along with the array that holds it, and a block must
+ * be released by a copy of the policy that allocated it.
+ *
+ * This policy uses mlMalloc() and friends. It has no state, so it adds
+ * nothing to the size of an array.
+ */
+class MleMallocAllocator
+{
+	public:
+
+		void *allocate(size_t size)
+		{ return mlMalloc(size); }
+
+		void *reallocate(void *memory, size_t newSize)
+		{ return mlRealloc(memory, newSize); }
+
+		void release(void *memory)
+		{ mlFree(memory); }
+
+		size_t usableSize(void *memory)
+		{ return mlMallocUsableSize(memory); }
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleAlignedAllocator is an allocator policy whose blocks are aligned
+ * to a multiple of ALIGNMENT bytes, for example for vector instructions.
+ *
+ * A block is carved out of a larger one from mlMalloc(); the distance to
+ * the start of that block is kept in the byte before the aligned block.
+ * Reallocation still goes through mlRealloc(), so a block can grow in
+ * place, and the contents are shifted if the new block is aligned
+ * differently.
+ */
+template <size_t ALIGNMENT = 64> class MleAlignedAllocator
+{
+	public:
+
+		static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "alignment must be a power of two");
+		static_assert(ALIGNMENT >= 8 && ALIGNMENT <= 128, "unsupported alignment");
+
+		void *allocate(size_t size)
+		{
+		    if (size + ALIGNMENT < size)
+		        return NULL;
+		    return align((unsigned char *) mlMalloc(size + ALIGNMENT));
+		}
+
+		void *reallocate(void *memory, size_t newSize)
+		{
+		    if (newSize + ALIGNMENT < newSize)
+		        return NULL;
+		    size_t offset = offsetOf(memory);
+		    unsigned char *base = (unsigned char *) mlRealloc((unsigned char *) memory - offset, newSize + ALIGNMENT);
+		    if (base == NULL)
+		        return NULL;
+		    unsigned char *block = alignUp(base);
+		    if (block != base + offset)
+		        memmove(block, base + offset, newSize);
+		    block[-1] = (unsigned char) (block - base);
+		    return block;
+		}
+
+		void release(void *memory)
+		{ mlFree((unsigned char *) memory - offsetOf(memory)); }
+
+		size_t usableSize(void *memory)
+		{
+		    size_t offset = offsetOf(memory);
+		    size_t usable = mlMallocUsableSize((unsigned char *) memory - offset);
+		    return (usable > offset) ? usable - offset : 0;
+		}
+
+	private:
+
+		// Find the aligned block in one from mlMalloc(), leaving at least
+		// one byte in front for the offset.
+		static unsigned char *alignUp(unsigned char *base)
+		{ return (unsigned char *) (((uintptr_t) base + ALIGNMENT) & ~((uintptr_t) ALIGNMENT - 1)); }
+
+		static void *align(unsigned char *base)
+		{
+		    if (base == NULL)
+		        return NULL;
+		    unsigned char *block = alignUp(base);
+		    block[-1] = (unsigned char) (block - base);
+		    return block;
+		}
+
+		static size_t offsetOf(void *memory)
+		{ return ((unsigned char *) memory)[-1]; }
+};
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleManagerAllocator is an allocator policy that takes its
+ * storage from a memory manager.
+ *
+ * An array using it can take its elements from an arena, a pool or an
+ * instrumented manager, and its memory is counted in that manager's
+ * statistics. For example, arrays built while loading a level can come
+ * from an arena and be dropped together with it:
+ * <pre>
+ *     MleArenaMemoryManager arena;
+ *     MleArray<Actor *, MleManagerAllocator> actors(MleManagerAllocator(&arena));
+ * </pre>
+ * The manager is not owned by the policy and must outlive the arrays bound
+ * to it.
+ */
+class MleManagerAllocator
+{
+	public:
+
+		/**
+		 * Constructor.
+		 *
+		 * @param manager The manager to allocate from. If NULL, the manager
+		 * returned by MleMemoryManager::getManager() when the policy is
+		 * constructed is used.
+		 */
+		MleManagerAllocator(MleMemoryManager *manager = NULL)
+		  : m_manager((manager != NULL) ? manager : MleMemoryManager::getManager())
+		{}
+
+		void *allocate(size_t size)
+		{
+		    void *memory;
+		    if (m_manager->allocateLarge(&memory, size) != MLE_S_OK)
+		        return NULL;
+		    return memory;
+		}
+
+		void *reallocate(void *memory, size_t newSize)
+		{
+		    if (m_manager->resizeLarge(&memory, newSize) != MLE_S_OK)
+		        return NULL;
+		    return memory;
+		}
+
+		void release(void *memory)
+		{ m_manager->release(&memory); }
+
+		size_t usableSize(void *memory)
+		{ return (size_t) m_manager->getUsableSize(memory); }
+
+		/**
+		 * Get the manager the policy allocates from.
+		 */
+		MleMemoryManager *getManager() const
+		{ return m_manager; }
+
+	private:
+
+		MleMemoryManager *m_manager;
+};
+
+
+#endif /* __MLE_ALLOCATOR_H_ */
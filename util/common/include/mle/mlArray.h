@@ -51,17 +51,36 @@
 #include <new.h>
 #include <memory.h>
 #endif /* _WINDOWS */
+#include <limits.h>
+#include <string.h>
 #include <ostream>
+#include <type_traits>
+#include <utility>
 
 // Include Magic Lantern header files.
 #include <mle/mlMalloc.h>
+#include <mle/mlAllocator.h>
 
 //using namespace std;
 
 /**
  * @brief MleArray is a template for managing an array of objects.
+ *
+ * The elements are kept in a block from the allocator policy A that has room for
+ * capacity() elements, of which the first size() are constructed. When the
+ * array outgrows its block, the capacity is at least doubled, so building
+ * an array element by element takes amortized constant time per element.
+ *
+ * Elements of trivially copyable types are relocated with the policy's
+ * reallocate(), which can grow the block in place. Other elements are move constructed
+ * into a new block (copied if their move constructor may throw) and the old
+ * ones destroyed.
+ *
+ * The default policy, MleMallocAllocator, takes the blocks from mlMalloc().
+ * MleManagerAllocator binds the array to a memory manager instead; see
+ * mlAllocator.h for what a policy has to provide.
  */
-template <class T> class MleArray
+template <class T, class A = MleMallocAllocator> class MleArray : private A
 {
 
   // Declare member variables.
@@ -70,6 +89,8 @@ template <class T> class MleArray
     
 	// The number of elements in the array.
     int m_numElements;
+	// The number of elements there is room for.
+    int m_capacity;
     // The array of elements.
     T * m_data;
     
@@ -86,6 +107,23 @@ template <class T> class MleArray
     MleArray()
     {
         m_numElements = 0;
+        m_capacity = 0;
+        m_data = NULL;
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the allocator policy.
+	 *
+	 * The array is initialized to be empty.
+	 *
+	 * @param allocator The policy the array takes its storage from.
+     */
+    explicit MleArray(const A& allocator)
+      : A(allocator)
+    {
+        m_numElements = 0;
+        m_capacity = 0;
         m_data = NULL;
     }
     
@@ -94,12 +132,17 @@ template <class T> class MleArray
 	 * @brief A constructor that is used to specify the initial number of elements
 	 * in the array.
 	 *
-	 * @param num The number of elements to reserve for in the array.
+	 * @param num The number of default constructed elements to place in
+	 * the array.
+	 * @param allocator The policy the array takes its storage from.
 	 */
-    MleArray(int num)
+    MleArray(int num, const A& allocator = A())
+      : A(allocator)
     {
-        m_numElements = num;
-        m_data = new T[num];
+        m_numElements = 0;
+        m_capacity = 0;
+        m_data = NULL;
+        resize(num);
     }
 
     
@@ -108,11 +151,16 @@ template <class T> class MleArray
 	 * of the array.
 	 *
 	 * @param num The number of elements in the array.
-	 * @param ptr A pointer to the elements to place in the array.
+	 * @param ptr A pointer to the elements to place in the array. The
+	 * block must come from the allocator policy and is owned by the array
+	 * from now on.
+	 * @param allocator The policy the block came from.
 	 */
-    MleArray(int num, T * ptr)
+    MleArray(int num, T * ptr, const A& allocator = A())
+      : A(allocator)
     {
         m_numElements = num;
+        m_capacity = num;
         m_data = ptr;
     }
     
@@ -120,29 +168,36 @@ template <class T> class MleArray
 	/**
 	 * @brief The copy constructor.
 	 *
+	 * The copy uses the same allocator policy as the original.
+	 *
 	 * @param a A reference to another array of elements from which to
 	 * copy.
 	 */
-#if 0
-    MleArray(MleArray& a)
+    MleArray(const MleArray& a)
+      : A(a)
     {
-        m_numElements = a.m_numElements;
-        m_data = new T[m_numElements];
-        memcpy ( m_data, a.m_data, m_numElements * sizeof(T) );
+        m_numElements = 0;
+        m_capacity = 0;
+        m_data = NULL;
+        copyFrom(a);
     }
-#endif
+
 
 	/**
-	 * @brief The copy constructor.
+	 * @brief The move constructor.
 	 *
-	 * @param a A reference to another array of elements from which to
-	 * copy.
+	 * @param a A reference to another array whose elements are taken
+	 * over. It is left empty.
 	 */
-    MleArray(const MleArray& a)
+    MleArray(MleArray&& a) noexcept
+      : A(a)
     {
         m_numElements = a.m_numElements;
-        m_data = new T[m_numElements];
-        memcpy ( m_data, a.m_data, m_numElements * sizeof(T) );
+        m_capacity = a.m_capacity;
+        m_data = a.m_data;
+        a.m_numElements = 0;
+        a.m_capacity = 0;
+        a.m_data = NULL;
     }
 
 
@@ -151,23 +206,86 @@ template <class T> class MleArray
 	 */
     ~MleArray()
     {
-    	if (m_data != NULL) delete m_data;
+        destroy(0, m_numElements);
+        if (m_data != NULL) this->release(m_data);
+    }
+
+
+	/**
+	 * @brief The copy assignment operator.
+	 *
+	 * The array keeps its own allocator policy.
+	 *
+	 * @param a A reference to another array of elements from which to
+	 * copy.
+	 *
+	 * @return A reference to this array is returned.
+	 */
+    MleArray& operator= (const MleArray& a)
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            m_numElements = 0;
+            copyFrom(a);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief The move assignment operator.
+	 *
+	 * The array takes over the allocator policy along with the elements.
+	 *
+	 * @param a A reference to another array whose elements are taken
+	 * over. It is left empty.
+	 *
+	 * @return A reference to this array is returned.
+	 */
+    MleArray& operator= (MleArray&& a) noexcept
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            if (m_data != NULL) this->release(m_data);
+            A::operator=(a);
+            m_numElements = a.m_numElements;
+            m_capacity = a.m_capacity;
+            m_data = a.m_data;
+            a.m_numElements = 0;
+            a.m_capacity = 0;
+            a.m_data = NULL;
+        }
+        return *this;
     }
 
 	
 	/**
 	 * @brief Index operator.
 	 *
+	 * Indexing past the end grows the array to include the element.
+	 *
 	 * @return The element located at the specifed location in the
 	 * array is returned.
 	 */
     T& operator[] (int i)
     {
-        if (i > size()) {
+        if (i >= size()) {
             resize( i+1 );
         }
         return ( ((T *)m_data)[i] );
     }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * @return The element located at the specifed location in the
+	 * array is returned.
+	 */
+    const T& operator[] (int i) const
+    {
+        return ( ((const T *)m_data)[i] );
+    }
     
 
 	/**
@@ -187,7 +305,7 @@ template <class T> class MleArray
      *
      * @return The contents of the array are redirected to the output stream.
      */
-    friend std::ostream& operator<< (std::ostream& os, const MleArray<T>& a)
+    friend std::ostream& operator<< (std::ostream& os, const MleArray<T, A>& a)
     {
         a.print(os);
         return os;
@@ -205,28 +323,146 @@ template <class T> class MleArray
     }
 
 
+	/**
+	 * @brief Get the capacity of the array.
+	 *
+	 * @return The number of elements the array can hold before it has
+	 * to grow its storage is returned.
+	 */
+    int capacity() const
+    {
+        return(m_capacity);
+    }
+
+
+	/**
+	 * @brief Get the allocator policy.
+	 *
+	 * @return The policy the array takes its storage from is returned.
+	 */
+    const A& getAllocator() const
+    {
+        return *this;
+    }
+
+
 	/**
 	 * @brief Resize the array.
 	 *
+	 * New elements are default constructed; elements beyond the new size
+	 * are destroyed.
+	 *
 	 * @param num The new size of the array.
 	 *
-	 * @return A pointer to the resized array is returned.
+	 * @return A pointer to the resized array is returned. NULL is returned
+	 * if the array is empty or memory could not be allocated, in which case
+	 * the array is left as it was.
 	 */
     T* resize(const int num)
     {
-        int oldSize = size();
+        if (num < m_numElements) {
+            destroy((num > 0) ? num : 0, m_numElements);
+            m_numElements = (num > 0) ? num : 0;
+        } else if (num > m_numElements) {
+            if ((num > m_capacity) && ! grow(num)) {
+                return NULL;
+            }
+
+            // Run constructor on data[oldSize...num-1].
+            for (int i = m_numElements; i < num; i++) {
+                new (&m_data[i]) T;
+            }
+            m_numElements = num;
+        }
 
-        // Make the data larger, without calling constructor.
-        m_data = (T *) mlRealloc( m_data, num * sizeof(T) );
-        m_numElements = (NULL == m_data) ? 0 : num;
-        if (0 == m_numElements) {
+        return (0 == m_numElements) ? NULL : m_data;
+    }
+
+
+	/**
+	 * @brief Make room for a number of elements.
+	 *
+	 * The size of the array does not change.
+	 *
+	 * @param num The number of elements to make room for.
+	 *
+	 * @return A pointer to the storage is returned. NULL is returned if
+	 * there is none or memory could not be allocated.
+	 */
+    T* reserve(const int num)
+    {
+        if ((num > m_capacity) && ! relocate(num)) {
             return NULL;
         }
+        return m_data;
+    }
+
+
+	/**
+	 * @brief Release the storage not used by the elements.
+	 */
+    void shrink_to_fit()
+    {
+        if (m_capacity > m_numElements) {
+            if (0 == m_numElements) {
+                this->release(m_data);
+                m_data = NULL;
+                m_capacity = 0;
+            } else {
+                relocate(m_numElements);
+            }
+        }
+    }
+
+
+	/**
+	 * @brief Append a copy of an element to the array.
+	 *
+	 * @param element The element to copy.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    T* push_back(const T& element)
+    {
+        return emplace_back(element);
+    }
+
+
+	/**
+	 * @brief Append an element to the array, moving it in.
+	 *
+	 * @param element The element to move.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    T* push_back(T&& element)
+    {
+        return emplace_back(std::move(element));
+    }
 
-        // Run constructor on data[oldSize...num-1].
-        new (&m_data[oldSize]) T[m_numElements-oldSize];
 
-        return(m_data);
+	/**
+	 * @brief Construct an element in place at the end of the array.
+	 *
+	 * @param args The arguments to pass to the constructor of the element.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    template <class... Args> T* emplace_back(Args&&... args)
+    {
+        if (m_numElements == m_capacity) {
+            // The arguments may refer to an element of this array, so the
+            // new element is built before the old storage goes away.
+            T element(std::forward<Args>(args)...);
+            if (! grow(m_numElements + 1)) {
+                return NULL;
+            }
+            return new (&m_data[m_numElements++]) T(std::move(element));
+        }
+        return new (&m_data[m_numElements++]) T(std::forward<Args>(args)...);
     }
 
     /**
@@ -242,6 +478,85 @@ template <class T> class MleArray
             os << " ";
         }
     }
+
+  private:
+
+	// Grow the storage geometrically to hold at least num elements.
+    bool grow(int num)
+    {
+        // Doubling is checked first; signed overflow is undefined.
+        int newCapacity = (m_capacity < 4) ? 4 : (m_capacity > INT_MAX / 2) ? INT_MAX : m_capacity * 2;
+        if (newCapacity < num) {
+            newCapacity = num;
+        }
+        return relocate(newCapacity);
+    }
+
+	// Move the elements to storage for exactly num elements, or more if
+	// the allocator hands back a larger block.
+    bool relocate(int num)
+    {
+        size_t bytes = (size_t) num * sizeof(T);
+        if ((num < 0) || (bytes / sizeof(T) != (size_t) num)) {
+            return false;
+        }
+
+        T *newData;
+        if (std::is_trivially_copyable<T>::value && (m_data != NULL)) {
+            // The block only moves if the allocator has no slack left to
+            // grow into.
+            newData = (T *) this->reallocate( m_data, bytes );
+            if (NULL == newData) {
+                return false;
+            }
+        } else {
+            newData = (T *) this->allocate( bytes );
+            if (NULL == newData) {
+                return false;
+            }
+            for (int i = 0; i < m_numElements; i++) {
+                new (&newData[i]) T(std::move_if_noexcept(m_data[i]));
+                m_data[i].~T();
+            }
+            if (m_data != NULL) this->release(m_data);
+        }
+
+        m_data = newData;
+        m_capacity = num;
+        size_t usable = this->usableSize( m_data ) / sizeof(T);
+        if (usable > (size_t) num) {
+            m_capacity = (usable > 0x7fffffff) ? 0x7fffffff : (int) usable;
+        }
+        return true;
+    }
+
+	// Run the destructor on data[first...last-1].
+    void destroy(int first, int last)
+    {
+        if (! std::is_trivially_destructible<T>::value) {
+            for (int i = first; i < last; i++) {
+                m_data[i].~T();
+            }
+        }
+    }
+
+	// Copy the elements of another array into this empty one.
+    void copyFrom(const MleArray& a)
+    {
+        if ((a.m_numElements > m_capacity) && ! relocate(a.m_numElements)) {
+            return;
+        }
+        if (std::is_trivially_copyable<T>::value) {
+            if (a.m_numElements > 0) {
+                memcpy ( (void *) m_data, (const void *) a.m_data, a.m_numElements * sizeof(T) );
+            }
+        } else {
+            for (int i = 0; i < a.m_numElements; i++) {
+                new (&m_data[i]) T(a.m_data[i]);
+            }
+        }
+        m_numElements = a.m_numElements;
+    }
 };
 
 #endif /* __MLE_ARRAY_H_ */
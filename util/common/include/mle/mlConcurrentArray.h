@@ -0,0 +1,456 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlConcurrentArray.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_CONCURRENTARRAY_H_
+#define __MLE_CONCURRENTARRAY_H_
+
+
+// Include standard header files.
+#include <new>
+#include <cstddef>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+
+// Include Magic Lantern header files.
+#include <mle/mlAllocator.h>
+
+
+/**
+ * @brief MleConcurrentArray is a template for an array that many threads
+ * can append to and read at the same time.
+ *
+ * The elements live in segments whose sizes are powers of two: the first
+ * holds FIRST_SEGMENT_SIZE elements and each one after that twice as many
+ * as the one before. Growing adds a segment and never moves an element,
+ * so a pointer to an element stays valid for the life of the array.
+ *
+ * push_back() claims an index by incrementing an atomic counter and never
+ * waits for another thread. A thread that needs a segment nobody has
+ * allocated yet allocates it; if several do so at once, the first to
+ * install its block wins and the others release theirs. reserve()
+ * allocates the segments up front so that appending does not allocate
+ * at all.
+ *
+ * An element becomes visible to readers once it is fully constructed.
+ * Since threads finish their appends in any order, size() counts the
+ * indices claimed so far, and get() returns NULL for an index whose
+ * element is not yet visible.
+ *
+ * The allocator policy must be safe to call from several threads.
+ * Elements cannot be removed except by clear(), which must not run
+ * alongside any other call.
+ */
+template <class T, class A = MleMallocAllocator> class MleConcurrentArray : private A
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MleConcurrentArray does not support over-aligned elements");
+
+  public:
+
+    /**
+     * The number of elements in the first segment.
+     */
+    static const int FIRST_SEGMENT_SIZE = 32;
+
+    /**
+     * The number of segments, which doubles from one to the next.
+     */
+    static const int MAX_SEGMENTS = 26;
+
+    /**
+     * The largest number of elements the array can hold, a little under
+     * 2^31.
+     */
+    static const int MAX_SIZE = FIRST_SEGMENT_SIZE * ((1 << MAX_SEGMENTS) - 1);
+
+
+  // Declare member variables.
+
+  private:
+
+	// The number of indices claimed, which can run past MAX_SIZE.
+    std::atomic<unsigned int> m_claimed;
+	// The segments. Each starts with a flag per element, set once the
+	// element is constructed, followed by the elements.
+    std::atomic<unsigned char *> m_segments[MAX_SEGMENTS];
+
+
+  // Declare member functions.
+
+  public:
+
+	/**
+	 * @brief Default constructor.
+	 *
+	 * The array is initialized to be empty.
+     */
+    MleConcurrentArray()
+    {
+        init();
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the allocator policy.
+	 *
+	 * @param allocator The policy the array takes its storage from.
+     */
+    explicit MleConcurrentArray(const A& allocator)
+      : A(allocator)
+    {
+        init();
+    }
+
+
+	/**
+	 * @brief Destructor.
+	 */
+    ~MleConcurrentArray()
+    {
+        clear();
+    }
+
+
+	/**
+	 * @brief Append a copy of an element to the array.
+	 *
+	 * @param element The element to copy.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated or the array is full.
+	 */
+    T* push_back(const T& element)
+    {
+        return emplace_back(element);
+    }
+
+
+	/**
+	 * @brief Append an element to the array, moving it in.
+	 */
+    T* push_back(T&& element)
+    {
+        return emplace_back(std::move(element));
+    }
+
+
+	/**
+	 * @brief Construct an element in place at the end of the array.
+	 *
+	 * @param args The arguments to pass to the constructor of the element.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated or the array is full. The index claimed for
+	 * the element is then left empty.
+	 */
+    template <class... Args> T* emplace_back(Args&&... args)
+    {
+        unsigned int index = m_claimed.fetch_add(1, std::memory_order_relaxed);
+        if (index >= (unsigned int) MAX_SIZE) {
+            return NULL;
+        }
+
+        int segment, offset;
+        locate((int) index, segment, offset);
+        unsigned char *block = getSegment(segment);
+        if (block == NULL) {
+            return NULL;
+        }
+
+        T *element = new (elementsOf(block, segment) + offset) T(std::forward<Args>(args)...);
+        flagsOf(block)[offset].store(1, std::memory_order_release);
+        return element;
+    }
+
+
+	/**
+	 * @brief Get an element.
+	 *
+	 * @param i The index of the element.
+	 *
+	 * @return A pointer to the element is returned, or NULL if no element
+	 * has been stored at that index yet.
+	 */
+    T* get(int i)
+    {
+        return const_cast<T *>(static_cast<const MleConcurrentArray *>(this)->get(i));
+    }
+
+    const T* get(int i) const
+    {
+        if ((i < 0) || (i >= size())) {
+            return NULL;
+        }
+
+        int segment, offset;
+        locate(i, segment, offset);
+        unsigned char *block = m_segments[segment].load(std::memory_order_acquire);
+        if ((block == NULL) || (flagsOf(block)[offset].load(std::memory_order_acquire) == 0)) {
+            return NULL;
+        }
+        return elementsOf(block, segment) + offset;
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * The element must be known to exist, for example because the threads
+	 * appending to the array have been joined; use get() otherwise.
+	 *
+	 * @return The element located at the specified index is returned.
+	 */
+    T& operator[] (int i)
+    {
+        int segment, offset;
+        locate(i, segment, offset);
+        return elementsOf(m_segments[segment].load(std::memory_order_acquire), segment)[offset];
+    }
+
+    const T& operator[] (int i) const
+    {
+        int segment, offset;
+        locate(i, segment, offset);
+        return elementsOf(m_segments[segment].load(std::memory_order_acquire), segment)[offset];
+    }
+
+
+	/**
+	 * @brief Get the size of the array.
+	 *
+	 * @return The number of indices claimed by push_back() so far is
+	 * returned. Elements still being appended are included.
+	 */
+    int size() const
+    {
+        unsigned int claimed = m_claimed.load(std::memory_order_acquire);
+        return (claimed < (unsigned int) MAX_SIZE) ? (int) claimed : MAX_SIZE;
+    }
+
+
+	/**
+	 * @brief Get the allocator policy.
+	 */
+    const A& getAllocator() const
+    {
+        return *this;
+    }
+
+
+	/**
+	 * @brief Allocate the segments needed for a number of elements.
+	 *
+	 * It may be called at the same time as push_back().
+	 *
+	 * @param num The number of elements to make room for.
+	 *
+	 * @return false is returned if memory could not be allocated.
+	 */
+    bool reserve(int num)
+    {
+        if (num <= 0) {
+            return true;
+        }
+        if (num > MAX_SIZE) {
+            return false;
+        }
+        int last, offset;
+        locate(num - 1, last, offset);
+        for (int segment = 0; segment <= last; segment++) {
+            if (getSegment(segment) == NULL) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+	/**
+	 * @brief Call a function for each element that is visible, in index
+	 * order.
+	 *
+	 * @param f The function, called with a reference to each element.
+	 */
+    template <class F> void forEach(F f)
+    {
+        forEachVisible<T>(this, f);
+    }
+
+    template <class F> void forEach(F f) const
+    {
+        forEachVisible<const T>(this, f);
+    }
+
+
+	/**
+	 * @brief Destroy the elements and release the segments.
+	 *
+	 * This must not be called at the same time as any other method.
+	 */
+    void clear()
+    {
+        int count = size();
+        for (int segment = 0; segment < MAX_SEGMENTS; segment++) {
+            unsigned char *block = m_segments[segment].load(std::memory_order_acquire);
+            if (block == NULL) {
+                continue;
+            }
+            if (! std::is_trivially_destructible<T>::value) {
+                int first = FIRST_SEGMENT_SIZE * ((1 << segment) - 1);
+                int length = segmentSize(segment);
+                for (int i = 0; (i < length) && (first + i < count); i++) {
+                    if (flagsOf(block)[i].load(std::memory_order_relaxed) != 0) {
+                        elementsOf(block, segment)[i].~T();
+                    }
+                }
+            }
+            this->release(block);
+            m_segments[segment].store(NULL, std::memory_order_relaxed);
+        }
+        m_claimed.store(0, std::memory_order_release);
+    }
+
+  private:
+
+    // Hide the copy constructor and assignment operator.
+    MleConcurrentArray(const MleConcurrentArray &);
+    MleConcurrentArray &operator=(const MleConcurrentArray &);
+
+    void init()
+    {
+        m_claimed.store(0, std::memory_order_relaxed);
+        for (int segment = 0; segment < MAX_SEGMENTS; segment++) {
+            m_segments[segment].store(NULL, std::memory_order_relaxed);
+        }
+    }
+
+    static int segmentSize(int segment)
+    {
+        return FIRST_SEGMENT_SIZE << segment;
+    }
+
+	// Find the segment holding element i and the offset of the element
+	// within it. Segment k starts at element FIRST_SEGMENT_SIZE * (2^k - 1).
+    static void locate(int i, int &segment, int &offset)
+    {
+        unsigned int j = (unsigned int) i / FIRST_SEGMENT_SIZE + 1;
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanReverse(&bit, j);
+        segment = (int) bit;
+#else
+        segment = 31 - __builtin_clz(j);
+#endif /* _MSC_VER */
+        offset = i - FIRST_SEGMENT_SIZE * ((1 << segment) - 1);
+    }
+
+    static std::atomic<unsigned char> *flagsOf(unsigned char *block)
+    {
+        return (std::atomic<unsigned char> *) block;
+    }
+
+	// The elements follow the flags, which take a power of two bytes of
+	// at least FIRST_SEGMENT_SIZE, enough to align any element.
+    static T *elementsOf(unsigned char *block, int segment)
+    {
+        size_t flags = (segmentSize(segment) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        return (T *) (block + flags);
+    }
+
+	// Get a segment, allocating it if no other thread has.
+    unsigned char *getSegment(int segment)
+    {
+        unsigned char *block = m_segments[segment].load(std::memory_order_acquire);
+        if (block != NULL) {
+            return block;
+        }
+
+        size_t length = (size_t) segmentSize(segment);
+        size_t flags = (length + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (length > ((size_t) -1 - flags) / sizeof(T)) {
+            return NULL;
+        }
+        unsigned char *newBlock = (unsigned char *) this->allocate( flags + length * sizeof(T) );
+        if (newBlock == NULL) {
+            return NULL;
+        }
+        for (size_t i = 0; i < length; i++) {
+            new (&flagsOf(newBlock)[i]) std::atomic<unsigned char>(0);
+        }
+
+        if (m_segments[segment].compare_exchange_strong(block, newBlock, std::memory_order_acq_rel,
+                                                        std::memory_order_acquire)) {
+            return newBlock;
+        }
+
+        // Another thread installed the segment first.
+        this->release(newBlock);
+        return block;
+    }
+
+    template <class E, class Array, class F> static void forEachVisible(Array *array, F &f)
+    {
+        int count = array->size();
+        for (int segment = 0; segment < MAX_SEGMENTS; segment++) {
+            int first = FIRST_SEGMENT_SIZE * ((1 << segment) - 1);
+            if (first >= count) {
+                break;
+            }
+            unsigned char *block = array->m_segments[segment].load(std::memory_order_acquire);
+            if (block == NULL) {
+                continue;
+            }
+            int length = segmentSize(segment);
+            for (int i = 0; (i < length) && (first + i < count); i++) {
+                if (flagsOf(block)[i].load(std::memory_order_acquire) != 0) {
+                    E &element = elementsOf(block, segment)[i];
+                    f(element);
+                }
+            }
+        }
+    }
+};
+
+
+#endif /* __MLE_CONCURRENTARRAY_H_ */
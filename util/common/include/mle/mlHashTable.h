@@ -0,0 +1,979 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlHashTable.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_HASHTABLE_H_
+#define __MLE_HASHTABLE_H_
+
+
+// Include standard header files.
+#if defined(__linux__) || defined(__APPLE__)
+#include <new>
+#endif /* __linux__ */
+#ifdef _WINDOWS
+#include <new.h>
+#include <memory.h>
+#endif /* _WINDOWS */
+#include <cstddef>
+#include <string.h>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MLE_HASH_SSE2
+#include <emmintrin.h>
+#endif /* SSE2 */
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+#include <mle/mlAllocator.h>
+
+
+/**
+ * @brief Hash a run of bytes.
+ *
+ * The result depends only on the bytes, so it is the same on every run of
+ * a program, though not across byte orders.
+ */
+inline size_t
+mlHashBytes(const void *data, size_t length)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    MlULong hash = 0x9e3779b97f4a7c15ULL ^ length;
+    MlULong word;
+    for (; length >= 8; bytes += 8, length -= 8) {
+        memcpy(&word, bytes, 8);
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    word = 0;
+    memcpy(&word, bytes, length);
+    hash = (hash ^ word) * 0xc4ceb9fe1a85ec53ULL;
+    return (size_t) (hash ^ (hash >> 29));
+}
+
+
+/**
+ * @brief MleHash is the hash function used by the hash tables unless told
+ * otherwise.
+ *
+ * It is std::hash, except for strings: std::string and const char * keys
+ * are hashed by their characters, and either can be looked up with the
+ * other.
+ */
+template <class K> struct MleHash
+{
+    size_t operator()(const K& key) const
+    { return std::hash<K>()(key); }
+};
+
+template <> struct MleHash<std::string>
+{
+    typedef void is_transparent;
+
+    size_t operator()(const std::string& key) const
+    { return mlHashBytes(key.data(), key.size()); }
+
+    size_t operator()(const char *key) const
+    { return mlHashBytes(key, strlen(key)); }
+};
+
+template <> struct MleHash<const char *> : public MleHash<std::string> {};
+
+
+/**
+ * @brief MleEqual is the equality test used by the hash tables unless told
+ * otherwise.
+ *
+ * It is operator==, except for strings, which are compared by their
+ * characters, so that a std::string can be compared with a const char *.
+ */
+template <class K> struct MleEqual
+{
+    bool operator()(const K& a, const K& b) const
+    { return a == b; }
+};
+
+template <> struct MleEqual<std::string>
+{
+    typedef void is_transparent;
+
+    bool operator()(const std::string& a, const std::string& b) const
+    { return a == b; }
+
+    bool operator()(const std::string& a, const char *b) const
+    { return a.compare(b) == 0; }
+
+    bool operator()(const char *a, const std::string& b) const
+    { return b.compare(a) == 0; }
+
+    bool operator()(const char *a, const char *b) const
+    { return strcmp(a, b) == 0; }
+};
+
+template <> struct MleEqual<const char *> : public MleEqual<std::string> {};
+
+
+// Whether a hash function and equality test take keys of other types.
+template <class...> struct MleHashVoid { typedef void type; };
+
+template <class H, class E, class = void> struct MleHashIsTransparent : public std::false_type {};
+
+template <class H, class E>
+struct MleHashIsTransparent<H, E, typename MleHashVoid<typename H::is_transparent, typename E::is_transparent>::type>
+  : public std::true_type {};
+
+// The type a key of type Q is looked up as: Q itself if the table takes
+// other key types, otherwise a K converted from it.
+template <class K, class Q, bool TRANSPARENT> struct MleHashLookup { typedef K type; };
+
+template <class K, class Q> struct MleHashLookup<K, Q, true> { typedef Q type; };
+
+
+// The control bytes of a group of slots, which are probed together. A
+// byte holds 7 bits of the hash of the key in the slot, or marks the slot
+// as empty or as deleted.
+class MleHashGroup
+{
+  public:
+
+    static const int SIZE = 16;
+    static const signed char EMPTY = -128;
+    static const signed char DELETED = -2;
+
+#ifdef MLE_HASH_SSE2
+    explicit MleHashGroup(const signed char *control)
+      : m_control(_mm_loadu_si128((const __m128i *) control))
+    {}
+
+	// Get a bit for each slot holding a tag.
+    unsigned int match(signed char tag) const
+    { return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_control)); }
+
+	// Get a bit for each slot that is empty or deleted.
+    unsigned int matchFree() const
+    { return (unsigned int) _mm_movemask_epi8(m_control); }
+#else
+    explicit MleHashGroup(const signed char *control)
+      : m_control(control)
+    {}
+
+    unsigned int match(signed char tag) const
+    {
+        unsigned int mask = 0;
+        for (int i = 0; i < SIZE; i++) {
+            if (m_control[i] == tag) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+
+    unsigned int matchFree() const
+    {
+        unsigned int mask = 0;
+        for (int i = 0; i < SIZE; i++) {
+            if (m_control[i] < 0) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+#endif /* MLE_HASH_SSE2 */
+
+	// Get a bit for each empty slot.
+    unsigned int matchEmpty() const
+    { return match(EMPTY); }
+
+	// Get the index of the lowest bit set in a non-zero mask.
+    static int lowestBit(unsigned int mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int) index;
+#else
+        return __builtin_ctz(mask);
+#endif /* _MSC_VER */
+    }
+
+  private:
+
+#ifdef MLE_HASH_SSE2
+    __m128i m_control;
+#else
+    const signed char *m_control;
+#endif /* MLE_HASH_SSE2 */
+};
+
+
+// Passed to the constructor of a map entry to build it from a key and
+// the arguments of the value's constructor.
+struct MleHashInPlace {};
+
+
+/**
+ * @brief MleHashMapEntry is the key and value stored by MleHashMap.
+ *
+ * The key must not be changed while the entry is in a map.
+ */
+template <class K, class V> struct MleHashMapEntry
+{
+    template <class Q, class... Args> MleHashMapEntry(MleHashInPlace, Q&& key, Args&&... args)
+      : first(std::forward<Q>(key)), second(std::forward<Args>(args)...)
+    {}
+
+    K first;
+    V second;
+};
+
+
+/**
+ * @brief MleHashIterator visits the entries of a hash table, in no
+ * particular order.
+ */
+template <class Entry> class MleHashIterator
+{
+  public:
+
+    MleHashIterator(const signed char *control, Entry *slots, int index, int capacity)
+      : m_control(control), m_slots(slots), m_index(index), m_capacity(capacity)
+    { skipFree(); }
+
+    Entry& operator* () const { return m_slots[m_index]; }
+
+    Entry* operator-> () const { return &m_slots[m_index]; }
+
+    MleHashIterator& operator++ ()
+    {
+        m_index++;
+        skipFree();
+        return *this;
+    }
+
+    bool operator== (const MleHashIterator& i) const { return m_index == i.m_index; }
+
+    bool operator!= (const MleHashIterator& i) const { return m_index != i.m_index; }
+
+  private:
+
+    void skipFree()
+    {
+        while ((m_index < m_capacity) && (m_control[m_index] < 0)) {
+            m_index++;
+        }
+    }
+
+    const signed char *m_control;
+    Entry *m_slots;
+    int m_index;
+    int m_capacity;
+};
+
+
+/**
+ * @brief MleFlatHashTable is the open addressing hash table behind
+ * MleHashMap and MleHashSet.
+ *
+ * Entries are stored in place, in a single block from the allocator policy
+ * A, behind an array of control bytes, one per slot. A control byte holds
+ * 7 bits of the hash of the slot's key, so a lookup compares the bytes of
+ * a group of 16 slots with a single SSE2 instruction and only compares
+ * keys whose bits match. Groups are probed in a quadratic sequence until
+ * one with an empty slot is found. The table grows by doubling when 7/8
+ * of its slots have been used.
+ *
+ * Inserting into the table or erasing from it may move entries, so
+ * pointers to entries and iterators are valid only until the table is next
+ * changed. Hash functions and equality tests are called on keys in the
+ * table and on the key being looked up, in that order.
+ */
+template <class Entry, class K, class KeyOf, class H, class E, class A> class MleFlatHashTable : private A
+{
+
+  // Declare member variables.
+
+  private:
+
+	// The control bytes, one per slot, at the start of the block from the allocator.
+    signed char *m_control;
+	// The slots, following the control bytes.
+    Entry *m_slots;
+	// The number of slots; a power of two, at least a group.
+    int m_capacity;
+	// The number of entries.
+    int m_size;
+	// The number of empty slots that may still be filled before growing.
+    int m_growthLeft;
+    H m_hash;
+    E m_equal;
+
+    static_assert(alignof(Entry) <= alignof(std::max_align_t), "over-aligned entries are not supported");
+
+    static const bool TRANSPARENT = MleHashIsTransparent<H, E>::value;
+
+
+  // Declare member functions.
+
+  public:
+
+    typedef typename std::conditional<std::is_same<Entry, K>::value, const Entry, Entry>::type IteratedEntry;
+    typedef MleHashIterator<IteratedEntry> iterator;
+    typedef MleHashIterator<const Entry> const_iterator;
+
+
+	/**
+	 * @brief Default constructor.
+	 *
+	 * The table is initialized to be empty. No memory is allocated until
+	 * the first entry is added.
+	 *
+	 * @param allocator The policy the table takes its storage from.
+	 * @param hash The hash function.
+	 * @param equal The equality test.
+     */
+    explicit MleFlatHashTable(const A& allocator = A(), const H& hash = H(), const E& equal = E())
+      : A(allocator), m_hash(hash), m_equal(equal)
+    {
+        m_control = NULL;
+        m_slots = NULL;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+    }
+
+
+	/**
+	 * @brief The copy constructor.
+	 *
+	 * The copy uses the same allocator policy as the original. If memory
+	 * cannot be allocated, the copy is empty.
+	 */
+    MleFlatHashTable(const MleFlatHashTable& t)
+      : A(t), m_hash(t.m_hash), m_equal(t.m_equal)
+    {
+        m_control = NULL;
+        m_slots = NULL;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+        copyFrom(t);
+    }
+
+
+	/**
+	 * @brief The move constructor.
+	 *
+	 * The other table is left empty.
+	 */
+    MleFlatHashTable(MleFlatHashTable&& t) noexcept
+      : A(t), m_hash(t.m_hash), m_equal(t.m_equal)
+    {
+        m_control = t.m_control;
+        m_slots = t.m_slots;
+        m_capacity = t.m_capacity;
+        m_size = t.m_size;
+        m_growthLeft = t.m_growthLeft;
+        t.m_control = NULL;
+        t.m_slots = NULL;
+        t.m_capacity = 0;
+        t.m_size = 0;
+        t.m_growthLeft = 0;
+    }
+
+
+	/**
+	 * @brief Destructor.
+	 */
+    ~MleFlatHashTable()
+    {
+        destroyAll();
+        if (m_control != NULL) this->release(m_control);
+    }
+
+
+	/**
+	 * @brief The copy assignment operator.
+	 *
+	 * The table keeps its own allocator policy.
+	 */
+    MleFlatHashTable& operator= (const MleFlatHashTable& t)
+    {
+        if (this != &t) {
+            destroyAll();
+            if (m_control != NULL) this->release(m_control);
+            m_control = NULL;
+            m_slots = NULL;
+            m_capacity = 0;
+            m_size = 0;
+            m_growthLeft = 0;
+            m_hash = t.m_hash;
+            m_equal = t.m_equal;
+            copyFrom(t);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief The move assignment operator.
+	 *
+	 * The table takes over the allocator policy along with the entries.
+	 */
+    MleFlatHashTable& operator= (MleFlatHashTable&& t) noexcept
+    {
+        if (this != &t) {
+            destroyAll();
+            if (m_control != NULL) this->release(m_control);
+            A::operator=(t);
+            m_hash = t.m_hash;
+            m_equal = t.m_equal;
+            m_control = t.m_control;
+            m_slots = t.m_slots;
+            m_capacity = t.m_capacity;
+            m_size = t.m_size;
+            m_growthLeft = t.m_growthLeft;
+            t.m_control = NULL;
+            t.m_slots = NULL;
+            t.m_capacity = 0;
+            t.m_size = 0;
+            t.m_growthLeft = 0;
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief Get the number of entries.
+	 */
+    int size() const
+    { return m_size; }
+
+
+	/**
+	 * @brief Get the number of slots, of which up to 7/8 may be used
+	 * before the table grows.
+	 */
+    int capacity() const
+    { return m_capacity; }
+
+
+	/**
+	 * @brief Get the allocator policy the table takes its storage from.
+	 */
+    const A& getAllocator() const
+    { return *this; }
+
+
+	/**
+	 * @brief Make room for a number of entries, so that adding them does
+	 * not allocate.
+	 *
+	 * @return <b>false</b> is returned if memory could not be allocated.
+	 */
+    bool reserve(const int num)
+    {
+        int capacity = MleHashGroup::SIZE;
+        while (maxLoad(capacity) < num) {
+            if (capacity > (1 << 29)) {
+                return false;
+            }
+            capacity *= 2;
+        }
+        return (capacity <= m_capacity) || rehash(capacity);
+    }
+
+
+	/**
+	 * @brief Remove all the entries, keeping the storage.
+	 */
+    void clear()
+    {
+        destroyAll();
+        if (m_control != NULL) {
+            memset(m_control, MleHashGroup::EMPTY, m_capacity);
+        }
+        m_size = 0;
+        m_growthLeft = maxLoad(m_capacity);
+    }
+
+
+    iterator begin()
+    { return iterator(m_control, m_slots, 0, m_capacity); }
+
+    iterator end()
+    { return iterator(m_control, m_slots, m_capacity, m_capacity); }
+
+    const_iterator begin() const
+    { return const_iterator(m_control, m_slots, 0, m_capacity); }
+
+    const_iterator end() const
+    { return const_iterator(m_control, m_slots, m_capacity, m_capacity); }
+
+
+  protected:
+
+	// Find the entry with a key, or return NULL.
+    template <class Q> Entry* lookup(const Q& key) const
+    {
+        const typename MleHashLookup<K, Q, TRANSPARENT>::type& k = key;
+        int index = findIndex(k, mix(m_hash(k)));
+        return (index >= 0) ? &m_slots[index] : NULL;
+    }
+
+
+	// Find the slot of the entry with a key, or take a free slot for it,
+	// which the caller must construct an entry in. Returns NULL if memory
+	// could not be allocated.
+    template <class Q> Entry* prepareInsert(const Q& key, bool& found)
+    {
+        const typename MleHashLookup<K, Q, TRANSPARENT>::type& k = key;
+        MlULong hash = mix(m_hash(k));
+        int index = findIndex(k, hash);
+        found = (index >= 0);
+        if (found) {
+            return &m_slots[index];
+        }
+
+        index = (m_capacity > 0) ? findFree(m_control, m_capacity, hash) : -1;
+        if ((index < 0) || (m_control[index] == MleHashGroup::EMPTY)) {
+            if (m_growthLeft == 0) {
+                if (! grow()) {
+                    return NULL;
+                }
+                index = findFree(m_control, m_capacity, hash);
+            }
+            m_growthLeft--;
+        }
+        m_control[index] = tagOf(hash);
+        m_size++;
+        return &m_slots[index];
+    }
+
+
+	// Remove the entry with a key, if there is one.
+    template <class Q> bool remove(const Q& key)
+    {
+        Entry *entry = lookup(key);
+        if (entry == NULL) {
+            return false;
+        }
+
+        int index = (int) (entry - m_slots);
+        entry->~Entry();
+        m_size--;
+
+        // A lookup stops at a group with an empty slot, so a slot may only
+        // be emptied if its group never filled up; otherwise keys placed
+        // further along the probe sequence would be lost.
+        int group = index & ~(MleHashGroup::SIZE - 1);
+        if (MleHashGroup(m_control + group).matchEmpty() != 0) {
+            m_control[index] = MleHashGroup::EMPTY;
+            m_growthLeft++;
+        } else {
+            m_control[index] = MleHashGroup::DELETED;
+        }
+        return true;
+    }
+
+
+  private:
+
+	// The number of slots that may be used in a table of a capacity.
+    static int maxLoad(int capacity)
+    { return capacity - capacity / 8; }
+
+
+	// Spread the bits of a hash, since many hash functions are the identity.
+    static MlULong mix(size_t hash)
+    {
+        MlULong h = (MlULong) hash * 0x9e3779b97f4a7c15ULL;
+        return h ^ (h >> 32);
+    }
+
+
+    static signed char tagOf(MlULong hash)
+    { return (signed char) (hash & 0x7f); }
+
+
+	// Where the slots start in a block.
+    static size_t slotOffset(int capacity)
+    { return ((size_t) capacity + alignof(Entry) - 1) & ~(alignof(Entry) - 1); }
+
+
+    template <class Q> int findIndex(const Q& key, MlULong hash) const
+    {
+        if (m_capacity == 0) {
+            return -1;
+        }
+
+        size_t groupMask = (size_t) m_capacity / MleHashGroup::SIZE - 1;
+        size_t group = (size_t) (hash >> 7) & groupMask;
+        signed char tag = tagOf(hash);
+        for (size_t step = 1; ; step++) {
+            const signed char *control = m_control + group * MleHashGroup::SIZE;
+            MleHashGroup probe(control);
+            for (unsigned int match = probe.match(tag); match != 0; match &= match - 1) {
+                int index = (int) (group * MleHashGroup::SIZE) + MleHashGroup::lowestBit(match);
+                if (m_equal(KeyOf::key(m_slots[index]), key)) {
+                    return index;
+                }
+            }
+            if (probe.matchEmpty() != 0) {
+                return -1;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+
+	// Find the first empty or deleted slot along a hash's probe sequence.
+    static int findFree(const signed char *control, int capacity, MlULong hash)
+    {
+        size_t groupMask = (size_t) capacity / MleHashGroup::SIZE - 1;
+        size_t group = (size_t) (hash >> 7) & groupMask;
+        for (size_t step = 1; ; step++) {
+            unsigned int vacant = MleHashGroup(control + group * MleHashGroup::SIZE).matchFree();
+            if (vacant != 0) {
+                return (int) (group * MleHashGroup::SIZE) + MleHashGroup::lowestBit(vacant);
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+
+	// Make room for another entry: double the table, or just sweep out the
+	// deleted slots if they take up much of it.
+    bool grow()
+    {
+        if (m_capacity == 0) {
+            return rehash(MleHashGroup::SIZE);
+        }
+        if (m_size <= maxLoad(m_capacity) / 2) {
+            return rehash(m_capacity);
+        }
+        return (m_capacity <= (1 << 29)) && rehash(m_capacity * 2);
+    }
+
+
+	// Move the entries to a new block of a capacity.
+    bool rehash(int capacity)
+    {
+        if ((capacity <= 0) || (capacity > (1 << 30))) {
+            return false;
+        }
+        size_t offset = slotOffset(capacity);
+        unsigned char *block = (unsigned char *) this->allocate(offset + sizeof(Entry) * (size_t) capacity);
+        if (block == NULL) {
+            return false;
+        }
+
+        signed char *control = (signed char *) block;
+        Entry *slots = (Entry *) (block + offset);
+        memset(control, MleHashGroup::EMPTY, (size_t) capacity);
+        for (int i = 0; i < m_capacity; i++) {
+            if (m_control[i] >= 0) {
+                MlULong hash = mix(m_hash(KeyOf::key(m_slots[i])));
+                int index = findFree(control, capacity, hash);
+                control[index] = tagOf(hash);
+                new (&slots[index]) Entry(std::move(m_slots[i]));
+                m_slots[i].~Entry();
+            }
+        }
+
+        if (m_control != NULL) this->release(m_control);
+        m_control = control;
+        m_slots = slots;
+        m_capacity = capacity;
+        m_growthLeft = maxLoad(capacity) - m_size;
+        return true;
+    }
+
+
+	// Copy the entries of another table into this empty one, slot for slot.
+    void copyFrom(const MleFlatHashTable& t)
+    {
+        if (t.m_size == 0) {
+            return;
+        }
+        size_t offset = slotOffset(t.m_capacity);
+        unsigned char *block = (unsigned char *) this->allocate(offset + sizeof(Entry) * (size_t) t.m_capacity);
+        if (block == NULL) {
+            return;
+        }
+
+        m_control = (signed char *) block;
+        m_slots = (Entry *) (block + offset);
+        memcpy(m_control, t.m_control, t.m_capacity);
+        for (int i = 0; i < t.m_capacity; i++) {
+            if (t.m_control[i] >= 0) {
+                new (&m_slots[i]) Entry(t.m_slots[i]);
+            }
+        }
+        m_capacity = t.m_capacity;
+        m_size = t.m_size;
+        m_growthLeft = t.m_growthLeft;
+    }
+
+
+    void destroyAll()
+    {
+        if (! std::is_trivially_destructible<Entry>::value) {
+            for (int i = 0; i < m_capacity; i++) {
+                if (m_control[i] >= 0) {
+                    m_slots[i].~Entry();
+                }
+            }
+        }
+    }
+};
+
+
+// Get the key of an entry of a map or a set.
+template <class K, class V> struct MleHashMapKey
+{
+    static const K& key(const MleHashMapEntry<K, V>& entry) { return entry.first; }
+};
+
+template <class K> struct MleHashSetKey
+{
+    static const K& key(const K& entry) { return entry; }
+};
+
+
+/**
+ * @brief MleHashMap is a template for a map from keys to values, stored in
+ * a flat open addressing hash table.
+ *
+ * See MleFlatHashTable for how it works. Iterating over the map visits
+ * MleHashMapEntry objects, with the key in <b>first</b> and the value in
+ * <b>second</b>.
+ *
+ * With the default hash function and equality test, a map whose keys are
+ * std::string can be searched with a const char * without building a
+ * string:
+ * <pre>
+ *     MleHashMap<std::string, MleDSOEntry *> classes;
+ *     MleDSOEntry **entry = classes.find("MleActor");
+ * </pre>
+ * A map with const char * keys compares them by their characters, and
+ * does not copy them, so the strings must outlive the map.
+ *
+ * Storage comes from the allocator policy A, as for MleArray; with
+ * MleManagerAllocator it comes from a memory manager.
+ */
+template <class K, class V, class H = MleHash<K>, class E = MleEqual<K>, class A = MleMallocAllocator>
+class MleHashMap : public MleFlatHashTable<MleHashMapEntry<K, V>, K, MleHashMapKey<K, V>, H, E, A>
+{
+    typedef MleHashMapEntry<K, V> Entry;
+    typedef MleFlatHashTable<Entry, K, MleHashMapKey<K, V>, H, E, A> Table;
+
+  public:
+
+	/**
+	 * @brief Constructor. The map is initialized to be empty.
+	 *
+	 * @param allocator The policy the map takes its storage from.
+	 * @param hash The hash function.
+	 * @param equal The equality test.
+	 */
+    explicit MleHashMap(const A& allocator = A(), const H& hash = H(), const E& equal = E())
+      : Table(allocator, hash, equal)
+    {}
+
+
+	/**
+	 * @brief Find the value of a key.
+	 *
+	 * @return A pointer to the value is returned, or NULL if the key is
+	 * not in the map.
+	 */
+    template <class Q> V* find(const Q& key)
+    {
+        Entry *entry = this->lookup(key);
+        return (entry != NULL) ? &entry->second : NULL;
+    }
+
+    template <class Q> const V* find(const Q& key) const
+    {
+        const Entry *entry = this->lookup(key);
+        return (entry != NULL) ? &entry->second : NULL;
+    }
+
+
+	/**
+	 * @brief Check whether a key is in the map.
+	 */
+    template <class Q> bool contains(const Q& key) const
+    { return this->lookup(key) != NULL; }
+
+
+	/**
+	 * @brief Set the value of a key, adding the key if it is not already
+	 * in the map.
+	 *
+	 * @return A pointer to the value in the map is returned, or NULL if
+	 * memory could not be allocated.
+	 */
+    template <class Q, class U> V* insert(Q&& key, U&& value)
+    {
+        bool found;
+        Entry *entry = this->prepareInsert(key, found);
+        if (entry == NULL) {
+            return NULL;
+        }
+        if (found) {
+            entry->second = std::forward<U>(value);
+        } else {
+            new (entry) Entry(MleHashInPlace(), std::forward<Q>(key), std::forward<U>(value));
+        }
+        return &entry->second;
+    }
+
+
+	/**
+	 * @brief Add a key with a value built from the arguments, unless the
+	 * key is already in the map.
+	 *
+	 * @param key The key. A key of another type is converted to K only if
+	 * it is added.
+	 * @param args The arguments for the constructor of the value.
+	 *
+	 * @return A pointer to the value of the key is returned, whether it
+	 * was added or not, or NULL if memory could not be allocated.
+	 */
+    template <class Q, class... Args> V* emplace(Q&& key, Args&&... args)
+    {
+        bool found;
+        Entry *entry = this->prepareInsert(key, found);
+        if ((entry != NULL) && ! found) {
+            new (entry) Entry(MleHashInPlace(), std::forward<Q>(key), std::forward<Args>(args)...);
+        }
+        return (entry != NULL) ? &entry->second : NULL;
+    }
+
+
+	/**
+	 * @brief Remove a key and its value.
+	 *
+	 * @return <b>false</b> is returned if the key was not in the map.
+	 */
+    template <class Q> bool erase(const Q& key)
+    { return this->remove(key); }
+};
+
+
+/**
+ * @brief MleHashSet is a template for a set of keys, stored in a flat open
+ * addressing hash table.
+ *
+ * See MleFlatHashTable for how it works, and MleHashMap for the lookup of
+ * strings.
+ */
+template <class K, class H = MleHash<K>, class E = MleEqual<K>, class A = MleMallocAllocator>
+class MleHashSet : public MleFlatHashTable<K, K, MleHashSetKey<K>, H, E, A>
+{
+    typedef MleFlatHashTable<K, K, MleHashSetKey<K>, H, E, A> Table;
+
+  public:
+
+	/**
+	 * @brief Constructor. The set is initialized to be empty.
+	 *
+	 * @param allocator The policy the set takes its storage from.
+	 * @param hash The hash function.
+	 * @param equal The equality test.
+	 */
+    explicit MleHashSet(const A& allocator = A(), const H& hash = H(), const E& equal = E())
+      : Table(allocator, hash, equal)
+    {}
+
+
+	/**
+	 * @brief Find the key in the set equal to another.
+	 *
+	 * @return A pointer to the key in the set is returned, or NULL if
+	 * there is none.
+	 */
+    template <class Q> const K* find(const Q& key) const
+    { return this->lookup(key); }
+
+
+	/**
+	 * @brief Check whether a key is in the set.
+	 */
+    template <class Q> bool contains(const Q& key) const
+    { return this->lookup(key) != NULL; }
+
+
+	/**
+	 * @brief Add a key unless an equal one is already in the set.
+	 *
+	 * @param key The key. A key of another type is converted to K only if
+	 * it is added.
+	 *
+	 * @return A pointer to the key in the set is returned, whether it was
+	 * added or not, or NULL if memory could not be allocated.
+	 */
+    template <class Q> const K* insert(Q&& key)
+    {
+        bool found;
+        K *entry = this->prepareInsert(key, found);
+        if ((entry != NULL) && ! found) {
+            new (entry) K(std::forward<Q>(key));
+        }
+        return entry;
+    }
+
+
+	/**
+	 * @brief Remove a key.
+	 *
+	 * @return <b>false</b> is returned if the key was not in the set.
+	 */
+    template <class Q> bool erase(const Q& key)
+    { return this->remove(key); }
+};
+
+
+#endif /* __MLE_HASHTABLE_H_ */
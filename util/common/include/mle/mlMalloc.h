@@ -52,6 +52,11 @@
  * routines which correspond to mlMalloc(), mlFree(), mlRealloc() and
  * mlCalloc(). Then compile dependent code with the MLE_MALLOC compilation
  * macro turned on.
+ *
+ * mlMallocUsableSize() returns the number of bytes that may be used in a
+ * block from mlMalloc(), which can be more than was requested. It returns
+ * 0 when the allocator cannot tell, so callers must fall back on the size
+ * they requested.
  */
 
 #ifdef MLE_MALLOC
@@ -67,12 +72,19 @@ MlPhysadr *mlMalloc(unsigned int);
 MlPhysadr *mlRealloc(void *, unsigned int);
 MlPhysadr *mlCalloc(unsigned int, unsigned int);
 
+#define mlMallocUsableSize(ptr) ((size_t) 0)
+
 #else /* ! MLE_MALLOC */
 
 /* Include system header files. */
 #include <stdlib.h>
 #ifdef _WINDOWS
 #include <memory.h>
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
 #endif /* _WINDOWS */
 
 typedef void *MlPhysadr;
@@ -82,6 +94,14 @@ typedef void *MlPhysadr;
 #define mlRealloc realloc
 #define mlCalloc  calloc
 
+#ifdef _WINDOWS
+#define mlMallocUsableSize(ptr) _msize(ptr)
+#elif defined(__APPLE__)
+#define mlMallocUsableSize(ptr) malloc_size(ptr)
+#else
+#define mlMallocUsableSize(ptr) malloc_usable_size(ptr)
+#endif /* _WINDOWS */
+
 #endif /* MLE_MALLOC */
 
 
@@ -0,0 +1,603 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlSmallArray.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_SMALLARRAY_H_
+#define __MLE_SMALLARRAY_H_
+
+
+// Include standard header files.
+#if defined(__linux__) || defined(__APPLE__)
+#include <new>
+#endif /* __linux__ */
+#ifdef _WINDOWS
+#include <new.h>
+#include <memory.h>
+#endif /* _WINDOWS */
+#include <limits.h>
+#include <string.h>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+// Include Magic Lantern header files.
+#include <mle/mlMalloc.h>
+#include <mle/mlAllocator.h>
+
+
+/**
+ * @brief MleSmallArray is a template for managing an array of objects that
+ * keeps up to N of them inside the array itself.
+ *
+ * It has the same interface as MleArray. As long as the array holds no more
+ * than N elements, they live in storage embedded in the array object and no
+ * memory is allocated. Beyond that, the elements move to a block from the
+ * allocator policy A that grows geometrically like that of MleArray, and
+ * shrink_to_fit() brings them back once they fit again.
+ *
+ * Moving an array whose elements are embedded moves the elements one by
+ * one, so unlike MleArray it costs time proportional to the size.
+ */
+template <class T, int N, class A = MleMallocAllocator> class MleSmallArray : private A
+{
+
+  // Declare member variables.
+
+  private:
+
+	// The number of elements in the array.
+    int m_numElements;
+	// The number of elements there is room for.
+    int m_capacity;
+    // The array of elements, either m_inline or a block from the allocator.
+    T * m_data;
+	// Embedded storage for the first N elements.
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+    static_assert(N > 0, "MleSmallArray needs room for at least one element");
+
+
+  // Declare member functions.
+
+  public:
+
+	/**
+	 * @brief Default constructor.
+	 *
+	 * The array is initialized to be empty.
+     */
+    MleSmallArray()
+    {
+        m_numElements = 0;
+        m_capacity = N;
+        m_data = (T *) m_inline;
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the allocator policy.
+	 *
+	 * The array is initialized to be empty.
+	 *
+	 * @param allocator The policy the array takes its storage from.
+     */
+    explicit MleSmallArray(const A& allocator)
+      : A(allocator)
+    {
+        m_numElements = 0;
+        m_capacity = N;
+        m_data = (T *) m_inline;
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the initial number of elements
+	 * in the array.
+	 *
+	 * @param num The number of default constructed elements to place in
+	 * the array.
+	 * @param allocator The policy the array takes its storage from.
+	 */
+    MleSmallArray(int num, const A& allocator = A())
+      : A(allocator)
+    {
+        m_numElements = 0;
+        m_capacity = N;
+        m_data = (T *) m_inline;
+        resize(num);
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the initial contents
+	 * of the array.
+	 *
+	 * @param num The number of elements in the array.
+	 * @param ptr A pointer to the elements to place in the array. The
+	 * block must come from the allocator policy and is owned by the array
+	 * from now on.
+	 * @param allocator The policy the block came from.
+	 */
+    MleSmallArray(int num, T * ptr, const A& allocator = A())
+      : A(allocator)
+    {
+        m_numElements = num;
+        m_capacity = num;
+        m_data = ptr;
+    }
+
+
+	/**
+	 * @brief The copy constructor.
+	 *
+	 * The copy uses the same allocator policy as the original.
+	 *
+	 * @param a A reference to another array of elements from which to
+	 * copy.
+	 */
+    MleSmallArray(const MleSmallArray& a)
+      : A(a)
+    {
+        m_numElements = 0;
+        m_capacity = N;
+        m_data = (T *) m_inline;
+        copyFrom(a);
+    }
+
+
+	/**
+	 * @brief The move constructor.
+	 *
+	 * @param a A reference to another array whose elements are taken
+	 * over. It is left empty.
+	 */
+    MleSmallArray(MleSmallArray&& a) noexcept
+      : A(a)
+    {
+        m_numElements = 0;
+        m_capacity = N;
+        m_data = (T *) m_inline;
+        takeFrom(a);
+    }
+
+
+	/**
+	 * @brief Destructor.
+	 */
+    ~MleSmallArray()
+    {
+        destroy(0, m_numElements);
+        if (! isInline()) this->release(m_data);
+    }
+
+
+	/**
+	 * @brief The copy assignment operator.
+	 *
+	 * The array keeps its own allocator policy.
+	 *
+	 * @param a A reference to another array of elements from which to
+	 * copy.
+	 *
+	 * @return A reference to this array is returned.
+	 */
+    MleSmallArray& operator= (const MleSmallArray& a)
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            m_numElements = 0;
+            copyFrom(a);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief The move assignment operator.
+	 *
+	 * The array takes over the allocator policy along with the elements.
+	 *
+	 * @param a A reference to another array whose elements are taken
+	 * over. It is left empty.
+	 *
+	 * @return A reference to this array is returned.
+	 */
+    MleSmallArray& operator= (MleSmallArray&& a) noexcept
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            if (! isInline()) this->release(m_data);
+            A::operator=(a);
+            m_numElements = 0;
+            m_capacity = N;
+            m_data = (T *) m_inline;
+            takeFrom(a);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * Indexing past the end grows the array to include the element.
+	 *
+	 * @return The element located at the specifed location in the
+	 * array is returned.
+	 */
+    T& operator[] (int i)
+    {
+        if (i >= size()) {
+            resize( i+1 );
+        }
+        return ( m_data[i] );
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * @return The element located at the specifed location in the
+	 * array is returned.
+	 */
+    const T& operator[] (int i) const
+    {
+        return ( m_data[i] );
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * @return The element located at the specified offset in the
+	 * array is returned.
+	 */
+    T* operator+ (int i)
+    {
+        return ( m_data+i );
+    }
+
+
+    /**
+     * @brief Redirection operator.
+     *
+     * @return The contents of the array are redirected to the output stream.
+     */
+    friend std::ostream& operator<< (std::ostream& os, const MleSmallArray<T, N, A>& a)
+    {
+        a.print(os);
+        return os;
+    }
+
+
+	/**
+	 * @brief Get the size of the array.
+	 *
+	 * @return The number of elements in the array is returned.
+	 */
+    int size() const
+    {
+        return(m_numElements);
+    }
+
+
+	/**
+	 * @brief Get the capacity of the array.
+	 *
+	 * @return The number of elements the array can hold before it has
+	 * to grow its storage is returned. It is never less than N.
+	 */
+    int capacity() const
+    {
+        return(m_capacity);
+    }
+
+
+	/**
+	 * @brief Get the allocator policy.
+	 *
+	 * @return The policy the array takes its storage from is returned.
+	 */
+    const A& getAllocator() const
+    {
+        return *this;
+    }
+
+
+	/**
+	 * @brief Check whether the elements are embedded in the array.
+	 *
+	 * @return true is returned if no memory is allocated for the elements.
+	 */
+    bool isInline() const
+    {
+        return (m_data == (const T *) m_inline);
+    }
+
+
+	/**
+	 * @brief Resize the array.
+	 *
+	 * New elements are default constructed; elements beyond the new size
+	 * are destroyed.
+	 *
+	 * @param num The new size of the array.
+	 *
+	 * @return A pointer to the resized array is returned. NULL is returned
+	 * if the array is empty or memory could not be allocated, in which case
+	 * the array is left as it was.
+	 */
+    T* resize(const int num)
+    {
+        if (num < m_numElements) {
+            destroy((num > 0) ? num : 0, m_numElements);
+            m_numElements = (num > 0) ? num : 0;
+        } else if (num > m_numElements) {
+            if ((num > m_capacity) && ! grow(num)) {
+                return NULL;
+            }
+
+            // Run constructor on data[oldSize...num-1].
+            for (int i = m_numElements; i < num; i++) {
+                new (&m_data[i]) T;
+            }
+            m_numElements = num;
+        }
+
+        return (0 == m_numElements) ? NULL : m_data;
+    }
+
+
+	/**
+	 * @brief Make room for a number of elements.
+	 *
+	 * The size of the array does not change.
+	 *
+	 * @param num The number of elements to make room for.
+	 *
+	 * @return A pointer to the storage is returned, or NULL if memory could
+	 * not be allocated.
+	 */
+    T* reserve(const int num)
+    {
+        if ((num > m_capacity) && ! relocate(num)) {
+            return NULL;
+        }
+        return m_data;
+    }
+
+
+	/**
+	 * @brief Release the storage not used by the elements.
+	 *
+	 * The elements move back into the array if they fit.
+	 */
+    void shrink_to_fit()
+    {
+        if (m_capacity > m_numElements && ! isInline()) {
+            relocate(m_numElements);
+        }
+    }
+
+
+	/**
+	 * @brief Append a copy of an element to the array.
+	 *
+	 * @param element The element to copy.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    T* push_back(const T& element)
+    {
+        return emplace_back(element);
+    }
+
+
+	/**
+	 * @brief Append an element to the array, moving it in.
+	 *
+	 * @param element The element to move.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    T* push_back(T&& element)
+    {
+        return emplace_back(std::move(element));
+    }
+
+
+	/**
+	 * @brief Construct an element in place at the end of the array.
+	 *
+	 * @param args The arguments to pass to the constructor of the element.
+	 *
+	 * @return A pointer to the new element is returned, or NULL if memory
+	 * could not be allocated.
+	 */
+    template <class... Args> T* emplace_back(Args&&... args)
+    {
+        if (m_numElements == m_capacity) {
+            // The arguments may refer to an element of this array, so the
+            // new element is built before the old storage goes away.
+            T element(std::forward<Args>(args)...);
+            if (! grow(m_numElements + 1)) {
+                return NULL;
+            }
+            return new (&m_data[m_numElements++]) T(std::move(element));
+        }
+        return new (&m_data[m_numElements++]) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Print the array contents to the output stream.
+     *
+     * @param os A reference to the stream to redirect the output to.
+     */
+    void print(std::ostream& os) const
+    {
+        for (int i = 0 ; i < m_numElements; i++)
+        {
+            os << m_data[i];
+            os << " ";
+        }
+    }
+
+  private:
+
+	// Grow the storage geometrically to hold at least num elements.
+    bool grow(int num)
+    {
+        int newCapacity = (m_capacity > INT_MAX / 2) ? INT_MAX : m_capacity * 2;
+        if (newCapacity < num) {
+            newCapacity = num;
+        }
+        return relocate(newCapacity);
+    }
+
+	// Move the elements to the embedded storage if num elements fit there,
+	// else to a block for exactly num elements, or more if the allocator
+	// hands back a larger block.
+    bool relocate(int num)
+    {
+        size_t bytes = (size_t) num * sizeof(T);
+        if ((num < 0) || (bytes / sizeof(T) != (size_t) num)) {
+            return false;
+        }
+
+        T *newData;
+        if (num <= N) {
+            if (isInline()) {
+                return true;
+            }
+            newData = (T *) m_inline;
+            num = N;
+        } else if (std::is_trivially_copyable<T>::value && ! isInline()) {
+            // The block only moves if the allocator has no slack left to
+            // grow into.
+            newData = (T *) this->reallocate( m_data, bytes );
+            if (NULL == newData) {
+                return false;
+            }
+            m_data = newData;
+        } else {
+            newData = (T *) this->allocate( bytes );
+            if (NULL == newData) {
+                return false;
+            }
+        }
+
+        if (newData != m_data) {
+            moveElements(newData, m_data, m_numElements);
+            if (! isInline()) this->release(m_data);
+        }
+
+        m_data = newData;
+        m_capacity = num;
+        if (! isInline()) {
+            size_t usable = this->usableSize( m_data ) / sizeof(T);
+            if (usable > (size_t) num) {
+                m_capacity = (usable > 0x7fffffff) ? 0x7fffffff : (int) usable;
+            }
+        }
+        return true;
+    }
+
+	// Move count elements to uninitialized storage, destroying the originals.
+    static void moveElements(T *to, T *from, int count)
+    {
+        if (std::is_trivially_copyable<T>::value) {
+            if (count > 0) {
+                memcpy ( (void *) to, (const void *) from, count * sizeof(T) );
+            }
+        } else {
+            for (int i = 0; i < count; i++) {
+                new (&to[i]) T(std::move_if_noexcept(from[i]));
+                from[i].~T();
+            }
+        }
+    }
+
+	// Run the destructor on data[first...last-1].
+    void destroy(int first, int last)
+    {
+        if (! std::is_trivially_destructible<T>::value) {
+            for (int i = first; i < last; i++) {
+                m_data[i].~T();
+            }
+        }
+    }
+
+	// Copy the elements of another array into this empty one.
+    void copyFrom(const MleSmallArray& a)
+    {
+        if ((a.m_numElements > m_capacity) && ! relocate(a.m_numElements)) {
+            return;
+        }
+        if (std::is_trivially_copyable<T>::value) {
+            if (a.m_numElements > 0) {
+                memcpy ( (void *) m_data, (const void *) a.m_data, a.m_numElements * sizeof(T) );
+            }
+        } else {
+            for (int i = 0; i < a.m_numElements; i++) {
+                new (&m_data[i]) T(a.m_data[i]);
+            }
+        }
+        m_numElements = a.m_numElements;
+    }
+
+	// Take over the elements of another array; this one is empty and
+	// embedded, and the other is left empty.
+    void takeFrom(MleSmallArray& a)
+    {
+        if (a.isInline()) {
+            moveElements(m_data, a.m_data, a.m_numElements);
+        } else {
+            m_data = a.m_data;
+            m_capacity = a.m_capacity;
+            a.m_data = (T *) a.m_inline;
+            a.m_capacity = N;
+        }
+        m_numElements = a.m_numElements;
+        a.m_numElements = 0;
+    }
+};
+
+#endif /* __MLE_SMALLARRAY_H_ */
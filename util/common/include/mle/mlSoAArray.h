@@ -0,0 +1,673 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlSoAArray.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_SOAARRAY_H_
+#define __MLE_SOAARRAY_H_
+
+
+// Include standard header files.
+#include <new>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Include Magic Lantern header files.
+#include <mle/mlAllocator.h>
+#include <mle/mlArray.h>
+
+
+/**
+ * @brief MleSpan is a view of a run of elements owned by someone else.
+ *
+ * It is what MleBasicSoAArray::field() returns, and stays valid until the
+ * array is resized.
+ */
+template <class T> class MleSpan
+{
+  public:
+
+    MleSpan(T *data, int size) : m_data(data), m_size(size) {}
+
+	/**
+	 * @brief Get the first element, or NULL if there are none.
+	 */
+    T* data() const { return m_data; }
+
+	/**
+	 * @brief Get the number of elements.
+	 */
+    int size() const { return m_size; }
+
+    T& operator[] (int i) const { return m_data[i]; }
+
+    T* begin() const { return m_data; }
+
+    T* end() const { return m_data + m_size; }
+
+  private:
+
+    T *m_data;
+    int m_size;
+};
+
+
+/**
+ * @brief MleBasicSoAArray is a template for managing an array of records in
+ * structure of arrays form.
+ *
+ * Where an MleArray of structures keeps the fields of each record
+ * together, this array keeps each field of all the records together in a
+ * column of its own, so that a loop over one field reads only that field.
+ * The columns share one block from the allocator policy A, each starting
+ * on a COLUMN_ALIGNMENT byte boundary of the block. With the default
+ * policy, MleAlignedAllocator<64>, that makes each column 64 byte aligned,
+ * ready for MleArrayOps.
+ *
+ * Element i is seen through a std::tuple of references to its fields, so
+ * <pre>
+ *     MleSoAArray<float, float, int> points;
+ *     points.push_back(1.0f, 2.0f, 3);
+ *     auto [x, y, id] = points[0];
+ *     std::get<1>(points[0]) = 5.0f;
+ *     MleArrayOps::sum(points.field<0>().data(), points.field<0>().size());
+ * </pre>
+ * fromArray() and toArray() convert to and from an MleArray of structures,
+ * given a member pointer for each field.
+ *
+ * The array grows geometrically like MleArray. Since every column moves
+ * when the block is replaced, growing always moves the elements; fields
+ * that are not trivially copyable are move constructed (copied if their
+ * move constructor may throw) and the old ones destroyed.
+ */
+template <class A, class... Fields> class MleBasicSoAArray : private A
+{
+    static_assert(sizeof...(Fields) > 0, "MleBasicSoAArray needs at least one field");
+
+  public:
+
+    /**
+     * The boundary, in bytes, the columns start on within the block.
+     */
+    static const size_t COLUMN_ALIGNMENT = 64;
+
+    /**
+     * The number of fields in a record.
+     */
+    static const size_t FIELDS = sizeof...(Fields);
+
+    /**
+     * The type of field I.
+     */
+    template <size_t I> using Field = typename std::tuple_element<I, std::tuple<Fields...> >::type;
+
+    /**
+     * The records as seen through operator[].
+     */
+    typedef std::tuple<Fields&...> Reference;
+    typedef std::tuple<const Fields&...> ConstReference;
+
+    /**
+     * A record held by value.
+     */
+    typedef std::tuple<Fields...> Value;
+
+
+  // Declare member variables.
+
+  private:
+
+	// The number of elements in the array.
+    int m_numElements;
+	// The number of elements there is room for.
+    int m_capacity;
+	// The block holding the columns.
+    void * m_block;
+	// The start of each column within the block.
+    std::tuple<Fields*...> m_columns;
+
+
+  // Declare member functions.
+
+  public:
+
+	/**
+	 * @brief Default constructor.
+	 *
+	 * The array is initialized to be empty.
+     */
+    MleBasicSoAArray()
+    {
+        m_numElements = 0;
+        m_capacity = 0;
+        m_block = NULL;
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the allocator policy.
+	 *
+	 * @param allocator The policy the array takes its storage from.
+     */
+    explicit MleBasicSoAArray(const A& allocator)
+      : A(allocator)
+    {
+        m_numElements = 0;
+        m_capacity = 0;
+        m_block = NULL;
+    }
+
+
+	/**
+	 * @brief A constructor that is used to specify the initial number of
+	 * elements in the array.
+	 *
+	 * @param num The number of default constructed elements to place in
+	 * the array.
+	 * @param allocator The policy the array takes its storage from.
+	 */
+    MleBasicSoAArray(int num, const A& allocator = A())
+      : A(allocator)
+    {
+        m_numElements = 0;
+        m_capacity = 0;
+        m_block = NULL;
+        resize(num);
+    }
+
+
+	/**
+	 * @brief The copy constructor.
+	 *
+	 * The copy uses the same allocator policy as the original.
+	 */
+    MleBasicSoAArray(const MleBasicSoAArray& a)
+      : A(a)
+    {
+        m_numElements = 0;
+        m_capacity = 0;
+        m_block = NULL;
+        copyFrom(a);
+    }
+
+
+	/**
+	 * @brief The move constructor.
+	 *
+	 * @param a The array whose elements are taken over. It is left empty.
+	 */
+    MleBasicSoAArray(MleBasicSoAArray&& a) noexcept
+      : A(a)
+    {
+        m_numElements = 0;
+        m_capacity = 0;
+        m_block = NULL;
+        takeFrom(a);
+    }
+
+
+	/**
+	 * @brief Destructor.
+	 */
+    ~MleBasicSoAArray()
+    {
+        destroy(0, m_numElements);
+        if (m_block != NULL) this->release(m_block);
+    }
+
+
+	/**
+	 * @brief The copy assignment operator.
+	 *
+	 * The array keeps its own allocator policy.
+	 */
+    MleBasicSoAArray& operator= (const MleBasicSoAArray& a)
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            m_numElements = 0;
+            copyFrom(a);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief The move assignment operator.
+	 *
+	 * The array takes over the allocator policy along with the elements.
+	 */
+    MleBasicSoAArray& operator= (MleBasicSoAArray&& a) noexcept
+    {
+        if (this != &a) {
+            destroy(0, m_numElements);
+            if (m_block != NULL) this->release(m_block);
+            A::operator=(a);
+            m_numElements = 0;
+            m_capacity = 0;
+            m_block = NULL;
+            takeFrom(a);
+        }
+        return *this;
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * Indexing past the end grows the array to include the element.
+	 *
+	 * @return A tuple of references to the fields of the element is
+	 * returned.
+	 */
+    Reference operator[] (int i)
+    {
+        if (i >= size()) {
+            resize( i+1 );
+        }
+        return reference<Reference>(i, std::index_sequence_for<Fields...>());
+    }
+
+
+	/**
+	 * @brief Index operator.
+	 *
+	 * @return A tuple of references to the fields of the element is
+	 * returned.
+	 */
+    ConstReference operator[] (int i) const
+    {
+        return reference<ConstReference>(i, std::index_sequence_for<Fields...>());
+    }
+
+
+	/**
+	 * @brief Get one field of an element.
+	 */
+    template <size_t I> Field<I>& get(int i)
+    {
+        return std::get<I>(m_columns)[i];
+    }
+
+    template <size_t I> const Field<I>& get(int i) const
+    {
+        return std::get<I>(m_columns)[i];
+    }
+
+
+	/**
+	 * @brief Get the column of a field.
+	 *
+	 * @return A view of field I of every element is returned. It is valid
+	 * until the array is resized.
+	 */
+    template <size_t I> MleSpan<Field<I> > field()
+    {
+        return MleSpan<Field<I> >(std::get<I>(m_columns), m_numElements);
+    }
+
+    template <size_t I> MleSpan<const Field<I> > field() const
+    {
+        return MleSpan<const Field<I> >(std::get<I>(m_columns), m_numElements);
+    }
+
+
+	/**
+	 * @brief Get the size of the array.
+	 *
+	 * @return The number of elements in the array is returned.
+	 */
+    int size() const
+    {
+        return(m_numElements);
+    }
+
+
+	/**
+	 * @brief Get the capacity of the array.
+	 *
+	 * @return The number of elements the array can hold before it has
+	 * to grow its storage is returned.
+	 */
+    int capacity() const
+    {
+        return(m_capacity);
+    }
+
+
+	/**
+	 * @brief Get the allocator policy.
+	 */
+    const A& getAllocator() const
+    {
+        return *this;
+    }
+
+
+	/**
+	 * @brief Resize the array.
+	 *
+	 * New elements are default constructed; elements beyond the new size
+	 * are destroyed.
+	 *
+	 * @param num The new size of the array.
+	 *
+	 * @return false is returned, and the array left as it was, if memory
+	 * could not be allocated.
+	 */
+    bool resize(const int num)
+    {
+        if (num < m_numElements) {
+            destroy((num > 0) ? num : 0, m_numElements);
+            m_numElements = (num > 0) ? num : 0;
+        } else if (num > m_numElements) {
+            if ((num > m_capacity) && ! grow(num)) {
+                return false;
+            }
+            forEachField([&](auto I) {
+                typedef Field<decltype(I)::value> T;
+                T *column = std::get<decltype(I)::value>(m_columns);
+                for (int i = m_numElements; i < num; i++) {
+                    new (&column[i]) T;
+                }
+            });
+            m_numElements = num;
+        }
+        return true;
+    }
+
+
+	/**
+	 * @brief Make room for a number of elements.
+	 *
+	 * @return false is returned if memory could not be allocated.
+	 */
+    bool reserve(const int num)
+    {
+        return (num <= m_capacity) || relocate(num);
+    }
+
+
+	/**
+	 * @brief Release the storage not used by the elements.
+	 */
+    void shrink_to_fit()
+    {
+        if (m_capacity > m_numElements) {
+            relocate(m_numElements);
+        }
+    }
+
+
+	/**
+	 * @brief Append an element to the array.
+	 *
+	 * @param values The values of the fields, one per field.
+	 *
+	 * @return false is returned if memory could not be allocated.
+	 */
+    template <class... Args> bool push_back(Args&&... values)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "push_back() takes one value per field");
+
+        if (m_numElements == m_capacity) {
+            // The values may refer to an element of this array, so the
+            // new element is built before the old storage goes away.
+            Value element(std::forward<Args>(values)...);
+            if (! grow(m_numElements + 1)) {
+                return false;
+            }
+            construct(m_numElements, std::move(element), std::index_sequence_for<Fields...>());
+        } else {
+            construct(m_numElements, std::forward_as_tuple(std::forward<Args>(values)...),
+                      std::index_sequence_for<Fields...>());
+        }
+        m_numElements++;
+        return true;
+    }
+
+
+	/**
+	 * @brief Replace the contents of the array with the records of an
+	 * array of structures.
+	 *
+	 * @param records The array of structures.
+	 * @param members A pointer to the member of the structure that goes in
+	 * each field, in field order.
+	 *
+	 * @return false is returned if memory could not be allocated.
+	 */
+    template <class S, class B> bool fromArray(const MleArray<S, B>& records, Fields S::*... members)
+    {
+        resize(0);
+        if (! reserve(records.size())) {
+            return false;
+        }
+        for (int i = 0; i < records.size(); i++) {
+            const S& record = records[i];
+            push_back(record.*members...);
+        }
+        return true;
+    }
+
+
+	/**
+	 * @brief Copy the contents of the array into an array of structures.
+	 *
+	 * The array of structures is resized to match; its other members are
+	 * left alone.
+	 *
+	 * @param records The array of structures.
+	 * @param members A pointer to the member of the structure that takes
+	 * each field, in field order.
+	 *
+	 * @return false is returned if memory could not be allocated.
+	 */
+    template <class S, class B> bool toArray(MleArray<S, B>& records, Fields S::*... members) const
+    {
+        if ((records.resize(m_numElements) == NULL) && (m_numElements > 0)) {
+            return false;
+        }
+        S *record = records + 0;
+        for (int i = 0; i < m_numElements; i++) {
+            store(record[i], i, std::index_sequence_for<Fields...>(), members...);
+        }
+        return true;
+    }
+
+  private:
+
+	// Call f with std::integral_constant<size_t, I> for each field I.
+    template <class F, size_t... I> static void forEachField(F&& f, std::index_sequence<I...>)
+    {
+        (f(std::integral_constant<size_t, I>()), ...);
+    }
+
+    template <class F> static void forEachField(F&& f)
+    {
+        forEachField(f, std::index_sequence_for<Fields...>());
+    }
+
+    template <class R, size_t... I> R reference(int i, std::index_sequence<I...>) const
+    {
+        return R(std::get<I>(m_columns)[i]...);
+    }
+
+	// Construct element i from a tuple of values.
+    template <class Tuple, size_t... I> void construct(int i, Tuple&& values, std::index_sequence<I...>)
+    {
+        (new (&std::get<I>(m_columns)[i]) Field<I>(std::get<I>(std::forward<Tuple>(values))), ...);
+    }
+
+    template <class S, size_t... I> void store(S& record, int i, std::index_sequence<I...>, Fields S::*... members) const
+    {
+        ((record.*members = std::get<I>(m_columns)[i]), ...);
+    }
+
+	// Grow the storage geometrically to hold at least num elements.
+    bool grow(int num)
+    {
+        int newCapacity = (m_capacity < 4) ? 4 : (m_capacity > INT_MAX / 2) ? INT_MAX : m_capacity * 2;
+        if (newCapacity < num) {
+            newCapacity = num;
+        }
+        return relocate(newCapacity);
+    }
+
+	// Move the elements to a block with columns for num elements.
+    bool relocate(int num)
+    {
+        if (num < 0) {
+            return false;
+        }
+
+        // Lay out the columns.
+        size_t offsets[sizeof...(Fields)];
+        size_t bytes = 0;
+        bool fits = true;
+        forEachField([&](auto I) {
+            typedef Field<decltype(I)::value> T;
+            const size_t alignment = (alignof(T) > COLUMN_ALIGNMENT) ? alignof(T) : COLUMN_ALIGNMENT;
+            bytes = (bytes + alignment - 1) & ~(alignment - 1);
+            offsets[I] = bytes;
+            if ((size_t) num > (SIZE_MAX - bytes - alignment) / sizeof(T)) {
+                fits = false;
+            }
+            bytes += (size_t) num * sizeof(T);
+        });
+        if (! fits) {
+            return false;
+        }
+
+        unsigned char *block = NULL;
+        if (num > 0) {
+            block = (unsigned char *) this->allocate( bytes );
+            if (NULL == block) {
+                return false;
+            }
+        }
+
+        forEachField([&](auto I) {
+            typedef Field<decltype(I)::value> T;
+            T *from = std::get<decltype(I)::value>(m_columns);
+            T *to = (T *) (block + offsets[I]);
+            if (std::is_trivially_copyable<T>::value) {
+                if (m_numElements > 0) {
+                    memcpy ( (void *) to, (const void *) from, m_numElements * sizeof(T) );
+                }
+            } else {
+                for (int i = 0; i < m_numElements; i++) {
+                    new (&to[i]) T(std::move_if_noexcept(from[i]));
+                    from[i].~T();
+                }
+            }
+            std::get<decltype(I)::value>(m_columns) = (num > 0) ? to : NULL;
+        });
+
+        if (m_block != NULL) this->release(m_block);
+        m_block = block;
+        m_capacity = num;
+        return true;
+    }
+
+	// Run the destructors of elements first...last-1.
+    void destroy(int first, int last)
+    {
+        forEachField([&](auto I) {
+            typedef Field<decltype(I)::value> T;
+            if (! std::is_trivially_destructible<T>::value) {
+                T *column = std::get<decltype(I)::value>(m_columns);
+                for (int i = first; i < last; i++) {
+                    column[i].~T();
+                }
+            }
+        });
+    }
+
+	// Copy the elements of another array into this empty one.
+    void copyFrom(const MleBasicSoAArray& a)
+    {
+        if ((a.m_numElements > m_capacity) && ! relocate(a.m_numElements)) {
+            return;
+        }
+        forEachField([&](auto I) {
+            typedef Field<decltype(I)::value> T;
+            T *to = std::get<decltype(I)::value>(m_columns);
+            const T *from = std::get<decltype(I)::value>(a.m_columns);
+            if (std::is_trivially_copyable<T>::value) {
+                if (a.m_numElements > 0) {
+                    memcpy ( (void *) to, (const void *) from, a.m_numElements * sizeof(T) );
+                }
+            } else {
+                for (int i = 0; i < a.m_numElements; i++) {
+                    new (&to[i]) T(from[i]);
+                }
+            }
+        });
+        m_numElements = a.m_numElements;
+    }
+
+	// Take over the elements of another array; this one is empty and has
+	// no storage, and the other is left the same way.
+    void takeFrom(MleBasicSoAArray& a)
+    {
+        m_numElements = a.m_numElements;
+        m_capacity = a.m_capacity;
+        m_block = a.m_block;
+        m_columns = a.m_columns;
+        a.m_numElements = 0;
+        a.m_capacity = 0;
+        a.m_block = NULL;
+        a.m_columns = std::tuple<Fields*...>();
+    }
+};
+
+
+/**
+ * @brief MleSoAArray is an MleBasicSoAArray whose columns are 64 byte
+ * aligned.
+ */
+template <class... Fields> using MleSoAArray = MleBasicSoAArray<MleAlignedAllocator<64>, Fields...>;
+
+
+#endif /* __MLE_SOAARRAY_H_ */
@@ -0,0 +1,364 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ * @file mlTypedUnique.h
+ * @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_TYPEDUNIQUE_H_
+#define __MLE_TYPEDUNIQUE_H_
+
+
+// Include system header files.
+#include <stddef.h>
+#include <string.h>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MLE_UNIQUE_SSE2
+#include <emmintrin.h>
+#endif /* SSE2 */
+#if defined(__AVX2__)
+#define MLE_UNIQUE_AVX2
+#include <immintrin.h>
+#endif /* __AVX2__ */
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/mlArray.h"
+#include "mle/mlUnique.h"
+#include "mle/MleUnique.h"
+
+
+/**
+ * Typed versions of mlUnique(). They keep its semantics: the first
+ * occurrence of each value is kept, in the original order, and elements
+ * are only compared for equality. The element type and the equality test
+ * are template parameters, so the compares are inlined and elements are
+ * moved as whole values rather than by a byte count.
+ *
+ * Keys of 4, 8 or 16 bytes compared bit for bit, which includes integers,
+ * enumerations and pointers under the default std::equal_to, and any
+ * trivially copyable type under MleBitwiseEqual, are searched for with
+ * SSE2 or AVX2 compares where the compiler targets them. When more than
+ * MLE_UNIQUE_SCAN_LIMIT distinct keys have been found, the rest of the
+ * array is handed to MleUnique::hashBased(), so long lists stay linear.
+ * Other types are compared with each kept element in turn, as mlUnique()
+ * does.
+ */
+
+/**
+ * The number of distinct keys after which the typed mlUnique() stops
+ * scanning and switches to a hash table.
+ */
+#ifndef MLE_UNIQUE_SCAN_LIMIT
+#define MLE_UNIQUE_SCAN_LIMIT 32
+#endif /* MLE_UNIQUE_SCAN_LIMIT */
+
+
+/**
+ * @brief Compares values bit for bit. Suitable for trivially copyable
+ * types without padding, such as identifiers made of several integers.
+ */
+struct MleBitwiseEqual
+{
+    template <class T> bool operator()(const T &a, const T &b) const
+    { return memcmp(&a, &b, sizeof(T)) == 0; }
+};
+
+
+/**
+ * @brief Hashes values bit for bit, to go with MleBitwiseEqual.
+ */
+struct MleBitwiseHash
+{
+    template <class T> size_t operator()(const T &value) const
+    {
+        // FNV-1a over 8 byte words.
+        const MlUChar *bytes = (const MlUChar *) &value;
+        MlULong hash = 0xcbf29ce484222325ULL;
+        size_t i = 0;
+        for (; i + 8 <= sizeof(T); i += 8)
+		{
+            MlULong word;
+            memcpy(&word, bytes + i, 8);
+            hash = (hash ^ word) * 0x100000001b3ULL;
+        }
+        for (; i < sizeof(T); i++)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        return (size_t) (hash ^ (hash >> 32));
+    }
+};
+
+
+// The key size the bitwise scan can be used for, or 0.
+template <class T, class Equal> struct MleUniqueKeySize
+{
+    static const bool BITWISE =
+        (std::is_same<Equal, MleBitwiseEqual>::value && std::is_trivially_copyable<T>::value) ||
+        (std::is_same<Equal, std::equal_to<T> >::value &&
+         (std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value));
+    static const size_t value =
+        (BITWISE && ((sizeof(T) == 4) || (sizeof(T) == 8) || (sizeof(T) == 16))) ? sizeof(T) : 0;
+};
+
+
+// Searches keys of a fixed size for one equal bit for bit.
+template <size_t SIZE> struct MleUniqueKeyScan;
+
+template <> struct MleUniqueKeyScan<4>
+{
+    static bool contains(const MlUChar *keys, int count, const MlUChar *key)
+    {
+        unsigned int k;
+        memcpy(&k, key, 4);
+        int i = 0;
+#ifdef MLE_UNIQUE_AVX2
+        __m256i wide = _mm256_set1_epi32((int) k);
+        for (; i + 16 <= count; i += 16)
+		{
+            __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) (keys + i * 4)), wide);
+            __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) (keys + i * 4 + 32)), wide);
+            if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0)
+                return true;
+        }
+#endif /* MLE_UNIQUE_AVX2 */
+#ifdef MLE_UNIQUE_SSE2
+        __m128i narrow = _mm_set1_epi32((int) k);
+        for (; i + 8 <= count; i += 8)
+		{
+            __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (keys + i * 4)), narrow);
+            __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (keys + i * 4 + 16)), narrow);
+            if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0)
+                return true;
+        }
+#endif /* MLE_UNIQUE_SSE2 */
+        for (; i < count; i++)
+		{
+            unsigned int x;
+            memcpy(&x, keys + i * 4, 4);
+            if (x == k)
+                return true;
+        }
+        return false;
+    }
+};
+
+template <> struct MleUniqueKeyScan<8>
+{
+    static bool contains(const MlUChar *keys, int count, const MlUChar *key)
+    {
+        MlULong k;
+        memcpy(&k, key, 8);
+        int i = 0;
+#ifdef MLE_UNIQUE_AVX2
+        __m256i wide = _mm256_set1_epi64x((long long) k);
+        for (; i + 8 <= count; i += 8)
+		{
+            __m256i a = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (keys + i * 8)), wide);
+            __m256i b = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) (keys + i * 8 + 32)), wide);
+            if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0)
+                return true;
+        }
+#endif /* MLE_UNIQUE_AVX2 */
+#ifdef MLE_UNIQUE_SSE2
+        // SSE2 compares 32 bit lanes; a key matches when both of its halves do.
+        __m128i narrow = _mm_set1_epi64x((long long) k);
+        for (; i + 4 <= count; i += 4)
+		{
+            __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (keys + i * 8)), narrow);
+            __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (keys + i * 8 + 16)), narrow);
+            a = _mm_and_si128(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+            b = _mm_and_si128(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1)));
+            if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0)
+                return true;
+        }
+#endif /* MLE_UNIQUE_SSE2 */
+        for (; i < count; i++)
+		{
+            MlULong x;
+            memcpy(&x, keys + i * 8, 8);
+            if (x == k)
+                return true;
+        }
+        return false;
+    }
+};
+
+template <> struct MleUniqueKeyScan<16>
+{
+    static bool contains(const MlUChar *keys, int count, const MlUChar *key)
+    {
+        int i = 0;
+#ifdef MLE_UNIQUE_AVX2
+        // Two keys per vector; a key matches when all 16 of its bytes do.
+        __m128i single = _mm_loadu_si128((const __m128i *) key);
+        __m256i wide = _mm256_inserti128_si256(_mm256_castsi128_si256(single), single, 1);
+        for (; i + 2 <= count; i += 2)
+		{
+            unsigned int mask = (unsigned int) _mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (keys + i * 16)), wide));
+            if (((mask & 0xffff) == 0xffff) || ((mask >> 16) == 0xffff))
+                return true;
+        }
+#endif /* MLE_UNIQUE_AVX2 */
+#ifdef MLE_UNIQUE_SSE2
+        __m128i narrow = _mm_loadu_si128((const __m128i *) key);
+        for (; i < count; i++)
+		{
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (keys + i * 16)), narrow)) == 0xffff)
+                return true;
+        }
+#endif /* MLE_UNIQUE_SSE2 */
+        MlULong k[2];
+        memcpy(k, key, 16);
+        for (; i < count; i++)
+		{
+            MlULong x[2];
+            memcpy(x, keys + i * 16, 16);
+            if ((x[0] == k[0]) && (x[1] == k[1]))
+                return true;
+        }
+        return false;
+    }
+};
+
+
+// Removes duplicates by searching the keys kept so far.
+template <class T, class Equal, size_t KEY_SIZE = MleUniqueKeySize<T, Equal>::value> struct MleUniqueScan
+{
+    static int unique(T *data, int n, const Equal &)
+    {
+        const MlUChar *keys = (const MlUChar *) data;
+        MlBoolean hashing = TRUE;
+        int kept = 0;
+        for (int i = 0; i < n; i++)
+		{
+            if (MleUniqueKeyScan<KEY_SIZE>::contains(keys, kept, keys + (size_t) i * KEY_SIZE))
+                continue;
+            if (kept != i)
+                data[kept] = data[i];
+            kept++;
+
+            // Too many distinct keys to scan: bring the rest of the array
+            // down behind the ones kept and hash the lot.
+            if (hashing && (kept > MLE_UNIQUE_SCAN_LIMIT) && (i + 1 < n))
+			{
+                if (kept != i + 1)
+                    memmove((void *) (data + kept), (const void *) (data + i + 1), sizeof(T) * (size_t) (n - i - 1));
+                n = kept + n - i - 1;
+                i = kept - 1;
+
+                int count = MleUnique::hashBased(data, n, MleBitwiseHash(), MleBitwiseEqual());
+                if (count >= 0)
+                    return count;
+
+                // No memory for the table; carry on scanning.
+                hashing = FALSE;
+            }
+        }
+        return kept;
+    }
+};
+
+// Removes duplicates by comparing each element with those kept so far.
+template <class T, class Equal> struct MleUniqueScan<T, Equal, 0>
+{
+    static int unique(T *data, int n, const Equal &equal)
+    {
+        int kept = 0;
+        for (int i = 0; i < n; i++)
+		{
+            int j = 0;
+            while ((j < kept) && ! equal(data[j], data[i]))
+                j++;
+            if (j == kept)
+			{
+                if (kept != i)
+                    data[kept] = std::move(data[i]);
+                kept++;
+            }
+        }
+        return kept;
+    }
+};
+
+
+/**
+ * Remove duplicate elements from an array, keeping the first occurrence
+ * of each value in its original order.
+ *
+ * @param data The elements. Those kept are moved to the front.
+ * @param n The number of elements.
+ * @param equal The equality test, std::equal_to by default.
+ *
+ * @return The number of elements kept is returned.
+ */
+template <class T, class Equal> inline int
+mlUnique(T *data, int n, Equal equal)
+{
+    if (n <= 1)
+        return (n > 0) ? n : 0;
+    return MleUniqueScan<T, Equal>::unique(data, n, equal);
+}
+
+template <class T> inline int
+mlUnique(T *data, int n)
+{
+    return mlUnique(data, n, std::equal_to<T>());
+}
+
+/**
+ * Remove duplicate elements from an array, and shrink it to the elements
+ * kept.
+ */
+template <class T, class A, class Equal> inline int
+mlUnique(MleArray<T, A> &array, Equal equal)
+{
+    int count = mlUnique(array + 0, array.size(), equal);
+    array.resize(count);
+    return count;
+}
+
+template <class T, class A> inline int
+mlUnique(MleArray<T, A> &array)
+{
+    return mlUnique(array, std::equal_to<T>());
+}
+
+
+#endif /* __MLE_TYPEDUNIQUE_H_ */
@@ -52,8 +52,32 @@ extern "C" {
 #include "mle/mlTypes.h"
 #include "mle/MleUtil.h"
 
+/**
+ * Remove duplicate entries from an array, keeping the first occurrence of
+ * each value in its original order.
+ *
+ * @param ap The array. The entries kept are moved to the front.
+ * @param n The number of entries.
+ * @param size The size of an entry, in bytes.
+ * @param compare Returns zero if two entries are duplicates, and anything
+ * else if not. It is called on the calling thread only.
+ *
+ * @return The number of entries kept is returned.
+ */
 EXTERN MLE_UTIL_API int mlUnique(void *ap, int n, int size, int(*compare)(const void *, const void *));
 
+/**
+ * Remove duplicate entries from an array, as mlUnique() does, by sorting
+ * rather than comparing every pair. This is much faster for large arrays.
+ *
+ * @param compare Orders two entries, as for qsort(); entries are
+ * duplicates when it returns zero. The ordering must be consistent, and
+ * the function may be called from several threads at once.
+ *
+ * @return The number of entries kept is returned.
+ */
+EXTERN MLE_UTIL_API int mlUniqueOrdered(void *ap, int n, int size, int(*compare)(const void *, const void *));
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
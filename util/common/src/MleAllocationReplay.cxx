@@ -0,0 +1,429 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleAllocationReplay.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the allocation trace replay.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleAllocationReplay.h"
+#include "mle/MleRecordingMemoryManager.h"
+
+
+#define HEADER_SIZE     16
+
+// The resident set is also sampled when the requested bytes pass their last
+// sampled peak by this much.
+#define PEAK_SAMPLE_STEP    (1024 * 1024)
+
+#define NO_OBJECT       0xffffffff
+
+struct ReplayEvent
+{
+    MlULong size;
+    uint_t object;
+    MlByte operation;
+    MlByte shift;
+};
+
+struct MleReplayTrace
+{
+    // The requests that succeeded when recorded.
+    std::vector<ReplayEvent> events;
+
+    MlULong records;
+    MlULong failures;
+    uint_t numThreads;
+    uint_t numObjects;
+};
+
+
+// Read an unsigned LEB128 number. Returns FALSE if the data runs out first.
+static MlBoolean
+getNumber(const MlByte *&next, const MlByte *end, MlULong &value)
+{
+    value = 0;
+    for (uint_t shift = 0; next < end && shift < 64; shift += 7)
+	{
+        MlByte byte = *next++;
+        value |= (MlULong) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static MlResult
+decodeTrace(const MlByte *data, size_t length, MleReplayTrace *trace)
+{
+    if (length < HEADER_SIZE || memcmp(data, "MLETRACE", 8) != 0)
+        return MLE_E_FAIL;
+
+    uint_t version = 0;
+    for (uint_t i = 0; i < 4; i++)
+        version |= (uint_t) data[8 + i] << (8 * i);
+    if (version != MleRecordingMemoryManager::TRACE_VERSION)
+        return MLE_E_FAIL;
+
+    // Object numbers are handed out the same way as by the recorder.
+    std::vector<uint_t> freeObjects;
+    std::vector<bool> live;
+
+    const MlByte *next = data + HEADER_SIZE;
+    const MlByte *end = data + length;
+    while (next < end)
+	{
+        MlByte op = *next++;
+        uint_t operation = op & 0xf;
+        MlULong value;
+
+        if (op & MleRecordingMemoryManager::THREAD_FLAG)
+		{
+            if (! getNumber(next, end, value))
+                break;
+            if (value + 1 > trace->numThreads)
+                trace->numThreads = (uint_t) (value + 1);
+        }
+
+        ReplayEvent event;
+        event.object = NO_OBJECT;
+        event.operation = (MlByte) operation;
+        event.shift = 0;
+        event.size = 0;
+
+        MlBoolean allocates = (operation == MleRecordingMemoryManager::ALLOCATE) ||
+            (operation == MleRecordingMemoryManager::ALIGNED_ALLOCATE);
+        MlBoolean sized = allocates ||
+            (operation == MleRecordingMemoryManager::RESIZE) ||
+            (operation == MleRecordingMemoryManager::RESIZE_IN_PLACE);
+        if (operation < MleRecordingMemoryManager::ALLOCATE ||
+            operation > MleRecordingMemoryManager::ALIGNED_RELEASE)
+            return MLE_E_FAIL;
+
+        if (! allocates)
+		{
+            if (! getNumber(next, end, value))
+                break;
+            if (value >= live.size() || ! live[(size_t) value])
+                return MLE_E_FAIL;
+            event.object = (uint_t) value;
+        }
+        if (sized && ! getNumber(next, end, event.size))
+            break;
+        if (operation == MleRecordingMemoryManager::ALIGNED_ALLOCATE)
+		{
+            if (next == end)
+                break;
+            event.shift = *next++;
+            if (event.shift > 31)
+                return MLE_E_FAIL;
+        }
+
+        // The record is complete.
+        trace->records++;
+        if (op & MleRecordingMemoryManager::FAILED_FLAG)
+		{
+            trace->failures++;
+            continue;
+        }
+
+        if (allocates)
+		{
+            if (! freeObjects.empty())
+			{
+                event.object = freeObjects.back();
+                freeObjects.pop_back();
+            }
+            else
+			{
+                event.object = (uint_t) live.size();
+                live.push_back(false);
+            }
+            live[event.object] = true;
+        }
+        else if ((operation == MleRecordingMemoryManager::RELEASE) ||
+                 (operation == MleRecordingMemoryManager::ALIGNED_RELEASE))
+		{
+            live[event.object] = false;
+            freeObjects.push_back(event.object);
+        }
+        trace->events.push_back(event);
+    }
+
+    trace->numObjects = (uint_t) live.size();
+    return MLE_S_OK;
+}
+
+
+MleAllocationReplay::MleAllocationReplay()
+  : m_trace(NULL)
+{
+}
+
+
+MleAllocationReplay::~MleAllocationReplay()
+{
+    delete m_trace;
+}
+
+
+MlResult
+MleAllocationReplay::load(const char *filename)
+{
+    MLE_ASSERT(filename != NULL);
+
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+        return MLE_E_FAIL;
+
+    std::vector<MlByte> data;
+    MlByte buffer[64 * 1024];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + count);
+    MlBoolean readFailed = ferror(file) ? TRUE : FALSE;
+    fclose(file);
+    if (readFailed || data.empty())
+        return MLE_E_FAIL;
+
+    MleReplayTrace *trace = new MleReplayTrace();
+    trace->records = 0;
+    trace->failures = 0;
+    trace->numThreads = 0;
+    trace->numObjects = 0;
+    if (decodeTrace(&data[0], data.size(), trace) != MLE_S_OK)
+	{
+        delete trace;
+        return MLE_E_FAIL;
+    }
+
+    delete m_trace;
+    m_trace = trace;
+    return MLE_S_OK;
+}
+
+
+MlULong
+MleAllocationReplay::getRecordCount()
+{
+    return (m_trace != NULL) ? m_trace->records : 0;
+}
+
+
+MlULong
+MleAllocationReplay::getRecordedFailureCount()
+{
+    return (m_trace != NULL) ? m_trace->failures : 0;
+}
+
+
+uint_t
+MleAllocationReplay::getThreadCount()
+{
+    return (m_trace != NULL) ? m_trace->numThreads : 0;
+}
+
+
+uint_t
+MleAllocationReplay::getObjectCount()
+{
+    return (m_trace != NULL) ? m_trace->numObjects : 0;
+}
+
+
+MlResult
+MleAllocationReplay::run(MleMemoryManager *manager, MleReplayStats &stats,
+                         MlBoolean measureMemory)
+{
+    MLE_ASSERT(manager != NULL);
+
+    memset(&stats, 0, sizeof(stats));
+    if ((m_trace == NULL) || (manager == NULL))
+        return MLE_E_FAIL;
+
+    uint_t numObjects = m_trace->numObjects;
+    std::vector<void *> blocks(numObjects, (void *) NULL);
+    std::vector<MlByte> aligned(numObjects, 0);
+    std::vector<MlULong> requested(measureMemory ? numObjects : 0, 0);
+    std::vector<MlULong> usable(measureMemory ? numObjects : 0, 0);
+    MlULong requestedBytes = 0, usableBytes = 0;
+    MlULong usableAtPeak = 0, sampledPeak = 0;
+
+    if (measureMemory)
+	{
+        stats.m_baseResidentSize = MleMemoryManager::getResidentSize();
+        stats.m_peakResidentSize = stats.m_baseResidentSize;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < m_trace->events.size(); i++)
+	{
+        const ReplayEvent &event = m_trace->events[i];
+        void *&block = blocks[event.object];
+        MlResult result = MLE_S_OK;
+
+        switch (event.operation)
+		{
+          case MleRecordingMemoryManager::ALLOCATE:
+            block = NULL;
+            aligned[event.object] = 0;
+            if (event.size <= 0xffffffff)
+                result = manager->allocate(&block, (uint_t) event.size);
+            else
+                result = manager->allocateLarge(&block, event.size);
+            if (result != MLE_S_OK)
+                block = NULL;
+            break;
+
+          case MleRecordingMemoryManager::ALIGNED_ALLOCATE:
+            block = NULL;
+            aligned[event.object] = 1;
+            result = manager->allocateAligned(&block, event.size, (uint_t) 1 << event.shift);
+            if (result != MLE_S_OK)
+                block = NULL;
+            break;
+
+          case MleRecordingMemoryManager::RESIZE:
+            if (block == NULL)
+                continue;
+            if (event.size <= 0xffffffff)
+                result = manager->resize(&block, (uint_t) event.size);
+            else
+                result = manager->resizeLarge(&block, event.size);
+            break;
+
+          case MleRecordingMemoryManager::RESIZE_IN_PLACE:
+            if (block == NULL)
+                continue;
+            result = manager->tryResizeInPlace(block, event.size);
+            break;
+
+          case MleRecordingMemoryManager::RELEASE:
+          case MleRecordingMemoryManager::ALIGNED_RELEASE:
+            if (block == NULL)
+                continue;
+            if (aligned[event.object])
+                result = manager->releaseAligned(&block);
+            else
+                result = manager->release(&block);
+            block = NULL;
+            break;
+        }
+
+        stats.m_operations++;
+        if (result != MLE_S_OK)
+            stats.m_failures++;
+        if (! measureMemory)
+            continue;
+
+        // Charge the block at its new size; a failed resize leaves it as it was.
+        MlULong size = (result == MLE_S_OK) ? event.size : requested[event.object];
+        requestedBytes -= requested[event.object];
+        usableBytes -= usable[event.object];
+        requested[event.object] = 0;
+        usable[event.object] = 0;
+        if (block != NULL)
+		{
+            requested[event.object] = size;
+            size = manager->getUsableSize(block);
+            usable[event.object] = (size != 0) ? size : requested[event.object];
+            requestedBytes += requested[event.object];
+            usableBytes += usable[event.object];
+        }
+
+        if (usableBytes > stats.m_peakUsableBytes)
+            stats.m_peakUsableBytes = usableBytes;
+        if (requestedBytes > stats.m_peakRequestedBytes)
+		{
+            stats.m_peakRequestedBytes = requestedBytes;
+            usableAtPeak = usableBytes;
+        }
+        if ((stats.m_operations % RESIDENT_SAMPLE_INTERVAL == 0) ||
+            (stats.m_peakRequestedBytes >= sampledPeak + PEAK_SAMPLE_STEP))
+		{
+            MlULong resident = MleMemoryManager::getResidentSize();
+            if (resident > stats.m_peakResidentSize)
+                stats.m_peakResidentSize = resident;
+            sampledPeak = stats.m_peakRequestedBytes;
+        }
+    }
+
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+    stats.m_elapsedNanoseconds = (MlULong)
+        std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count();
+    if (stats.m_operations != 0)
+        stats.m_nanosecondsPerOperation =
+            (double) stats.m_elapsedNanoseconds / (double) stats.m_operations;
+
+    if (measureMemory)
+	{
+        MlULong resident = MleMemoryManager::getResidentSize();
+        if (resident > stats.m_peakResidentSize)
+            stats.m_peakResidentSize = resident;
+
+        if (usableAtPeak != 0)
+            stats.m_internalFragmentation =
+                1.0 - (double) stats.m_peakRequestedBytes / (double) usableAtPeak;
+        MlULong growth = stats.m_peakResidentSize - stats.m_baseResidentSize;
+        if (growth > stats.m_peakUsableBytes)
+            stats.m_externalFragmentation =
+                1.0 - (double) stats.m_peakUsableBytes / (double) growth;
+    }
+
+    // Release what the trace left live.
+    for (uint_t object = 0; object < numObjects; object++)
+	{
+        if (blocks[object] == NULL)
+            continue;
+        if (aligned[object])
+            manager->releaseAligned(&blocks[object]);
+        else
+            manager->release(&blocks[object]);
+    }
+
+    return MLE_S_OK;
+}
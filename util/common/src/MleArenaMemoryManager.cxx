@@ -0,0 +1,359 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleArenaMemoryManager.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the arena memory manager.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleArenaMemoryManager.h"
+
+
+// Every allocation is preceded by its size. Chunk data starts 8 bytes
+// past a 16 byte boundary and slots are multiples of 16 bytes, so each
+// payload keeps the platform alignment.
+#define SIZE_HEADER 8
+#define CHUNK_HEADER (16 + SIZE_HEADER)
+#define MAX_SLOT 0x7fffffff
+
+struct MleArenaMemoryManager::Chunk
+{
+    Chunk *prev;     // The chunk allocated before this one.
+    uint_t size;     // Bytes of data following the header.
+    uint_t used;     // Bytes of data handed out.
+};
+
+
+static inline MlChar *
+chunkData(void *chunk, uint_t offset)
+{
+    return (MlChar *) chunk + CHUNK_HEADER + offset;
+}
+
+static inline MlULong
+slotSize(MlULong size)
+{
+    return (size + SIZE_HEADER + 15) & ~((MlULong) 15);
+}
+
+
+MleArenaMemoryManager::MleArenaMemoryManager(uint_t chunkSize)
+  : m_current(NULL),
+    m_spare(NULL),
+    m_last(NULL),
+    m_chunkSize(chunkSize),
+    m_reserved(0)
+{
+    static_assert(sizeof(Chunk) <= CHUNK_HEADER - SIZE_HEADER, "chunk header too large");
+
+    if (m_chunkSize < 1024)
+        m_chunkSize = 1024;
+}
+
+
+MleArenaMemoryManager::~MleArenaMemoryManager()
+{
+    releaseChunks(NULL);
+    if (m_spare != NULL)
+	{
+        void *memory = m_spare;
+        MleMemoryManager::release(&memory);
+    }
+}
+
+
+MleArenaMemoryManager::Chunk *
+MleArenaMemoryManager::addChunk(uint_t size)
+{
+    Chunk *chunk = NULL;
+
+    if ((m_spare != NULL) && (size <= m_spare->size))
+	{
+        chunk = m_spare;
+        m_spare = NULL;
+    }
+    else
+	{
+        MlULong total = CHUNK_HEADER + size;
+        if (total < m_chunkSize)
+            total = m_chunkSize;
+        if (total > MAX_SLOT)
+            return NULL;
+
+        void *memory;
+        if (MleMemoryManager::allocate(&memory, (uint_t) total) != MLE_S_OK)
+            return NULL;
+
+        chunk = (Chunk *) memory;
+        chunk->size = (uint_t) (total - CHUNK_HEADER);
+        m_reserved += total;
+    }
+
+    chunk->prev = m_current;
+    chunk->used = 0;
+    m_current = chunk;
+
+    return chunk;
+}
+
+
+void
+MleArenaMemoryManager::releaseChunks(Chunk *last)
+{
+    while ((m_current != NULL) && (m_current != last))
+	{
+        Chunk *chunk = m_current;
+        m_current = chunk->prev;
+
+        // Keep one chunk of the default size for the next phase.
+        if ((m_spare == NULL) && (chunk->size + CHUNK_HEADER == m_chunkSize))
+		{
+            m_spare = chunk;
+        }
+        else
+		{
+            m_reserved -= chunk->size + CHUNK_HEADER;
+            void *memory = chunk;
+            MleMemoryManager::release(&memory);
+        }
+    }
+}
+
+
+MlResult
+MleArenaMemoryManager::allocate(void **memory, uint_t size)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if (! allocationAllowed())
+        return MLE_E_FAIL;
+
+    MlULong slot = slotSize(size);
+    if (slot > MAX_SLOT)
+        return MLE_E_FAIL;
+
+    if ((m_current == NULL) || (m_current->used + slot > m_current->size))
+	{
+        if (addChunk((uint_t) slot) == NULL)
+            return MLE_E_FAIL;
+    }
+
+    MlChar *header = chunkData(m_current, m_current->used);
+    *(MlULong *) header = size;
+    m_current->used += (uint_t) slot;
+
+    m_last = header + SIZE_HEADER;
+    *memory = m_last;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleArenaMemoryManager::resize(void **memory, uint_t newSize)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if ((memory == NULL) || (*memory == NULL))
+        return MLE_E_FAIL;
+
+    MlChar *header = (MlChar *) *memory - SIZE_HEADER;
+    MlULong oldSize = *(MlULong *) header;
+
+    // The most recent allocation can grow or shrink in place.
+    if (*memory == m_last)
+	{
+        uint_t offset = (uint_t) (header - chunkData(m_current, 0));
+        if (offset + slotSize(newSize) <= m_current->size)
+		{
+            if (! allocationAllowed())
+                return MLE_E_FAIL;
+            return tryResizeInPlace(*memory, newSize);
+        }
+    }
+
+    void *newMemory;
+    if (allocate(&newMemory, newSize) != MLE_S_OK)
+        return MLE_E_FAIL;
+    memcpy(newMemory, *memory, (size_t) ((oldSize < newSize) ? oldSize : newSize));
+    *memory = newMemory;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleArenaMemoryManager::release(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if ((memory == NULL) || (*memory == NULL))
+        return MLE_E_FAIL;
+
+    // Only the most recent allocation can be given back before a rewind.
+    if (*memory == m_last)
+	{
+        m_current->used = (uint_t) ((MlChar *) m_last - SIZE_HEADER - chunkData(m_current, 0));
+        m_last = NULL;
+    }
+
+    *memory = NULL;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleArenaMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    if ((memory == NULL) || (newSize > MAX_SLOT))
+        return MLE_E_FAIL;
+
+    MlChar *header = (MlChar *) memory - SIZE_HEADER;
+    MlULong slot = slotSize(newSize);
+
+    if (memory == m_last)
+	{
+        uint_t offset = (uint_t) (header - chunkData(m_current, 0));
+        if (offset + slot > m_current->size)
+            return MLE_E_FAIL;
+        m_current->used = (uint_t) (offset + slot);
+    }
+    else if (slot > slotSize(*(MlULong *) header))
+	{
+        return MLE_E_FAIL;
+    }
+
+    *(MlULong *) header = newSize;
+    return MLE_S_OK;
+}
+
+
+MlULong
+MleArenaMemoryManager::getUsableSize(void *memory)
+{
+    if (memory == NULL)
+        return 0;
+
+    MlChar *header = (MlChar *) memory - SIZE_HEADER;
+    return slotSize(*(MlULong *) header) - SIZE_HEADER;
+}
+
+
+MlResult
+MleArenaMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    if (size > MAX_SLOT)
+        return MLE_E_FAIL;
+
+    return allocate(memory, (uint_t) size);
+}
+
+
+MlResult
+MleArenaMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    if (newSize > MAX_SLOT)
+        return MLE_E_FAIL;
+
+    return resize(memory, (uint_t) newSize);
+}
+
+
+MleArenaMemoryManager::Marker
+MleArenaMemoryManager::getMarker() const
+{
+    Marker marker;
+
+    marker.m_chunk = m_current;
+    marker.m_offset = (m_current != NULL) ? m_current->used : 0;
+
+    return marker;
+}
+
+
+void
+MleArenaMemoryManager::rewind(const Marker &marker)
+{
+    releaseChunks((Chunk *) marker.m_chunk);
+    if (m_current != NULL)
+	{
+        MLE_ASSERT(m_current == marker.m_chunk);
+        MLE_ASSERT(marker.m_offset <= m_current->used);
+        m_current->used = marker.m_offset;
+    }
+    m_last = NULL;
+}
+
+
+void
+MleArenaMemoryManager::reset()
+{
+    Chunk *first = m_current;
+    while ((first != NULL) && (first->prev != NULL))
+        first = first->prev;
+
+    releaseChunks(first);
+    if (m_current != NULL)
+        m_current->used = 0;
+    m_last = NULL;
+}
+
+
+MlULong
+MleArenaMemoryManager::getAllocatedSize() const
+{
+    MlULong size = 0;
+
+    for (Chunk *chunk = m_current; chunk != NULL; chunk = chunk->prev)
+        size += chunk->used;
+
+    return size;
+}
+
+
+MlULong
+MleArenaMemoryManager::getReservedSize() const
+{
+    return m_reserved;
+}
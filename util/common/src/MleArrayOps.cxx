@@ -0,0 +1,515 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleArrayOps.cxx
+ *  @ingroup MleCore
+ *
+ *  Vectorized bulk operations on arrays, with the instruction set
+ *  picked at run time.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MLE_ARRAY_OPS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+#endif /* x86 */
+
+// Include Magic Lantern header files.
+#include "mle/MleArrayOps.h"
+
+#define MLE_INSTRUCTION_SET "MleInstructionSet"
+
+
+//
+// The operations of one instruction set for one element type.
+//
+template <class T> struct MleArrayKernels
+{
+    void (*fill)(T *data, T value, size_t count);
+    size_t (*find)(const T *data, size_t count, T value);
+    void (*minMax)(const T *data, size_t count, T *minimum, T *maximum);
+    T (*sum)(const T *data, size_t count);
+    void (*scale)(T *data, T factor, size_t count);
+    void (*add)(T *to, const T *from, size_t count);
+    void (*axpy)(T *y, T a, const T *x, size_t count);
+    size_t (*compare)(const T *a, const T *b, size_t count);
+};
+
+
+//
+// Scalar arithmetic for the loop tails. Arithmetic on int is done unsigned
+// so that it wraps around like the vector instructions do.
+//
+template <class T> struct Arithmetic
+{
+    static T add(T a, T b) { return a + b; }
+    static T mul(T a, T b) { return a * b; }
+};
+
+template <> struct Arithmetic<int>
+{
+    static int add(int a, int b) { return (int) ((unsigned int) a + (unsigned int) b); }
+    static int mul(int a, int b) { return (int) ((unsigned int) a * (unsigned int) b); }
+};
+
+
+static inline uint_t
+lowestBit(uint_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (uint_t) index;
+#else
+    return (uint_t) __builtin_ctz(mask);
+#endif /* _MSC_VER */
+}
+
+
+#if defined(_MSC_VER)
+#define MLE_TARGET(isa)
+#else
+#define MLE_TARGET(isa) __attribute__((target(isa)))
+#endif /* _MSC_VER */
+
+
+//
+// Scalar versions, used where no vector instructions are available.
+//
+namespace scalar {
+
+template <class T> struct Plain
+{
+    typedef T Scalar;
+    typedef T Vec;
+    static const size_t WIDTH = 1;
+    static Vec load(const T *p) { return *p; }
+    static void store(T *p, Vec v) { *p = v; }
+    static Vec set1(T v) { return v; }
+    static Vec add(Vec a, Vec b) { return Arithmetic<T>::add(a, b); }
+    static Vec mul(Vec a, Vec b) { return Arithmetic<T>::mul(a, b); }
+    static Vec mulAdd(Vec a, Vec b, Vec c) { return Arithmetic<T>::add(Arithmetic<T>::mul(a, b), c); }
+    static Vec min(Vec a, Vec b) { return (b < a) ? b : a; }
+    static Vec max(Vec a, Vec b) { return (b > a) ? b : a; }
+    static uint_t equal(Vec a, Vec b) { return (a == b) ? 1 : 0; }
+};
+
+typedef Plain<float> Float;
+typedef Plain<double> Double;
+typedef Plain<int> Int;
+
+#define MLE_SIMD_TARGET
+#include "MleArrayOpsKernels.h"
+#undef MLE_SIMD_TARGET
+
+} /* namespace scalar */
+
+
+#ifdef MLE_ARRAY_OPS_X86
+
+//
+// SSE2 versions, 128 bit vectors.
+//
+namespace sse2 {
+
+#define MLE_SIMD_TARGET MLE_TARGET("sse2")
+
+struct Float
+{
+    typedef float Scalar;
+    typedef __m128 Vec;
+    static const size_t WIDTH = 4;
+    MLE_SIMD_TARGET static inline Vec load(const float *p) { return _mm_loadu_ps(p); }
+    MLE_SIMD_TARGET static inline void store(float *p, Vec v) { _mm_storeu_ps(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(float v) { return _mm_set1_ps(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b) { return (uint_t) _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+};
+
+struct Double
+{
+    typedef double Scalar;
+    typedef __m128d Vec;
+    static const size_t WIDTH = 2;
+    MLE_SIMD_TARGET static inline Vec load(const double *p) { return _mm_loadu_pd(p); }
+    MLE_SIMD_TARGET static inline void store(double *p, Vec v) { _mm_storeu_pd(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(double v) { return _mm_set1_pd(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b) { return (uint_t) _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+};
+
+struct Int
+{
+    typedef int Scalar;
+    typedef __m128i Vec;
+    static const size_t WIDTH = 4;
+    MLE_SIMD_TARGET static inline Vec load(const int *p) { return _mm_loadu_si128((const __m128i *) p); }
+    MLE_SIMD_TARGET static inline void store(int *p, Vec v) { _mm_storeu_si128((__m128i *) p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(int v) { return _mm_set1_epi32(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b)
+    {
+        // SSE2 has no 32 bit multiply; multiply the even and odd elements
+        // separately and interleave the low halves of the products.
+        Vec even = _mm_mul_epu32(a, b);
+        Vec odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm_add_epi32(mul(a, b), c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b)
+    {
+        Vec greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+    }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b)
+    {
+        Vec greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+    }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b)
+    { return (uint_t) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+};
+
+#include "MleArrayOpsKernels.h"
+#undef MLE_SIMD_TARGET
+
+} /* namespace sse2 */
+
+
+//
+// AVX2 versions, 256 bit vectors with fused multiply-add.
+//
+namespace avx2 {
+
+#define MLE_SIMD_TARGET MLE_TARGET("avx2,fma")
+
+struct Float
+{
+    typedef float Scalar;
+    typedef __m256 Vec;
+    static const size_t WIDTH = 8;
+    MLE_SIMD_TARGET static inline Vec load(const float *p) { return _mm256_loadu_ps(p); }
+    MLE_SIMD_TARGET static inline void store(float *p, Vec v) { _mm256_storeu_ps(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(float v) { return _mm256_set1_ps(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b)
+    { return (uint_t) _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+};
+
+struct Double
+{
+    typedef double Scalar;
+    typedef __m256d Vec;
+    static const size_t WIDTH = 4;
+    MLE_SIMD_TARGET static inline Vec load(const double *p) { return _mm256_loadu_pd(p); }
+    MLE_SIMD_TARGET static inline void store(double *p, Vec v) { _mm256_storeu_pd(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(double v) { return _mm256_set1_pd(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b)
+    { return (uint_t) _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+};
+
+struct Int
+{
+    typedef int Scalar;
+    typedef __m256i Vec;
+    static const size_t WIDTH = 8;
+    MLE_SIMD_TARGET static inline Vec load(const int *p) { return _mm256_loadu_si256((const __m256i *) p); }
+    MLE_SIMD_TARGET static inline void store(int *p, Vec v) { _mm256_storeu_si256((__m256i *) p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(int v) { return _mm256_set1_epi32(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm256_mullo_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b)
+    { return (uint_t) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+};
+
+#include "MleArrayOpsKernels.h"
+#undef MLE_SIMD_TARGET
+
+} /* namespace avx2 */
+
+
+//
+// AVX-512 versions, 512 bit vectors.
+//
+namespace avx512 {
+
+#define MLE_SIMD_TARGET MLE_TARGET("avx512f")
+
+struct Float
+{
+    typedef float Scalar;
+    typedef __m512 Vec;
+    static const size_t WIDTH = 16;
+    MLE_SIMD_TARGET static inline Vec load(const float *p) { return _mm512_loadu_ps(p); }
+    MLE_SIMD_TARGET static inline void store(float *p, Vec v) { _mm512_storeu_ps(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(float v) { return _mm512_set1_ps(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm512_max_ps(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b) { return (uint_t) _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+};
+
+struct Double
+{
+    typedef double Scalar;
+    typedef __m512d Vec;
+    static const size_t WIDTH = 8;
+    MLE_SIMD_TARGET static inline Vec load(const double *p) { return _mm512_loadu_pd(p); }
+    MLE_SIMD_TARGET static inline void store(double *p, Vec v) { _mm512_storeu_pd(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(double v) { return _mm512_set1_pd(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm512_max_pd(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b) { return (uint_t) _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+};
+
+struct Int
+{
+    typedef int Scalar;
+    typedef __m512i Vec;
+    static const size_t WIDTH = 16;
+    MLE_SIMD_TARGET static inline Vec load(const int *p) { return _mm512_loadu_si512(p); }
+    MLE_SIMD_TARGET static inline void store(int *p, Vec v) { _mm512_storeu_si512(p, v); }
+    MLE_SIMD_TARGET static inline Vec set1(int v) { return _mm512_set1_epi32(v); }
+    MLE_SIMD_TARGET static inline Vec add(Vec a, Vec b) { return _mm512_add_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec mul(Vec a, Vec b) { return _mm512_mullo_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec mulAdd(Vec a, Vec b, Vec c) { return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c); }
+    MLE_SIMD_TARGET static inline Vec min(Vec a, Vec b) { return _mm512_min_epi32(a, b); }
+    MLE_SIMD_TARGET static inline Vec max(Vec a, Vec b) { return _mm512_max_epi32(a, b); }
+    MLE_SIMD_TARGET static inline uint_t equal(Vec a, Vec b) { return (uint_t) _mm512_cmpeq_epi32_mask(a, b); }
+};
+
+#include "MleArrayOpsKernels.h"
+#undef MLE_SIMD_TARGET
+
+} /* namespace avx512 */
+
+#endif /* MLE_ARRAY_OPS_X86 */
+
+
+// The kernels of every instruction set, indexed by MleArrayOps::InstructionSet.
+#ifdef MLE_ARRAY_OPS_X86
+#define MLE_KERNEL_TABLE(type) \
+    { scalar::getKernels<scalar::type>(), sse2::getKernels<sse2::type>(), \
+      avx2::getKernels<avx2::type>(), avx512::getKernels<avx512::type>() }
+#else
+#define MLE_KERNEL_TABLE(type) \
+    { scalar::getKernels<scalar::type>() }
+#endif /* MLE_ARRAY_OPS_X86 */
+
+static const MleArrayKernels<float> g_floatKernels[] = MLE_KERNEL_TABLE(Float);
+static const MleArrayKernels<double> g_doubleKernels[] = MLE_KERNEL_TABLE(Double);
+static const MleArrayKernels<int> g_intKernels[] = MLE_KERNEL_TABLE(Int);
+
+// The instruction set in use, or -1 before the first operation.
+static std::atomic<int> g_instructionSet(-1);
+
+static const char *g_instructionSetNames[] = { "scalar", "sse2", "avx2", "avx512" };
+
+
+static MleArrayOps::InstructionSet
+detectInstructionSet()
+{
+#if defined(MLE_ARRAY_OPS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    MlBoolean sse2 = (info[3] & (1 << 26)) != 0;
+    MlBoolean osxsave = (info[2] & (1 << 27)) != 0;
+    MlBoolean fma = (info[2] & (1 << 12)) != 0;
+    if (! sse2)
+        return MleArrayOps::SCALAR;
+    if (! osxsave || (maxLeaf < 7))
+        return MleArrayOps::SSE2;
+
+    // The operating system must save the vector registers too.
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if (((info[1] & (1 << 16)) != 0) && ((xcr0 & 0xe6) == 0xe6))
+        return MleArrayOps::AVX512;
+    if (((info[1] & (1 << 5)) != 0) && fma && ((xcr0 & 0x6) == 0x6))
+        return MleArrayOps::AVX2;
+    return MleArrayOps::SSE2;
+#elif defined(MLE_ARRAY_OPS_X86)
+    // These checks include the operating system support for the registers.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return MleArrayOps::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return MleArrayOps::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return MleArrayOps::SSE2;
+    return MleArrayOps::SCALAR;
+#else
+    return MleArrayOps::SCALAR;
+#endif
+}
+
+
+static inline int
+currentInstructionSet()
+{
+    int instructionSet = g_instructionSet.load(std::memory_order_relaxed);
+    if (instructionSet < 0)
+	{
+        instructionSet = MleArrayOps::getSupportedInstructionSet();
+
+        const char *name = getenv(MLE_INSTRUCTION_SET);
+        if (name != NULL)
+		{
+            for (int i = 0; i < instructionSet; i++)
+			{
+                if (strcmp(name, g_instructionSetNames[i]) == 0)
+                    instructionSet = i;
+            }
+        }
+
+        // Every thread arrives at the same answer, so a race is harmless,
+        // but a choice made with setInstructionSet() is left alone.
+        int unset = -1;
+        if (! g_instructionSet.compare_exchange_strong(unset, instructionSet))
+            instructionSet = unset;
+    }
+    return instructionSet;
+}
+
+
+MleArrayOps::InstructionSet
+MleArrayOps::getInstructionSet()
+{
+    return (InstructionSet) currentInstructionSet();
+}
+
+
+MleArrayOps::InstructionSet
+MleArrayOps::getSupportedInstructionSet()
+{
+    static const InstructionSet supported = detectInstructionSet();
+    return supported;
+}
+
+
+MleArrayOps::InstructionSet
+MleArrayOps::setInstructionSet(InstructionSet instructionSet)
+{
+    InstructionSet supported = getSupportedInstructionSet();
+    if ((instructionSet < SCALAR) || (instructionSet > supported))
+        instructionSet = supported;
+    g_instructionSet.store(instructionSet);
+    return instructionSet;
+}
+
+
+const char *
+MleArrayOps::getInstructionSetName(InstructionSet instructionSet)
+{
+    if ((instructionSet < SCALAR) || (instructionSet > AVX512))
+        return "unknown";
+    return g_instructionSetNames[instructionSet];
+}
+
+
+//
+// The public operations pick the kernels of the current instruction set.
+//
+#define MLE_ARRAY_OPS(T, kernels) \
+void MleArrayOps::fill(T *data, T value, size_t count) \
+{ kernels[currentInstructionSet()].fill(data, value, count); } \
+\
+void MleArrayOps::copy(T *to, const T *from, size_t count) \
+{ if (count > 0) memcpy(to, from, count * sizeof(T)); } \
+\
+size_t MleArrayOps::find(const T *data, size_t count, T value) \
+{ return kernels[currentInstructionSet()].find(data, count, value); } \
+\
+MlBoolean MleArrayOps::minMax(const T *data, size_t count, T &minimum, T &maximum) \
+{ \
+    if (count == 0) \
+        return FALSE; \
+    kernels[currentInstructionSet()].minMax(data, count, &minimum, &maximum); \
+    return TRUE; \
+} \
+\
+T MleArrayOps::sum(const T *data, size_t count) \
+{ return kernels[currentInstructionSet()].sum(data, count); } \
+\
+void MleArrayOps::scale(T *data, T factor, size_t count) \
+{ kernels[currentInstructionSet()].scale(data, factor, count); } \
+\
+void MleArrayOps::add(T *to, const T *from, size_t count) \
+{ kernels[currentInstructionSet()].add(to, from, count); } \
+\
+void MleArrayOps::axpy(T *y, T a, const T *x, size_t count) \
+{ kernels[currentInstructionSet()].axpy(y, a, x, count); } \
+\
+size_t MleArrayOps::compare(const T *a, const T *b, size_t count) \
+{ return kernels[currentInstructionSet()].compare(a, b, count); }
+
+MLE_ARRAY_OPS(float, g_floatKernels)
+MLE_ARRAY_OPS(double, g_doubleKernels)
+MLE_ARRAY_OPS(int, g_intKernels)
@@ -0,0 +1,244 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleArrayOpsKernels.h
+ *  @ingroup MleCore
+ *
+ *  Kernels of the bulk array operations, written against a vector traits
+ *  class. MleArrayOps.cxx includes this file once per instruction set, in a
+ *  namespace of its own and with MLE_SIMD_TARGET naming the instruction set
+ *  to compile for.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// No include guard; this file is meant to be included more than once.
+
+//
+// The traits class V supplies
+//
+//     Scalar, Vec          the element and vector types
+//     WIDTH                the number of elements in a vector
+//     load, store          unaligned vector access
+//     set1                 a vector with every element set to a value
+//     add, mul, min, max   element by element arithmetic
+//     mulAdd(a, b, c)      a * b + c, fused where the instruction set can
+//     equal(a, b)          a bit mask of the elements that are equal
+//
+// The main loops work on four vectors at a time so that the accumulations
+// do not wait on each other.
+//
+
+template <class V> MLE_SIMD_TARGET static void
+fill(typename V::Scalar *data, typename V::Scalar value, size_t count)
+{
+    typename V::Vec v = V::set1(value);
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+        V::store(data + i, v);
+    for (; i < count; i++)
+        data[i] = value;
+}
+
+
+template <class V> MLE_SIMD_TARGET static size_t
+find(const typename V::Scalar *data, size_t count, typename V::Scalar value)
+{
+    typename V::Vec v = V::set1(value);
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+	{
+        uint_t mask = V::equal(V::load(data + i), v);
+        if (mask != 0)
+            return i + lowestBit(mask);
+    }
+    for (; i < count; i++)
+	{
+        if (data[i] == value)
+            return i;
+    }
+    return count;
+}
+
+
+template <class V> MLE_SIMD_TARGET static void
+minMax(const typename V::Scalar *data, size_t count, typename V::Scalar *minimum, typename V::Scalar *maximum)
+{
+    typedef typename V::Scalar T;
+    typedef typename V::Vec Vec;
+
+    T low = data[0];
+    T high = data[0];
+    size_t i = 0;
+    if (count >= 4 * V::WIDTH)
+	{
+        Vec low0 = V::load(data), low1 = low0, low2 = low0, low3 = low0;
+        Vec high0 = low0, high1 = low0, high2 = low0, high3 = low0;
+        for (; i + 4 * V::WIDTH <= count; i += 4 * V::WIDTH)
+		{
+            Vec x0 = V::load(data + i);
+            Vec x1 = V::load(data + i + V::WIDTH);
+            Vec x2 = V::load(data + i + 2 * V::WIDTH);
+            Vec x3 = V::load(data + i + 3 * V::WIDTH);
+            low0 = V::min(low0, x0);
+            low1 = V::min(low1, x1);
+            low2 = V::min(low2, x2);
+            low3 = V::min(low3, x3);
+            high0 = V::max(high0, x0);
+            high1 = V::max(high1, x1);
+            high2 = V::max(high2, x2);
+            high3 = V::max(high3, x3);
+        }
+
+        T lanes[V::WIDTH];
+        V::store(lanes, V::min(V::min(low0, low1), V::min(low2, low3)));
+        for (size_t j = 0; j < V::WIDTH; j++)
+            low = (lanes[j] < low) ? lanes[j] : low;
+        V::store(lanes, V::max(V::max(high0, high1), V::max(high2, high3)));
+        for (size_t j = 0; j < V::WIDTH; j++)
+            high = (lanes[j] > high) ? lanes[j] : high;
+    }
+    for (; i < count; i++)
+	{
+        low = (data[i] < low) ? data[i] : low;
+        high = (data[i] > high) ? data[i] : high;
+    }
+
+    *minimum = low;
+    *maximum = high;
+}
+
+
+template <class V> MLE_SIMD_TARGET static typename V::Scalar
+sum(const typename V::Scalar *data, size_t count)
+{
+    typedef typename V::Scalar T;
+    typedef typename V::Vec Vec;
+
+    T total = 0;
+    size_t i = 0;
+    if (count >= 4 * V::WIDTH)
+	{
+        Vec sum0 = V::set1(0), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+        for (; i + 4 * V::WIDTH <= count; i += 4 * V::WIDTH)
+		{
+            sum0 = V::add(sum0, V::load(data + i));
+            sum1 = V::add(sum1, V::load(data + i + V::WIDTH));
+            sum2 = V::add(sum2, V::load(data + i + 2 * V::WIDTH));
+            sum3 = V::add(sum3, V::load(data + i + 3 * V::WIDTH));
+        }
+
+        T lanes[V::WIDTH];
+        V::store(lanes, V::add(V::add(sum0, sum1), V::add(sum2, sum3)));
+        for (size_t j = 0; j < V::WIDTH; j++)
+            total = Arithmetic<T>::add(total, lanes[j]);
+    }
+    for (; i < count; i++)
+        total = Arithmetic<T>::add(total, data[i]);
+
+    return total;
+}
+
+
+template <class V> MLE_SIMD_TARGET static void
+scale(typename V::Scalar *data, typename V::Scalar factor, size_t count)
+{
+    typedef typename V::Scalar T;
+
+    typename V::Vec f = V::set1(factor);
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+        V::store(data + i, V::mul(V::load(data + i), f));
+    for (; i < count; i++)
+        data[i] = Arithmetic<T>::mul(data[i], factor);
+}
+
+
+template <class V> MLE_SIMD_TARGET static void
+add(typename V::Scalar *to, const typename V::Scalar *from, size_t count)
+{
+    typedef typename V::Scalar T;
+
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+        V::store(to + i, V::add(V::load(to + i), V::load(from + i)));
+    for (; i < count; i++)
+        to[i] = Arithmetic<T>::add(to[i], from[i]);
+}
+
+
+template <class V> MLE_SIMD_TARGET static void
+axpy(typename V::Scalar *y, typename V::Scalar a, const typename V::Scalar *x, size_t count)
+{
+    typedef typename V::Scalar T;
+
+    typename V::Vec va = V::set1(a);
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+        V::store(y + i, V::mulAdd(va, V::load(x + i), V::load(y + i)));
+    for (; i < count; i++)
+        y[i] = Arithmetic<T>::add(y[i], Arithmetic<T>::mul(a, x[i]));
+}
+
+
+template <class V> MLE_SIMD_TARGET static size_t
+compare(const typename V::Scalar *a, const typename V::Scalar *b, size_t count)
+{
+    const uint_t all = (uint_t) ((1ull << V::WIDTH) - 1);
+    size_t i = 0;
+    for (; i + V::WIDTH <= count; i += V::WIDTH)
+	{
+        uint_t mask = V::equal(V::load(a + i), V::load(b + i));
+        if (mask != all)
+            return i + lowestBit(~mask & all);
+    }
+    for (; i < count; i++)
+	{
+        if (! (a[i] == b[i]))
+            return i;
+    }
+    return count;
+}
+
+
+// Evaluated at compile time, so the tables are ready before any static
+// constructor runs.
+template <class V> static constexpr MleArrayKernels<typename V::Scalar>
+getKernels()
+{
+    return MleArrayKernels<typename V::Scalar>
+	{
+        fill<V>, find<V>, minMax<V>, sum<V>, scale<V>, add<V>, axpy<V>, compare<V>
+    };
+}
@@ -0,0 +1,288 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleAtom.cxx
+ *  @ingroup MleCore
+ *
+ *  String interning for the Magic Lantern runtime.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+// Include Magic Lantern header files.
+#include "mle/MleAtom.h"
+#include "mle/MleArenaMemoryManager.h"
+#include "mle/mlConcurrentArray.h"
+#include "mle/mlMalloc.h"
+
+// The capacity of the first index; a power of two.
+#define MIN_INDEX_CAPACITY 1024
+
+// The longest string that can be interned.
+#define MAX_ATOM_LENGTH (1u << 30)
+
+
+//
+// An open addressing index from strings to ids. Each slot holds the upper
+// half of the string's hash and its id, with 0 marking an empty slot, so
+// most probes are settled without touching the entry. Slots are only ever
+// filled, never cleared, which is what lets readers probe without a lock.
+//
+struct AtomIndex
+{
+    uint_t capacity;                  // The number of slots, a power of two.
+    uint_t count;                     // The number of slots filled; changed under the lock.
+    AtomIndex *retired;               // The index this one replaced.
+    std::atomic<MlULong> slots[1];    // The slots.
+};
+
+
+//
+// The application wide atom table. Interning takes the lock; lookups read
+// the current index and the entries without it. An index that is replaced
+// when the table grows may still be probed by a reader, so it is kept
+// rather than released.
+//
+struct AtomTable
+{
+    std::mutex lock;
+    std::atomic<AtomIndex *> index;
+    MleArenaMemoryManager arena;                       // Holds the entries.
+    MleConcurrentArray<const MleAtomEntry *> entries;  // The entries by id, less one.
+};
+
+
+const MleAtomEntry MleAtom::s_null = { 0, 0, 0, { '\0' } };
+
+
+static AtomTable *
+getTable()
+{
+    // The table is never destroyed, so atoms stay valid while static
+    // objects are being destroyed.
+    static AtomTable *table = new AtomTable();
+    return table;
+}
+
+
+static inline MlULong
+slotTag(size_t hash)
+{
+    return ((MlULong) hash) & 0xffffffff00000000ULL;
+}
+
+
+static AtomIndex *
+newIndex(uint_t capacity)
+{
+    AtomIndex *index = (AtomIndex *) mlMalloc(sizeof(AtomIndex) + (capacity - 1) * sizeof(std::atomic<MlULong>));
+    if (index == NULL)
+        return NULL;
+
+    index->capacity = capacity;
+    index->count = 0;
+    index->retired = NULL;
+    for (uint_t i = 0; i < capacity; i++)
+        new (&index->slots[i]) std::atomic<MlULong>(0);
+
+    return index;
+}
+
+
+static void
+insertSlot(AtomIndex *index, size_t hash, uint_t id)
+{
+    uint_t mask = index->capacity - 1;
+    uint_t i = (uint_t) hash & mask;
+    while (index->slots[i].load(std::memory_order_relaxed) != 0)
+        i = (i + 1) & mask;
+
+    index->slots[i].store(slotTag(hash) | id, std::memory_order_release);
+    index->count++;
+}
+
+
+static const MleAtomEntry *
+findEntry(AtomTable *table, const char *string, size_t length, size_t hash)
+{
+    AtomIndex *index = table->index.load(std::memory_order_acquire);
+    if (index == NULL)
+        return NULL;
+
+    MlULong tag = slotTag(hash);
+    uint_t mask = index->capacity - 1;
+    for (uint_t i = (uint_t) hash & mask; ; i = (i + 1) & mask)
+	{
+        MlULong slot = index->slots[i].load(std::memory_order_acquire);
+        if (slot == 0)
+            return NULL;
+
+        if ((slot & 0xffffffff00000000ULL) == tag)
+		{
+            const MleAtomEntry *entry = *table->entries.get((int) (uint_t) slot - 1);
+            if ((entry->m_hash == hash) && (entry->m_length == length) &&
+                (memcmp(entry->m_string, string, length) == 0))
+                return entry;
+        }
+    }
+}
+
+
+// Make room for one more slot, keeping the index at most half full.
+static MlBoolean
+growIndex(AtomTable *table)
+{
+    AtomIndex *index = table->index.load(std::memory_order_relaxed);
+    if ((index != NULL) && ((index->count + 1) * 2 <= index->capacity))
+        return TRUE;
+
+    uint_t capacity = (index != NULL) ? index->capacity * 2 : MIN_INDEX_CAPACITY;
+    AtomIndex *grown = newIndex(capacity);
+    if (grown == NULL)
+        return FALSE;
+
+    int count = table->entries.size();
+    for (int i = 0; i < count; i++)
+	{
+        const MleAtomEntry *entry = *table->entries.get(i);
+        insertSlot(grown, entry->m_hash, entry->m_id);
+    }
+
+    grown->retired = index;
+    table->index.store(grown, std::memory_order_release);
+
+    return TRUE;
+}
+
+
+MleAtom::MleAtom(const char *string)
+  : m_entry(&s_null)
+{
+    if (string != NULL)
+	{
+        const MleAtomEntry *entry = lookup(string, strlen(string), TRUE);
+        if (entry != NULL)
+            m_entry = entry;
+    }
+}
+
+
+MleAtom::MleAtom(const char *string, size_t length)
+  : m_entry(&s_null)
+{
+    if (string != NULL)
+	{
+        const MleAtomEntry *entry = lookup(string, length, TRUE);
+        if (entry != NULL)
+            m_entry = entry;
+    }
+}
+
+
+MleAtom
+MleAtom::find(const char *string)
+{
+    const MleAtomEntry *entry = NULL;
+    if (string != NULL)
+        entry = lookup(string, strlen(string), FALSE);
+
+    return MleAtom((entry != NULL) ? entry : &s_null);
+}
+
+
+MleAtom
+MleAtom::fromId(uint_t id)
+{
+    if ((id == 0) || (id > (uint_t) INT32_MAX))
+        return MleAtom();
+
+    const MleAtomEntry * const *entry = getTable()->entries.get((int) id - 1);
+    return MleAtom((entry != NULL) ? *entry : &s_null);
+}
+
+
+uint_t
+MleAtom::getCount()
+{
+    return (uint_t) getTable()->entries.size();
+}
+
+
+const MleAtomEntry *
+MleAtom::lookup(const char *string, size_t length, MlBoolean add)
+{
+    if ((length == 0) || (length > MAX_ATOM_LENGTH))
+        return NULL;
+
+    AtomTable *table = getTable();
+    size_t hash = mlHashBytes(string, length);
+
+    const MleAtomEntry *entry = findEntry(table, string, length, hash);
+    if ((entry != NULL) || !add)
+        return entry;
+
+    std::lock_guard<std::mutex> guard(table->lock);
+
+    // Another thread may have added the string since it was looked up.
+    entry = findEntry(table, string, length, hash);
+    if (entry != NULL)
+        return entry;
+
+    if (! growIndex(table))
+        return NULL;
+
+    MleAtomEntry *added;
+    if (table->arena.allocate((void **) &added, (uint_t) (offsetof(MleAtomEntry, m_string) + length + 1)) != MLE_S_OK)
+        return NULL;
+    added->m_hash = hash;
+    added->m_id = (uint_t) table->entries.size() + 1;
+    added->m_length = (uint_t) length;
+    memcpy(added->m_string, string, length);
+    added->m_string[length] = '\0';
+
+    // The entry is stored before its slot, so a reader that finds the slot
+    // also finds the entry.
+    if (table->entries.push_back(added) == NULL)
+        return NULL;
+    insertSlot(table->index.load(std::memory_order_relaxed), hash, added->m_id);
+
+    return added;
+}
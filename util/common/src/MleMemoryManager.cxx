@@ -42,30 +42,254 @@
 
 
 // Include system header files.
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #ifdef _WINDOWS
 #include <malloc.h>
 #endif
+#include <atomic>
+#include <mutex>
 
 // Include Magic Lantern header files.
 #include "mle/mlAssert.h"
 #include "mle/MleMemoryManager.h"
+#include "mle/MleThreadCacheMemoryManager.h"
+#include "mle/MleProfilingMemoryManager.h"
+#include "mle/MleRecordingMemoryManager.h"
+#if defined(__linux__)
+#include "mle/MleLinuxNumaMemoryManager.h"
+#endif /* __linux__ */
 
 #define MLE_MAX_ALLOCATION "MleMaxAllocation"
+#define MLE_THREAD_CACHE "MleThreadCache"
+#define MLE_NUMA "MleNuma"
+#define MLE_ALLOCATION_STATS "MleAllocationStats"
+#define MLE_HEAP_PROFILE "MleHeapProfile"
+#define MLE_HEAP_PROFILE_INTERVAL "MleHeapProfileInterval"
+#define MLE_ALLOCATION_TRACE "MleAllocationTrace"
+
+
+std::atomic<MleMemoryManager *> MleMemoryManager::g_GlobalManager(NULL);
+static std::once_flag g_globalManagerOnce;
+
+// Failure injection. The limit is read by every allocation, so it is kept
+// apart from the counter, which is only written while a limit is set.
+static std::once_flag g_allocationLimitOnce;
+alignas(64) static std::atomic<uint_t> g_globalMaxAllowedAllocation(0);
+alignas(64) static std::atomic<uint_t> g_globalAllocationNumber(0);
+static thread_local uint_t t_threadMaxAllowedAllocation = 0;
+static thread_local uint_t t_threadAllocationNumber = 0;
+
+// Per-thread stack of current managers, see pushManager().
+#define MAX_MANAGER_DEPTH 16
+static thread_local MleMemoryManager *t_managerStack[MAX_MANAGER_DEPTH];
+static thread_local uint_t t_managerDepth = 0;
+
+static MleProfilingMemoryManager *g_statsManager = NULL;
+static const char *g_statsFile = NULL;
+static const char *g_heapProfileFile = NULL;
+static MleRecordingMemoryManager *g_traceManager = NULL;
+
+
+static void
+dumpAllocationStats()
+{
+    const char *suffix = strrchr(g_statsFile, '.');
+    FILE *file = fopen(g_statsFile, "w");
+    if (file != NULL)
+	{
+        g_statsManager->dumpStats(file, (suffix != NULL) && (strcmp(suffix, ".json") == 0));
+        fclose(file);
+    }
+}
 
 
-MleMemoryManager *MleMemoryManager::g_GlobalManager = NULL;
-static uint_t g_globalAllocationNumber = 0;
-static uint_t g_globalMaxAllowedAllocation = 0;
+static void
+dumpHeapProfile()
+{
+    const char *suffix = strrchr(g_heapProfileFile, '.');
+    FILE *file = fopen(g_heapProfileFile, "w");
+    if (file != NULL)
+	{
+        g_statsManager->dumpHeapProfile(file, (suffix != NULL) && (strcmp(suffix, ".folded") == 0));
+        fclose(file);
+    }
+}
+
+
+static void
+stopAllocationTrace()
+{
+    g_traceManager->stopRecording();
+}
+
+
+static MleMemoryManager *
+createManager()
+{
+	MleMemoryManager *manager;
+
+	// The thread caching front end is opt-in until it has seen more use.
+	if (getenv(MLE_THREAD_CACHE) != NULL)
+		manager = new MleThreadCacheMemoryManager();
+#if defined(__linux__)
+	else if (getenv(MLE_NUMA) != NULL)
+		manager = new MleLinuxNumaMemoryManager();
+#endif /* __linux__ */
+	else
+		manager = new MleMemoryManager();
+
+	// Wrap the manager to gather allocation statistics or a heap profile.
+	const char *statsFile = getenv(MLE_ALLOCATION_STATS);
+	const char *profileFile = getenv(MLE_HEAP_PROFILE);
+	if ((statsFile != NULL) || (profileFile != NULL))
+	{
+		g_statsManager = new MleProfilingMemoryManager(manager);
+		manager = g_statsManager;
+		if ((statsFile != NULL) && (statsFile[0] != '\0') && (strcmp(statsFile, "1") != 0))
+		{
+			g_statsFile = statsFile;
+			atexit(dumpAllocationStats);
+		}
+		if ((profileFile != NULL) && (profileFile[0] != '\0'))
+		{
+			const char *interval = getenv(MLE_HEAP_PROFILE_INTERVAL);
+			g_statsManager->setSampleInterval((interval != NULL) ?
+				strtoull(interval, NULL, 10) : MleProfilingMemoryManager::DEFAULT_SAMPLE_INTERVAL);
+			g_heapProfileFile = profileFile;
+			atexit(dumpHeapProfile);
+		}
+	}
+
+	// Record the requests made of the manager, outermost so that they are
+	// recorded as the application made them.
+	const char *traceFile = getenv(MLE_ALLOCATION_TRACE);
+	if ((traceFile != NULL) && (traceFile[0] != '\0'))
+	{
+		g_traceManager = new MleRecordingMemoryManager(manager);
+		if (g_traceManager->startRecording(traceFile) == MLE_S_OK)
+		{
+			manager = g_traceManager;
+			atexit(stopAllocationTrace);
+		}
+	}
+
+	return manager;
+}
 
 
 MleMemoryManager *
 MleMemoryManager::getManager()
 {
-	if (g_GlobalManager == NULL)
-		g_GlobalManager = new MleMemoryManager();
-    return g_GlobalManager;
+	if (t_managerDepth > 0)
+	{
+		return t_managerStack[t_managerDepth - 1];
+	}
+
+	MleMemoryManager *manager = g_GlobalManager.load(std::memory_order_acquire);
+	if (manager == NULL)
+	{
+		// Create the default manager once, unless one has been installed.
+		// setManager() goes through the same flag, so it cannot race with
+		// the creation and leave the new manager unreferenced.
+		std::call_once(g_globalManagerOnce, []()
+		{
+			if (g_GlobalManager.load(std::memory_order_acquire) == NULL)
+				g_GlobalManager.store(createManager(), std::memory_order_release);
+		});
+		manager = g_GlobalManager.load(std::memory_order_acquire);
+	}
+    return manager;
+}
+
+
+MleMemoryManager *
+MleMemoryManager::setManager(MleMemoryManager *manager)
+{
+    // Wait out (or suppress) creation of the default manager.
+    std::call_once(g_globalManagerOnce, []() {});
+    return g_GlobalManager.exchange(manager, std::memory_order_acq_rel);
+}
+
+
+MlResult
+MleMemoryManager::pushManager(MleMemoryManager *manager)
+{
+    MLE_ASSERT(manager != NULL);
+    if ((manager == NULL) || (t_managerDepth == MAX_MANAGER_DEPTH))
+	{
+	    return MLE_E_FAIL;
+    }
+
+    t_managerStack[t_managerDepth++] = manager;
+    return MLE_S_OK;
+}
+
+
+MleMemoryManager *
+MleMemoryManager::popManager()
+{
+    if (t_managerDepth == 0)
+	{
+	    return NULL;
+    }
+
+    return t_managerStack[--t_managerDepth];
+}
+
+
+static void
+initAllocationLimit()
+{
+    char *maxStr = getenv(MLE_MAX_ALLOCATION);
+    if (maxStr != NULL)
+	{
+	    g_globalMaxAllowedAllocation.store(atoi(maxStr), std::memory_order_relaxed);
+    }
+}
+
+
+void
+MleMemoryManager::setAllocationLimit(uint_t maxAllocations)
+{
+    std::call_once(g_allocationLimitOnce, initAllocationLimit);
+    g_globalAllocationNumber.store(0, std::memory_order_relaxed);
+    g_globalMaxAllowedAllocation.store(maxAllocations, std::memory_order_relaxed);
+}
+
+
+void
+MleMemoryManager::setThreadAllocationLimit(uint_t maxAllocations)
+{
+    t_threadAllocationNumber = 0;
+    t_threadMaxAllowedAllocation = maxAllocations;
+}
+
+
+MlULong
+MleMemoryManager::getResidentSize()
+{
+    return platformResidentSize();
+}
+
+
+MlBoolean
+MleMemoryManager::allocationAllowed()
+{
+    if (t_threadMaxAllowedAllocation &&
+        ++t_threadAllocationNumber > t_threadMaxAllowedAllocation)
+	{
+	    return FALSE;
+    }
+
+    uint_t maxAllocation = g_globalMaxAllowedAllocation.load(std::memory_order_relaxed);
+    if (maxAllocation &&
+        g_globalAllocationNumber.fetch_add(1, std::memory_order_relaxed) >= maxAllocation)
+	{
+	    return FALSE;
+    }
+    return TRUE;
 }
 
 
@@ -131,11 +355,7 @@ extern "C" {
 
 MleMemoryManager::MleMemoryManager()
 {
-    if (g_globalMaxAllowedAllocation == 0)
-	{
-	    char *maxStr = getenv(MLE_MAX_ALLOCATION);
-	    g_globalMaxAllowedAllocation = maxStr ? atoi(maxStr) : 0;
-    }
+    std::call_once(g_allocationLimitOnce, initAllocationLimit);
     platformInit(m_Cookie);
 }
 
@@ -155,8 +375,7 @@ MleMemoryManager::allocate(void **memory, uint_t size)
 	    return MLE_E_FAIL;
     }
 
-    if (g_globalMaxAllowedAllocation &&
-        ++g_globalAllocationNumber > g_globalMaxAllowedAllocation)
+    if (! allocationAllowed())
 	{
 	    return MLE_E_FAIL;
     }
@@ -184,8 +403,7 @@ MleMemoryManager::resize(void **memory, uint_t newSize)
 	    return MLE_E_FAIL;
     }
 
-    if (g_globalMaxAllowedAllocation &&
-        ++g_globalAllocationNumber > g_globalMaxAllowedAllocation)
+    if (! allocationAllowed())
 	{
 	    return MLE_E_FAIL;
     }
@@ -223,6 +441,142 @@ MleMemoryManager::release(void **memory)
 }
 
 
+MlResult
+MleMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    MLE_ASSERT(newSize > 0);
+    if (memory == NULL || newSize == 0)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    return (platformUsableSize(m_Cookie, memory) >= newSize) ? MLE_S_OK : MLE_E_FAIL;
+}
+
+
+MlULong
+MleMemoryManager::getUsableSize(void *memory)
+{
+    if (memory == NULL)
+	{
+	    return 0;
+    }
+
+    return platformUsableSize(m_Cookie, memory);
+}
+
+
+MlResult
+MleMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    if (size <= 0xffffffff)
+	{
+	    return allocate(memory, (uint_t) size);
+    }
+
+    if (! allocationAllowed())
+	{
+	    return MLE_E_FAIL;
+    }
+
+    void *newMemory = platformAllocate(m_Cookie, size);
+
+    if (newMemory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    *memory = newMemory;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    if (newSize <= 0xffffffff)
+	{
+	    return resize(memory, (uint_t) newSize);
+    }
+
+    MLE_ASSERT(memory != NULL);
+    if (memory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    if (! allocationAllowed())
+	{
+	    return MLE_E_FAIL;
+    }
+
+    void *newMemory = platformResize(m_Cookie, *memory, newSize);
+
+    if (newMemory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    *memory = newMemory;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleMemoryManager::allocateAligned(void **memory, MlULong size, uint_t alignment)
+{
+    MLE_ASSERT(size > 0);
+    MLE_ASSERT((alignment & (alignment - 1)) == 0);
+    if (size == 0 || (alignment & (alignment - 1)) != 0)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    if (alignment < sizeof(void *))
+	{
+	    alignment = sizeof(void *);
+    }
+
+    if (! allocationAllowed())
+	{
+	    return MLE_E_FAIL;
+    }
+
+    void *newMemory = platformAllocateAligned(m_Cookie, size, alignment);
+
+    if (newMemory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    *memory = newMemory;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleMemoryManager::releaseAligned(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+    if (memory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    if (platformReleaseAligned(m_Cookie, *memory) == MLE_E_FAIL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    *memory = NULL;
+
+    return MLE_S_OK;
+}
+
+
 MlResult
 MleMemoryManager::dupString(const MlChar *source, MlChar **destination)
 {
@@ -0,0 +1,267 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleOutputSink.cxx
+ *  @ingroup MleCore
+ *
+ *  Output sinks for generated text.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#if !defined(_WINDOWS)
+#include <sys/uio.h>
+#endif
+
+// Include Magic Lantern header files.
+#include "mle/MleOutputSink.h"
+#include "mle/mlFileio.h"
+#include "mle/mlMalloc.h"
+
+
+//////////////////////////////////////////////////////////////////////
+// MleOutputSink
+//////////////////////////////////////////////////////////////////////
+
+MleOutputSink::~MleOutputSink()
+{
+    // Do nothing.
+}
+
+
+MlResult
+MleOutputSink::flush()
+{
+    return MLE_S_OK;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// MleBufferSink
+//////////////////////////////////////////////////////////////////////
+
+MleBufferSink::MleBufferSink()
+  : m_failed(FALSE)
+{}
+
+
+MleBufferSink::~MleBufferSink()
+{
+    // Do nothing; the array releases the output.
+}
+
+
+MlResult
+MleBufferSink::write(const void *data, size_t length)
+{
+    if (m_failed)
+        return MLE_E_FAIL;
+    if (length == 0)
+        return MLE_S_OK;
+
+    int size = m_data.size();
+    if ((length > (size_t) (INT32_MAX - size)) || (m_data.resize(size + (int) length) == NULL))
+	{
+        m_failed = TRUE;
+        return MLE_E_FAIL;
+    }
+    memcpy(m_data + size, data, length);
+
+    return MLE_S_OK;
+}
+
+
+void
+MleBufferSink::clear()
+{
+    m_data.resize(0);
+    m_failed = FALSE;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// MleFileSink
+//////////////////////////////////////////////////////////////////////
+
+MleFileSink::MleFileSink(int fd, size_t bufferSize)
+  : m_fd(fd),
+    m_buffer(NULL),
+    m_bufferSize(bufferSize),
+    m_staged(0),
+    m_failed(FALSE)
+{}
+
+
+MleFileSink::~MleFileSink()
+{
+    flush();
+    if (m_buffer != NULL)
+        mlFree(m_buffer);
+}
+
+
+MlResult
+MleFileSink::write(const void *data, size_t length)
+{
+    if (m_failed)
+        return MLE_E_FAIL;
+
+    // Stage what fits; a block that would not fit goes out with the
+    // staged bytes.
+    if (m_staged + length <= m_bufferSize)
+	{
+        if (m_buffer == NULL)
+		{
+            if (length == 0)
+                return MLE_S_OK;
+            if ((m_buffer = (char *) mlMalloc(m_bufferSize)) == NULL)
+			{
+                m_failed = TRUE;
+                return MLE_E_FAIL;
+            }
+        }
+        memcpy(m_buffer + m_staged, data, length);
+        m_staged += length;
+        return MLE_S_OK;
+    }
+
+    // Top up the buffer with a small write, so that staging goes on.
+    if ((length < m_bufferSize / 2) && (m_buffer != NULL))
+	{
+        size_t room = m_bufferSize - m_staged;
+        memcpy(m_buffer + m_staged, data, room);
+        m_staged = m_bufferSize;
+        if (writeOut(NULL, 0) != MLE_S_OK)
+            return MLE_E_FAIL;
+        memcpy(m_buffer, (const char *) data + room, length - room);
+        m_staged = length - room;
+        return MLE_S_OK;
+    }
+
+    return writeOut(data, length);
+}
+
+
+MlResult
+MleFileSink::flush()
+{
+    if (m_failed)
+        return MLE_E_FAIL;
+
+    return writeOut(NULL, 0);
+}
+
+
+MlResult
+MleFileSink::writeOut(const void *data, size_t length)
+{
+    const char *parts[2] = { m_buffer, (const char *) data };
+    size_t lengths[2] = { m_staged, length };
+    int first = 0;
+    while ((first < 2) && (lengths[first] == 0))
+        first++;
+
+    while (first < 2)
+	{
+#if defined(_WINDOWS)
+        int written = mlWrite(m_fd, parts[first], (unsigned int) lengths[first]);
+#else
+        struct iovec iov[2];
+        int count = 0;
+        for (int i = first; i < 2; i++)
+		{
+            if (lengths[i] > 0)
+			{
+                iov[count].iov_base = (void *) parts[i];
+                iov[count].iov_len = lengths[i];
+                count++;
+            }
+        }
+        ssize_t written = writev(m_fd, iov, count);
+#endif
+        if ((written < 0) && (errno == EINTR))
+            continue;
+        if (written <= 0)
+		{
+            m_failed = TRUE;
+            return MLE_E_FAIL;
+        }
+
+        // Step past what was written; writes may be partial.
+        size_t done = (size_t) written;
+        while ((first < 2) && (done >= lengths[first]))
+		{
+            done -= lengths[first];
+            first++;
+        }
+        if (first < 2)
+		{
+            parts[first] += done;
+            lengths[first] -= done;
+        }
+    }
+
+    m_staged = 0;
+    return MLE_S_OK;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// MleStdioSink
+//////////////////////////////////////////////////////////////////////
+
+MleStdioSink::MleStdioSink(FILE *fp)
+  : m_fp(fp)
+{}
+
+
+MlResult
+MleStdioSink::write(const void *data, size_t length)
+{
+    if ((length > 0) && (fwrite(data, 1, length, m_fp) != length))
+        return MLE_E_FAIL;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleStdioSink::flush()
+{
+    return (fflush(m_fp) == 0) ? MLE_S_OK : MLE_E_FAIL;
+}
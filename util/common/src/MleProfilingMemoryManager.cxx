@@ -0,0 +1,766 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleProfilingMemoryManager.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the profiling memory manager.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleProfilingMemoryManager.h"
+
+
+// Every allocation is preceded by a header recording its size and tag.
+// The header is padded to 16 bytes so that the payload keeps the platform
+// alignment.
+#define HEADER_SIZE     16
+#define HEADER_MAGIC    0x4d4c5046
+
+// Number of counter shards; threads are spread over them round robin.
+#define NUM_SHARDS      16
+
+#define CACHE_LINE      64
+
+// Header flag marking an allocation whose stack was sampled.
+#define SAMPLED_FLAG    0x1
+
+// Stack frames belonging to the manager: platformBacktrace, recordSample
+// and allocate.
+#define SAMPLER_FRAMES  3
+
+struct AllocationHeader
+{
+    MlULong size;
+    MlUShort tag;
+    MlUShort flags;
+    uint_t magic;
+};
+
+struct alignas(CACHE_LINE) TagCounters
+{
+    std::atomic<MlULong> allocations;
+    std::atomic<MlULong> releases;
+    std::atomic<MlULong> bytesAllocated;
+    std::atomic<MlULong> bytesReleased;
+};
+
+struct Shard
+{
+    TagCounters tags[MleProfilingMemoryManager::MAX_TAGS];
+    alignas(CACHE_LINE) std::atomic<MlULong> histogram[MleAllocationStats::HISTOGRAM_BUCKETS];
+
+    // Change in live bytes not yet folded into the total.
+    alignas(CACHE_LINE) std::atomic<MlLong> pendingLive;
+};
+
+struct Sample
+{
+    MlULong size;
+    uint_t depth;
+    MlULong interval;   // The sample interval in effect when it was taken.
+    void *frames[MleProfilingMemoryManager::MAX_SAMPLE_FRAMES];
+};
+
+struct MleProfilingCounters
+{
+    Shard shards[NUM_SHARDS];
+
+    alignas(CACHE_LINE) std::atomic<MlLong> bytesLive;
+    std::atomic<MlLong> peakBytesLive;
+
+    // Live sampled allocations, keyed by block address.
+    alignas(CACHE_LINE) std::atomic<MlULong> sampleInterval;
+    std::mutex sampleLock;
+    std::unordered_map<void *, Sample> samples;
+};
+
+
+//
+// Tags are registered globally so that the identifiers can be cached in
+// static variables by the code using them.
+//
+static const char *g_tagNames[MleProfilingMemoryManager::MAX_TAGS] = { "untagged" };
+static std::atomic<uint_t> g_numTags(1);
+static std::mutex g_tagLock;
+
+static thread_local uint_t t_currentTag = 0;
+
+// The shard of the calling thread plus one, or 0 if not assigned yet.
+static thread_local uint_t t_shard = 0;
+static std::atomic<uint_t> g_nextShard(0);
+
+// Bytes the calling thread may allocate before its next sample, and the
+// state of its random number generator (0 until seeded).
+static thread_local MlLong t_bytesUntilSample = 0;
+static thread_local MlULong t_random = 0;
+
+
+static inline Shard &
+threadShard(MleProfilingCounters *counters)
+{
+    if (t_shard == 0)
+        t_shard = (g_nextShard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS) + 1;
+    return counters->shards[t_shard - 1];
+}
+
+static inline uint_t
+histogramBucket(MlULong size)
+{
+    uint_t bucket = 0;
+    while (bucket < 32 && ((MlULong) 1 << bucket) < size)
+        bucket++;
+    return bucket;
+}
+
+static void
+chargeLive(MleProfilingCounters *counters, Shard &shard, MlLong delta)
+{
+    MlLong pending = shard.pendingLive.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (pending < (MlLong) MleProfilingMemoryManager::PEAK_GRANULARITY &&
+        pending > -(MlLong) MleProfilingMemoryManager::PEAK_GRANULARITY)
+        return;
+
+    // Fold this shard's drift into the total and raise the peak.
+    pending = shard.pendingLive.exchange(0, std::memory_order_relaxed);
+    MlLong live = counters->bytesLive.fetch_add(pending, std::memory_order_relaxed) + pending;
+    MlLong peak = counters->peakBytesLive.load(std::memory_order_relaxed);
+    while (live > peak &&
+           ! counters->peakBytesLive.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+}
+
+static MlLong
+sampleDistance(MlULong interval)
+{
+    if (t_random == 0)
+        t_random = ((MlULong) (size_t) &t_random * 0x9e3779b97f4a7c15ULL) | 1;
+
+    // xorshift64*, then an exponentially distributed distance with the
+    // given mean; the uniform variate is in (0, 1].
+    t_random ^= t_random >> 12;
+    t_random ^= t_random << 25;
+    t_random ^= t_random >> 27;
+    double uniform = (double) (((t_random * 0x2545f4914f6cdd1dULL) >> 11) + 1) / 9007199254740992.0;
+
+    return (MlLong) (-log(uniform) * (double) interval) + 1;
+}
+
+// Estimated bytes represented by a sample of the given size, following the
+// probability that an allocation of that size is sampled at all.
+static double
+sampleWeight(MlULong size, MlULong interval)
+{
+    if (interval == 0 || size == 0)
+        return (double) size;
+    return (double) size / (1.0 - exp(-(double) size / (double) interval));
+}
+
+static void
+writeJsonString(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *) text; *c != '\0'; c++)
+	{
+        if (*c == '"' || *c == '\\')
+            fprintf(file, "\\%c", *c);
+        else if (*c < 0x20)
+            fprintf(file, "\\u%04x", *c);
+        else
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+
+MleProfilingMemoryManager::MleProfilingMemoryManager(MleMemoryManager *target)
+  : m_target(target)
+{
+    m_counters = new MleProfilingCounters();
+    m_counters->sampleInterval.store(0);
+}
+
+
+MleProfilingMemoryManager::~MleProfilingMemoryManager()
+{
+    delete m_counters;
+}
+
+
+uint_t
+MleProfilingMemoryManager::getTagId(const char *name)
+{
+    MLE_ASSERT(name != NULL);
+
+    std::lock_guard<std::mutex> guard(g_tagLock);
+
+    uint_t numTags = g_numTags.load(std::memory_order_relaxed);
+    for (uint_t tag = 0; tag < numTags; tag++)
+	{
+        if (strcmp(g_tagNames[tag], name) == 0)
+            return tag;
+    }
+    if (numTags == MAX_TAGS)
+        return 0;
+
+    g_tagNames[numTags] = name;
+    g_numTags.store(numTags + 1, std::memory_order_release);
+    return numTags;
+}
+
+
+uint_t
+MleProfilingMemoryManager::getCurrentTag()
+{
+    return t_currentTag;
+}
+
+
+uint_t
+MleProfilingMemoryManager::setCurrentTag(uint_t tag)
+{
+    uint_t previous = t_currentTag;
+    t_currentTag = (tag < MAX_TAGS) ? tag : 0;
+    return previous;
+}
+
+
+MlResult
+MleProfilingMemoryManager::targetAllocate(void **memory, MlULong size)
+{
+    if (m_target != NULL)
+        return m_target->allocateLarge(memory, size);
+    if (size <= 0xffffffff)
+        return MleMemoryManager::allocate(memory, (uint_t) size);
+    return MleMemoryManager::allocateLarge(memory, size);
+}
+
+
+MlResult
+MleProfilingMemoryManager::targetResize(void **memory, MlULong newSize)
+{
+    if (m_target != NULL)
+        return m_target->resizeLarge(memory, newSize);
+    if (newSize <= 0xffffffff)
+        return MleMemoryManager::resize(memory, (uint_t) newSize);
+    return MleMemoryManager::resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleProfilingMemoryManager::targetRelease(void **memory)
+{
+    if (m_target != NULL)
+        return m_target->release(memory);
+    return MleMemoryManager::release(memory);
+}
+
+
+MlResult
+MleProfilingMemoryManager::allocate(void **memory, uint_t size)
+{
+    return allocateLarge(memory, size);
+}
+
+
+MlResult
+MleProfilingMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if (size > ~((MlULong) 0) - HEADER_SIZE)
+        return MLE_E_FAIL;
+
+    void *block;
+    if (targetAllocate(&block, size + HEADER_SIZE) != MLE_S_OK)
+        return MLE_E_FAIL;
+
+    AllocationHeader *header = (AllocationHeader *) block;
+    header->size = size;
+    header->tag = (MlUShort) t_currentTag;
+    header->flags = 0;
+    header->magic = HEADER_MAGIC;
+
+    MlULong interval = m_counters->sampleInterval.load(std::memory_order_relaxed);
+    if (interval != 0)
+	{
+        t_bytesUntilSample -= (MlLong) size;
+        if (t_bytesUntilSample <= 0)
+		{
+            // The first allocation on a thread only seeds the sampler.
+            if (t_random != 0)
+			{
+                header->flags |= SAMPLED_FLAG;
+                recordSample(block, size);
+            }
+            t_bytesUntilSample = sampleDistance(interval);
+        }
+    }
+
+    Shard &shard = threadShard(m_counters);
+    TagCounters &tag = shard.tags[header->tag];
+    tag.allocations.fetch_add(1, std::memory_order_relaxed);
+    tag.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    shard.histogram[histogramBucket(size)].fetch_add(1, std::memory_order_relaxed);
+    chargeLive(m_counters, shard, size);
+
+    *memory = (MlChar *) block + HEADER_SIZE;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleProfilingMemoryManager::resize(void **memory, uint_t newSize)
+{
+    return resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleProfilingMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if ((memory == NULL) || (*memory == NULL) || (newSize > ~((MlULong) 0) - HEADER_SIZE))
+        return MLE_E_FAIL;
+
+    void *block = (MlChar *) *memory - HEADER_SIZE;
+    AllocationHeader *header = (AllocationHeader *) block;
+    if (header->magic != HEADER_MAGIC)
+        return MLE_E_FAIL;
+    MlULong oldSize = header->size;
+
+    // Sampled blocks are moved under the sample lock, so that their old
+    // address cannot be reused and sampled by another thread meanwhile.
+    std::unique_lock<std::mutex> guard(m_counters->sampleLock, std::defer_lock);
+    if (header->flags & SAMPLED_FLAG)
+        guard.lock();
+
+    if (targetResize(&block, newSize + HEADER_SIZE) != MLE_S_OK)
+        return MLE_E_FAIL;
+
+    header = (AllocationHeader *) block;
+    header->size = newSize;
+
+    // A sampled allocation keeps its stack under its new address.
+    if (guard.owns_lock())
+	{
+        std::unordered_map<void *, Sample>::iterator entry =
+            m_counters->samples.find((MlChar *) *memory - HEADER_SIZE);
+        if (entry != m_counters->samples.end())
+		{
+            Sample sample = entry->second;
+            sample.size = newSize;
+            m_counters->samples.erase(entry);
+            m_counters->samples[block] = sample;
+        }
+        guard.unlock();
+    }
+
+    Shard &shard = threadShard(m_counters);
+    TagCounters &tag = shard.tags[header->tag];
+    if (newSize > oldSize)
+        tag.bytesAllocated.fetch_add(newSize - oldSize, std::memory_order_relaxed);
+    else
+        tag.bytesReleased.fetch_add(oldSize - newSize, std::memory_order_relaxed);
+    shard.histogram[histogramBucket(newSize)].fetch_add(1, std::memory_order_relaxed);
+    chargeLive(m_counters, shard, (MlLong) newSize - (MlLong) oldSize);
+
+    *memory = (MlChar *) block + HEADER_SIZE;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleProfilingMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    if ((memory == NULL) || (newSize > ~((MlULong) 0) - HEADER_SIZE))
+        return MLE_E_FAIL;
+
+    void *block = (MlChar *) memory - HEADER_SIZE;
+    AllocationHeader *header = (AllocationHeader *) block;
+    if (header->magic != HEADER_MAGIC)
+        return MLE_E_FAIL;
+
+    MlResult result = (m_target != NULL) ?
+        m_target->tryResizeInPlace(block, newSize + HEADER_SIZE) :
+        MleMemoryManager::tryResizeInPlace(block, newSize + HEADER_SIZE);
+    if (result != MLE_S_OK)
+        return MLE_E_FAIL;
+
+    MlULong oldSize = header->size;
+    header->size = newSize;
+
+    Shard &shard = threadShard(m_counters);
+    TagCounters &tag = shard.tags[header->tag];
+    if (newSize > oldSize)
+        tag.bytesAllocated.fetch_add(newSize - oldSize, std::memory_order_relaxed);
+    else
+        tag.bytesReleased.fetch_add(oldSize - newSize, std::memory_order_relaxed);
+    chargeLive(m_counters, shard, (MlLong) newSize - (MlLong) oldSize);
+
+    if (header->flags & SAMPLED_FLAG)
+	{
+        std::lock_guard<std::mutex> guard(m_counters->sampleLock);
+        std::unordered_map<void *, Sample>::iterator entry = m_counters->samples.find(block);
+        if (entry != m_counters->samples.end())
+            entry->second.size = newSize;
+    }
+
+    return MLE_S_OK;
+}
+
+
+MlULong
+MleProfilingMemoryManager::getUsableSize(void *memory)
+{
+    if (memory == NULL)
+        return 0;
+
+    void *block = (MlChar *) memory - HEADER_SIZE;
+    MlULong usable = (m_target != NULL) ?
+        m_target->getUsableSize(block) : MleMemoryManager::getUsableSize(block);
+
+    return (usable > HEADER_SIZE) ? usable - HEADER_SIZE : 0;
+}
+
+
+MlResult
+MleProfilingMemoryManager::release(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if (memory == NULL)
+        return MLE_E_FAIL;
+
+    // Releasing NULL does nothing, as it does for the heap.
+    if (*memory == NULL)
+        return MLE_S_OK;
+
+    void *block = (MlChar *) *memory - HEADER_SIZE;
+    AllocationHeader *header = (AllocationHeader *) block;
+    if (header->magic != HEADER_MAGIC)
+        return MLE_E_FAIL;
+
+    MlULong size = header->size;
+    uint_t tagId = header->tag;
+
+    // As in resize(), sampled blocks are released under the sample lock.
+    std::unique_lock<std::mutex> guard(m_counters->sampleLock, std::defer_lock);
+    if (header->flags & SAMPLED_FLAG)
+        guard.lock();
+
+    header->magic = 0;
+    if (targetRelease(&block) != MLE_S_OK)
+	{
+        header->magic = HEADER_MAGIC;
+        return MLE_E_FAIL;
+    }
+
+    if (guard.owns_lock())
+	{
+        m_counters->samples.erase((MlChar *) *memory - HEADER_SIZE);
+        guard.unlock();
+    }
+
+    Shard &shard = threadShard(m_counters);
+    TagCounters &tag = shard.tags[tagId];
+    tag.releases.fetch_add(1, std::memory_order_relaxed);
+    tag.bytesReleased.fetch_add(size, std::memory_order_relaxed);
+    chargeLive(m_counters, shard, -(MlLong) size);
+
+    *memory = NULL;
+
+    return MLE_S_OK;
+}
+
+
+void
+MleProfilingMemoryManager::getStats(MleAllocationStats &stats)
+{
+    uint_t numTags = g_numTags.load(std::memory_order_acquire);
+
+    stats.m_tags.clear();
+    stats.m_allocations = 0;
+    stats.m_releases = 0;
+    stats.m_bytesLive = 0;
+    for (uint_t bucket = 0; bucket < MleAllocationStats::HISTOGRAM_BUCKETS; bucket++)
+        stats.m_histogram[bucket] = 0;
+
+    for (uint_t tagId = 0; tagId < numTags; tagId++)
+	{
+        MleAllocationStats::Tag tag;
+        MlULong bytesReleased = 0;
+
+        tag.m_name = g_tagNames[tagId];
+        tag.m_allocations = 0;
+        tag.m_releases = 0;
+        tag.m_bytesAllocated = 0;
+        for (uint_t i = 0; i < NUM_SHARDS; i++)
+		{
+            TagCounters &counters = m_counters->shards[i].tags[tagId];
+            tag.m_allocations += counters.allocations.load(std::memory_order_relaxed);
+            tag.m_releases += counters.releases.load(std::memory_order_relaxed);
+            tag.m_bytesAllocated += counters.bytesAllocated.load(std::memory_order_relaxed);
+            bytesReleased += counters.bytesReleased.load(std::memory_order_relaxed);
+        }
+        if (tag.m_allocations == 0)
+            continue;
+
+        // Another thread may release between the two loads above.
+        tag.m_bytesLive = (tag.m_bytesAllocated > bytesReleased) ?
+            tag.m_bytesAllocated - bytesReleased : 0;
+
+        stats.m_allocations += tag.m_allocations;
+        stats.m_releases += tag.m_releases;
+        stats.m_bytesLive += tag.m_bytesLive;
+        stats.m_tags.push_back(tag);
+    }
+
+    for (uint_t i = 0; i < NUM_SHARDS; i++)
+	{
+        for (uint_t bucket = 0; bucket < MleAllocationStats::HISTOGRAM_BUCKETS; bucket++)
+            stats.m_histogram[bucket] +=
+                m_counters->shards[i].histogram[bucket].load(std::memory_order_relaxed);
+    }
+
+    MlLong peak = m_counters->peakBytesLive.load(std::memory_order_relaxed);
+    stats.m_peakBytesLive = ((MlULong) peak > stats.m_bytesLive) ? (MlULong) peak : stats.m_bytesLive;
+}
+
+
+MlResult
+MleProfilingMemoryManager::dumpStats(FILE *file, MlBoolean json)
+{
+    MLE_ASSERT(file != NULL);
+
+    if (file == NULL)
+        return MLE_E_FAIL;
+
+    MleAllocationStats stats;
+    getStats(stats);
+
+    if (json)
+	{
+        fprintf(file, "{\"allocations\":%llu,\"releases\":%llu,\"bytesLive\":%llu,\"peakBytesLive\":%llu,\"tags\":[",
+            (unsigned long long) stats.m_allocations, (unsigned long long) stats.m_releases,
+            (unsigned long long) stats.m_bytesLive, (unsigned long long) stats.m_peakBytesLive);
+        for (size_t i = 0; i < stats.m_tags.size(); i++)
+		{
+            const MleAllocationStats::Tag &tag = stats.m_tags[i];
+            fprintf(file, "%s{\"name\":", (i > 0) ? "," : "");
+            writeJsonString(file, tag.m_name);
+            fprintf(file, ",\"allocations\":%llu,\"releases\":%llu,\"bytesAllocated\":%llu,\"bytesLive\":%llu}",
+                (unsigned long long) tag.m_allocations, (unsigned long long) tag.m_releases,
+                (unsigned long long) tag.m_bytesAllocated, (unsigned long long) tag.m_bytesLive);
+        }
+        fprintf(file, "],\"histogram\":[");
+        MlBoolean first = TRUE;
+        for (uint_t bucket = 0; bucket < MleAllocationStats::HISTOGRAM_BUCKETS; bucket++)
+		{
+            if (stats.m_histogram[bucket] == 0)
+                continue;
+            fprintf(file, "%s{\"maxSize\":%llu,\"count\":%llu}", first ? "" : ",",
+                (unsigned long long) 1 << bucket, (unsigned long long) stats.m_histogram[bucket]);
+            first = FALSE;
+        }
+        fprintf(file, "]}\n");
+    }
+    else
+	{
+        fprintf(file, "Allocation statistics\n");
+        fprintf(file, "  allocations %llu, releases %llu, bytes live %llu, peak bytes live %llu\n\n",
+            (unsigned long long) stats.m_allocations, (unsigned long long) stats.m_releases,
+            (unsigned long long) stats.m_bytesLive, (unsigned long long) stats.m_peakBytesLive);
+        fprintf(file, "  %-24s %14s %14s %16s %16s\n",
+            "tag", "allocations", "releases", "bytes allocated", "bytes live");
+        for (size_t i = 0; i < stats.m_tags.size(); i++)
+		{
+            const MleAllocationStats::Tag &tag = stats.m_tags[i];
+            fprintf(file, "  %-24s %14llu %14llu %16llu %16llu\n", tag.m_name,
+                (unsigned long long) tag.m_allocations, (unsigned long long) tag.m_releases,
+                (unsigned long long) tag.m_bytesAllocated, (unsigned long long) tag.m_bytesLive);
+        }
+        fprintf(file, "\n  %-24s %14s\n", "request size <=", "count");
+        for (uint_t bucket = 0; bucket < MleAllocationStats::HISTOGRAM_BUCKETS; bucket++)
+		{
+            if (stats.m_histogram[bucket] != 0)
+                fprintf(file, "  %-24llu %14llu\n",
+                    (unsigned long long) 1 << bucket, (unsigned long long) stats.m_histogram[bucket]);
+        }
+    }
+
+    return ferror(file) ? MLE_E_FAIL : MLE_S_OK;
+}
+
+
+void
+MleProfilingMemoryManager::recordSample(void *block, MlULong size)
+{
+    void *frames[MAX_SAMPLE_FRAMES + SAMPLER_FRAMES];
+    uint_t depth = platformBacktrace(frames, MAX_SAMPLE_FRAMES + SAMPLER_FRAMES);
+
+    Sample sample;
+    sample.size = size;
+    sample.interval = m_counters->sampleInterval.load(std::memory_order_relaxed);
+    sample.depth = (depth > SAMPLER_FRAMES) ? depth - SAMPLER_FRAMES : 0;
+    memcpy(sample.frames, frames + SAMPLER_FRAMES, sample.depth * sizeof(void *));
+
+    std::lock_guard<std::mutex> guard(m_counters->sampleLock);
+    m_counters->samples[block] = sample;
+}
+
+
+void
+MleProfilingMemoryManager::setSampleInterval(MlULong interval)
+{
+    m_counters->sampleInterval.store(interval, std::memory_order_relaxed);
+}
+
+
+MlULong
+MleProfilingMemoryManager::getSampleInterval()
+{
+    return m_counters->sampleInterval.load(std::memory_order_relaxed);
+}
+
+
+uint_t
+MleProfilingMemoryManager::getLiveSampleCount()
+{
+    std::lock_guard<std::mutex> guard(m_counters->sampleLock);
+    return (uint_t) m_counters->samples.size();
+}
+
+
+MlResult
+MleProfilingMemoryManager::dumpHeapProfile(FILE *file, MlBoolean folded)
+{
+    MLE_ASSERT(file != NULL);
+
+    if (file == NULL)
+        return MLE_E_FAIL;
+
+    // Group the live samples by stack.
+    struct StackTotal
+	{
+        MlULong count;
+        MlULong bytes;
+        double estimatedBytes;
+    };
+    std::map<std::vector<void *>, StackTotal> stacks;
+    MlULong totalCount = 0, totalBytes = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_counters->sampleLock);
+        for (std::unordered_map<void *, Sample>::const_iterator entry = m_counters->samples.begin();
+             entry != m_counters->samples.end(); ++entry)
+		{
+            const Sample &sample = entry->second;
+            StackTotal &total = stacks[std::vector<void *>(sample.frames, sample.frames + sample.depth)];
+            total.count++;
+            total.bytes += sample.size;
+            total.estimatedBytes += sampleWeight(sample.size, sample.interval);
+            totalCount++;
+            totalBytes += sample.size;
+        }
+    }
+
+    if (folded)
+	{
+        char name[256];
+        for (std::map<std::vector<void *>, StackTotal>::const_iterator stack = stacks.begin();
+             stack != stacks.end(); ++stack)
+		{
+            const std::vector<void *> &frames = stack->first;
+            if (frames.empty())
+                fputs("[unknown]", file);
+            for (size_t i = frames.size(); i > 0; i--)
+			{
+                if (i < frames.size())
+                    fputc(';', file);
+                if (platformSymbolName(frames[i - 1], name, sizeof(name)))
+                    fputs(name, file);
+                else
+                    fprintf(file, "0x%llx", (unsigned long long) (size_t) frames[i - 1]);
+            }
+            fprintf(file, " %llu\n", (unsigned long long) (stack->second.estimatedBytes + 0.5));
+        }
+    }
+    else
+	{
+        fprintf(file, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%llu\n",
+            (unsigned long long) totalCount, (unsigned long long) totalBytes,
+            (unsigned long long) totalCount, (unsigned long long) totalBytes,
+            (unsigned long long) getSampleInterval());
+        for (std::map<std::vector<void *>, StackTotal>::const_iterator stack = stacks.begin();
+             stack != stacks.end(); ++stack)
+		{
+            const StackTotal &total = stack->second;
+            fprintf(file, "%llu: %llu [%llu: %llu] @",
+                (unsigned long long) total.count, (unsigned long long) total.bytes,
+                (unsigned long long) total.count, (unsigned long long) total.bytes);
+            for (size_t i = 0; i < stack->first.size(); i++)
+                fprintf(file, " 0x%llx", (unsigned long long) (size_t) stack->first[i]);
+            fputc('\n', file);
+        }
+
+        // pprof needs the address space layout to symbolize the profile.
+        FILE *maps = fopen("/proc/self/maps", "r");
+        if (maps != NULL)
+		{
+            char line[1024];
+            fprintf(file, "\nMAPPED_LIBRARIES:\n");
+            while (fgets(line, sizeof(line), maps) != NULL)
+                fputs(line, file);
+            fclose(maps);
+        }
+    }
+
+    return ferror(file) ? MLE_E_FAIL : MLE_S_OK;
+}
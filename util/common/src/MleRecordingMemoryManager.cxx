@@ -0,0 +1,442 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleRecordingMemoryManager.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the allocation recording memory manager.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleRecordingMemoryManager.h"
+
+
+// Records are gathered in a buffer and written when it fills.
+#define BUFFER_SIZE     (64 * 1024)
+
+// The longest record: operation, thread, object, size and alignment.
+#define MAX_RECORD_SIZE (1 + 5 + 5 + 10 + 1)
+
+struct MleRecordingState
+{
+    std::mutex lock;
+    std::atomic<bool> recording;
+    FILE *file;
+    MlBoolean writeFailed;
+
+    std::vector<MlByte> buffer;
+    MlULong records;
+
+    // The thread of the last record, plus one.
+    uint_t lastThread;
+
+    // Object numbers of the recorded live blocks, and the numbers given up.
+    std::unordered_map<void *, uint_t> objects;
+    std::vector<uint_t> freeObjects;
+    uint_t nextObject;
+};
+
+
+// Threads are numbered in the order they first make a recorded request.
+static std::atomic<uint_t> g_nextThread(0);
+static thread_local uint_t t_thread = 0;
+
+
+static inline uint_t
+threadNumber()
+{
+    if (t_thread == 0)
+        t_thread = g_nextThread.fetch_add(1, std::memory_order_relaxed) + 1;
+    return t_thread - 1;
+}
+
+static inline void
+putNumber(std::vector<MlByte> &buffer, MlULong value)
+{
+    while (value >= 0x80)
+	{
+        buffer.push_back((MlByte) (value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((MlByte) value);
+}
+
+static void
+flushBuffer(MleRecordingState *state)
+{
+    if (! state->buffer.empty() &&
+        fwrite(&state->buffer[0], 1, state->buffer.size(), state->file) != state->buffer.size())
+        state->writeFailed = TRUE;
+    state->buffer.clear();
+}
+
+// Start a record; the caller holds the lock.
+static void
+beginRecord(MleRecordingState *state, uint_t operation, MlResult result)
+{
+    if (state->buffer.size() + MAX_RECORD_SIZE > BUFFER_SIZE)
+        flushBuffer(state);
+
+    uint_t thread = threadNumber();
+    MlByte op = (MlByte) operation;
+    if (result != MLE_S_OK)
+        op |= MleRecordingMemoryManager::FAILED_FLAG;
+    if (thread + 1 != state->lastThread)
+        op |= MleRecordingMemoryManager::THREAD_FLAG;
+
+    state->buffer.push_back(op);
+    if (op & MleRecordingMemoryManager::THREAD_FLAG)
+	{
+        putNumber(state->buffer, thread);
+        state->lastThread = thread + 1;
+    }
+    state->records++;
+}
+
+static void
+recordAllocation(MleRecordingState *state, uint_t operation, void *memory,
+                 MlULong size, uint_t alignment, MlResult result)
+{
+    std::lock_guard<std::mutex> guard(state->lock);
+    if (! state->recording.load(std::memory_order_relaxed))
+        return;
+
+    beginRecord(state, operation, result);
+    putNumber(state->buffer, size);
+    if (operation == MleRecordingMemoryManager::ALIGNED_ALLOCATE)
+	{
+        MlByte shift = 0;
+        while (((uint_t) 1 << shift) < alignment)
+            shift++;
+        state->buffer.push_back(shift);
+    }
+
+    if (result == MLE_S_OK)
+	{
+        uint_t object;
+        if (! state->freeObjects.empty())
+		{
+            object = state->freeObjects.back();
+            state->freeObjects.pop_back();
+        }
+        else
+            object = state->nextObject++;
+        state->objects[memory] = object;
+    }
+}
+
+// Take a block out of the table before it is handed back to the target, so
+// that a block allocated at the same address by another thread meanwhile is
+// not confused with it. The block is put back if the request fails. Returns
+// FALSE if the block is not being recorded.
+static MlBoolean
+detachObject(MleRecordingState *state, void *memory, uint_t &object)
+{
+    std::lock_guard<std::mutex> guard(state->lock);
+    std::unordered_map<void *, uint_t>::iterator entry = state->objects.find(memory);
+    if (entry == state->objects.end())
+        return FALSE;
+
+    object = entry->second;
+    state->objects.erase(entry);
+    return TRUE;
+}
+
+static void
+recordResize(MleRecordingState *state, uint_t operation, uint_t object,
+             void *memory, MlULong newSize, MlResult result)
+{
+    std::lock_guard<std::mutex> guard(state->lock);
+    if (! state->recording.load(std::memory_order_relaxed))
+        return;
+
+    beginRecord(state, operation, result);
+    putNumber(state->buffer, object);
+    putNumber(state->buffer, newSize);
+    state->objects[memory] = object;
+}
+
+static void
+recordRelease(MleRecordingState *state, uint_t operation, uint_t object,
+              void *memory, MlResult result)
+{
+    std::lock_guard<std::mutex> guard(state->lock);
+    if (! state->recording.load(std::memory_order_relaxed))
+        return;
+
+    beginRecord(state, operation, result);
+    putNumber(state->buffer, object);
+    if (result == MLE_S_OK)
+        state->freeObjects.push_back(object);
+    else
+        state->objects[memory] = object;
+}
+
+
+MleRecordingMemoryManager::MleRecordingMemoryManager(MleMemoryManager *target)
+  : m_target(target)
+{
+    m_state = new MleRecordingState();
+    m_state->recording.store(false);
+    m_state->file = NULL;
+    m_state->writeFailed = FALSE;
+    m_state->records = 0;
+    m_state->lastThread = 0;
+    m_state->nextObject = 0;
+}
+
+
+MleRecordingMemoryManager::~MleRecordingMemoryManager()
+{
+    stopRecording();
+    delete m_state;
+}
+
+
+MlResult
+MleRecordingMemoryManager::startRecording(const char *filename)
+{
+    MLE_ASSERT(filename != NULL);
+
+    std::lock_guard<std::mutex> guard(m_state->lock);
+    if (m_state->file != NULL)
+        return MLE_E_FAIL;
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+        return MLE_E_FAIL;
+
+    MlByte header[16] = { 'M', 'L', 'E', 'T', 'R', 'A', 'C', 'E' };
+    for (uint_t i = 0; i < 4; i++)
+        header[8 + i] = (MlByte) (TRACE_VERSION >> (8 * i));
+
+    m_state->file = file;
+    m_state->writeFailed = FALSE;
+    m_state->records = 0;
+    m_state->lastThread = 0;
+    m_state->objects.clear();
+    m_state->freeObjects.clear();
+    m_state->nextObject = 0;
+    m_state->buffer.reserve(BUFFER_SIZE);
+    m_state->buffer.assign(header, header + sizeof(header));
+    m_state->recording.store(true, std::memory_order_relaxed);
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleRecordingMemoryManager::stopRecording()
+{
+    std::lock_guard<std::mutex> guard(m_state->lock);
+    if (m_state->file == NULL)
+        return MLE_E_FAIL;
+
+    m_state->recording.store(false, std::memory_order_relaxed);
+    flushBuffer(m_state);
+    if (fclose(m_state->file) != 0)
+        m_state->writeFailed = TRUE;
+    m_state->file = NULL;
+
+    // Blocks still live are forwarded without being recorded from now on.
+    m_state->objects.clear();
+    m_state->freeObjects.clear();
+
+    return m_state->writeFailed ? MLE_E_FAIL : MLE_S_OK;
+}
+
+
+MlULong
+MleRecordingMemoryManager::getRecordCount()
+{
+    std::lock_guard<std::mutex> guard(m_state->lock);
+    return m_state->records;
+}
+
+
+MlResult
+MleRecordingMemoryManager::targetAllocate(void **memory, MlULong size)
+{
+    if (m_target != NULL)
+        return m_target->allocateLarge(memory, size);
+    if (size <= 0xffffffff)
+        return MleMemoryManager::allocate(memory, (uint_t) size);
+    return MleMemoryManager::allocateLarge(memory, size);
+}
+
+
+MlResult
+MleRecordingMemoryManager::targetResize(void **memory, MlULong newSize)
+{
+    if (m_target != NULL)
+        return m_target->resizeLarge(memory, newSize);
+    if (newSize <= 0xffffffff)
+        return MleMemoryManager::resize(memory, (uint_t) newSize);
+    return MleMemoryManager::resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleRecordingMemoryManager::targetRelease(void **memory)
+{
+    if (m_target != NULL)
+        return m_target->release(memory);
+    return MleMemoryManager::release(memory);
+}
+
+
+MlResult
+MleRecordingMemoryManager::allocate(void **memory, uint_t size)
+{
+    return allocateLarge(memory, size);
+}
+
+
+MlResult
+MleRecordingMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    MLE_ASSERT(memory != NULL);
+
+    MlResult result = targetAllocate(memory, size);
+    if (m_state->recording.load(std::memory_order_relaxed))
+        recordAllocation(m_state, ALLOCATE, *memory, size, 0, result);
+    return result;
+}
+
+
+MlResult
+MleRecordingMemoryManager::resize(void **memory, uint_t newSize)
+{
+    return resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleRecordingMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    MLE_ASSERT(memory != NULL);
+
+    uint_t object;
+    if (! m_state->recording.load(std::memory_order_relaxed) ||
+        ! detachObject(m_state, *memory, object))
+        return targetResize(memory, newSize);
+
+    MlResult result = targetResize(memory, newSize);
+    recordResize(m_state, RESIZE, object, *memory, newSize, result);
+    return result;
+}
+
+
+MlResult
+MleRecordingMemoryManager::release(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+
+    uint_t object;
+    void *block = *memory;
+    if (! m_state->recording.load(std::memory_order_relaxed) ||
+        ! detachObject(m_state, block, object))
+        return targetRelease(memory);
+
+    MlResult result = targetRelease(memory);
+    recordRelease(m_state, RELEASE, object, block, result);
+    return result;
+}
+
+
+MlResult
+MleRecordingMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    uint_t object;
+    if (! m_state->recording.load(std::memory_order_relaxed) ||
+        ! detachObject(m_state, memory, object))
+        return (m_target != NULL) ? m_target->tryResizeInPlace(memory, newSize) :
+            MleMemoryManager::tryResizeInPlace(memory, newSize);
+
+    MlResult result = (m_target != NULL) ? m_target->tryResizeInPlace(memory, newSize) :
+        MleMemoryManager::tryResizeInPlace(memory, newSize);
+    recordResize(m_state, RESIZE_IN_PLACE, object, memory, newSize, result);
+    return result;
+}
+
+
+MlULong
+MleRecordingMemoryManager::getUsableSize(void *memory)
+{
+    return (m_target != NULL) ? m_target->getUsableSize(memory) :
+        MleMemoryManager::getUsableSize(memory);
+}
+
+
+MlResult
+MleRecordingMemoryManager::allocateAligned(void **memory, MlULong size, uint_t alignment)
+{
+    MLE_ASSERT(memory != NULL);
+
+    MlResult result = (m_target != NULL) ? m_target->allocateAligned(memory, size, alignment) :
+        MleMemoryManager::allocateAligned(memory, size, alignment);
+    if (m_state->recording.load(std::memory_order_relaxed))
+        recordAllocation(m_state, ALIGNED_ALLOCATE, *memory, size, alignment, result);
+    return result;
+}
+
+
+MlResult
+MleRecordingMemoryManager::releaseAligned(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+
+    uint_t object;
+    void *block = *memory;
+    if (! m_state->recording.load(std::memory_order_relaxed) ||
+        ! detachObject(m_state, block, object))
+        return (m_target != NULL) ? m_target->releaseAligned(memory) :
+            MleMemoryManager::releaseAligned(memory);
+
+    MlResult result = (m_target != NULL) ? m_target->releaseAligned(memory) :
+        MleMemoryManager::releaseAligned(memory);
+    recordRelease(m_state, ALIGNED_RELEASE, object, block, result);
+    return result;
+}
@@ -49,9 +49,21 @@
 #endif
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(_WINDOWS)
+#include <windows.h>
+#endif /* _WINDOWS */
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 // Include Magic Lantern header files.
 #include "mle/MleTemplate.h"
+#include "mle/MleThreadPool.h"
+#include "mle/mlFileio.h"
 
 // Define some tokens.
 #define UNDERSCORE '_'
@@ -64,6 +76,57 @@
 #define SECTION_COMMENT "%#"
 #define SECTION_FLAG "%%"
 
+// The 64 bit FNV-1a parameters, used to hash generated output.
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+// The first line of a manifest file.
+#define MANIFEST_HEADER "# MleTemplateManifest 1"
+
+// Fold bytes into an output hash.
+static MlULong hashBytes(MlULong hash, const char *data, size_t length)
+{
+    for ( size_t i = 0 ; i < length ; i++ )
+	{
+		hash = (hash ^ (unsigned char)data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Advance an output column past a character.
+static inline int advanceColumn(int column, int c)
+{
+    switch ( c )
+	{
+      case '\n':
+		return 1;
+      case '\t':
+		return ((column-1)/8)*8 + 8 + 1;
+      default:
+		return column + 1;
+    }
+}
+
+// Fold text into the column recorded for an instruction; see
+// MleTemplateSection::Op.
+static int composeColumn(int column, const char *text, int length)
+{
+    for ( int i = 0 ; i < length ; i++ )
+	{
+		if ( text[i] == '\n' )
+		{
+			column = 1;
+		} else if ( column > 0 )
+		{
+			column = advanceColumn(column, text[i]);
+		} else if ( text[i] == '\t' )
+		{
+			column = -1;
+		}
+    }
+    return column;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Template
 //////////////////////////////////////////////////////////////////////
@@ -166,11 +229,7 @@ int MleTemplate::read(FILE *fd)
 				if ( pch2 != pch1 )
 				{
 					appendSection(pcursect);
-#if defined(_WINDOWS)
-					pcursect = new MleTemplateSection(_strdup(pch1));
-#else
-					pcursect = new MleTemplateSection(strdup(pch1));
-#endif
+					pcursect = new MleTemplateSection(pch1);
 				}
 			}
 	    
@@ -191,6 +250,34 @@ int MleTemplate::read(FILE *fd)
     return 0;
 }
 
+int MleTemplate::process(MleTemplateJob *jobs, int numJobs, MleThreadPool *pool)
+{
+    if ( pool == NULL )
+	{
+		pool = MleThreadPool::getDefault();
+    }
+
+    // Processing only reads the template and the bindings, so the jobs
+    // need no locking of their own.
+    std::atomic<int> numFailed(0);
+    pool->run(numJobs, [&](int i)
+	{
+		MleTemplateJob &job = jobs[i];
+		MleTemplateProcess process(job.m_section, this, job.m_bindings, job.m_sink);
+		job.m_result = process.go();
+		if ( job.m_sink->flush() != MLE_S_OK )
+		{
+			job.m_result = -1;
+		}
+		if ( job.m_result != 0 )
+		{
+			numFailed++;
+		}
+    });
+
+    return numFailed.load();
+}
+
 void MleTemplate::appendSection(MleTemplateSection *psect)
 {
     if ( psect != NULL )
@@ -203,19 +290,64 @@ void MleTemplate::appendSection(MleTemplateSection *psect)
 		    m_sectionTail->m_next = psect;
 		}
 		m_sectionTail = psect;
+
+		// A later section with the same name is hidden by the first.
+		m_sections.emplace(psect->m_atom, psect);
     }
 }
 
 MleTemplateSection *MleTemplate::lookupSection(const char *name)
 {
-    for (MleTemplateSection *pts = m_sectionHead ; pts != NULL ; pts = pts->m_next)
+    // A name that was never interned cannot name a section.
+    MleAtom atom = MleAtom::find(name);
+    if ( atom.isNull() )
+	{
+		return NULL;
+    }
+
+    MleTemplateSection **ppts = m_sections.find(atom);
+    return (ppts != NULL) ? *ppts : NULL;
+}
+
+MlBoolean MleTemplate::hashSection(const char *name, MleTemplateBindings *bindings, MlULong *hash)
+{
+    MleTemplateSection *pts = lookupSection(name);
+    if ( pts == NULL )
+	{
+		return FALSE;
+    }
+
+    // Follow MleTemplateSection::go(), hashing what it would write.
+    MlULong h = FNV_OFFSET;
+    for ( int i = 0 ; i < pts->m_code.size() ; i++ )
 	{
-		if ( strcmp(pts->m_name, name) == 0 )
+		const MleTemplateSection::Op &op = pts->m_code[i];
+		if ( op.m_type == MleTemplateSection::Op::MACRO )
 		{
-			return pts;
+			int found = (bindings != NULL) ? bindings->hashMacro(op.m_name, &h) : 0;
+			if ( found == 0 && m_globalBindings != NULL )
+			{
+				found = m_globalBindings->hashMacro(op.m_name, &h);
+			}
+			if ( found < 0 )
+			{
+				return FALSE;
+			}
+			if ( found > 0 )
+			{
+				continue;
+			}
 		}
+		h = hashBytes(h, pts->m_text + op.m_offset, op.m_length);
     }
-    return NULL;
+
+    *hash = h;
+    return TRUE;
+}
+
+MlULong MleTemplate::hashOutput(const char *data, size_t length)
+{
+    return hashBytes(FNV_OFFSET, data, length);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -232,6 +364,7 @@ MleTemplateSection::MleTemplateSection(char *name)
 #else
     m_name = strdup(name);
 #endif
+    m_atom = MleAtom(name);
 }
 
 MleTemplateSection::~MleTemplateSection()
@@ -246,8 +379,9 @@ MleTemplateSection::~MleTemplateSection()
 		}
 		ptr2 = ptr;
 		ptr = ptr->m_next;
-		free(ptr2);
+		delete ptr2;
     }
+    free(m_name);
 }
 
 void MleTemplateSection::addStr(char *line)
@@ -264,6 +398,8 @@ void MleTemplateSection::addStr(char *line)
 		m_tail->m_next = pseg;
     }
     m_tail = pseg;
+
+    compile(line);
 }
 
 void MleTemplateSection::addStrDup(char *line)
@@ -275,14 +411,207 @@ void MleTemplateSection::addStrDup(char *line)
 #endif
 }
 
+int MleTemplateSection::addText(const char *text, int length)
+{
+    int offset = m_text.size();
+    if ( length > 0 )
+	{
+		if ( m_text.resize(offset + length) == NULL )
+		{
+			return -1;
+		}
+		memcpy(m_text + offset, text, length);
+    }
+    return offset;
+}
+
+void MleTemplateSection::appendText(const char *text, int length)
+{
+    if ( length == 0 )
+	{
+		return;
+    }
+
+    // Extend the last run of text if nothing has been added since.
+    if ( m_code.size() > 0 )
+	{
+		Op &last = m_code[m_code.size() - 1];
+		if ( last.m_type == Op::TEXT && last.m_offset + last.m_length == m_text.size() )
+		{
+			if ( addText(text, length) >= 0 )
+			{
+				last.m_length += length;
+				last.m_column = composeColumn(last.m_column, text, length);
+			}
+			return;
+		}
+    }
+
+    Op *op = m_code.emplace_back();
+    if ( op == NULL )
+	{
+		return;
+    }
+    if ( (op->m_offset = addText(text, length)) < 0 )
+	{
+		m_code.resize(m_code.size() - 1);
+		return;
+    }
+    op->m_type = Op::TEXT;
+    op->m_length = length;
+    op->m_column = composeColumn(0, text, length);
+    op->m_arg = -1;
+}
+
+void MleTemplateSection::appendMacro(
+    const char *text, int length,
+    const char *name, int nameLength,
+    const char *arg, int argLength)
+{
+    Op *op = m_code.emplace_back();
+    if ( op == NULL )
+	{
+		return;
+    }
+    if ( (op->m_offset = addText(text, length)) < 0 )
+	{
+		m_code.resize(m_code.size() - 1);
+		return;
+    }
+    op->m_type = Op::MACRO;
+    op->m_length = length;
+    op->m_column = 0;
+    op->m_name = MleAtom(name, nameLength);
+    op->m_arg = -1;
+    if ( arg != NULL )
+	{
+		op->m_arg = addText(arg, argLength);
+		addText("", 1);
+    }
+}
+
+//  STATE   \	$   (	)   *
+//    0	    1	2   -	-   -
+//    1	    -	-   -	-   -
+//    2	    1	0   3	0   0
+//    3	    -	-   -	0   -
+//
+// A macro is written ${name} or ${name(arg)}. A backslash before a '$'
+// quotes it. Text that does not complete a macro is copied out as is,
+// except at the end of a line, where it is dropped.
+
+void MleTemplateSection::compile(const char *text)
+{
+    const char *pcur;
+    const char *pliteral = text;
+    const char *pstart, *pmacro0, *pmacro1, *parg0, *parg1;
+    int state = 0;
+
+    pstart = pmacro0 = pmacro1 = parg0 = parg1 = NULL;
+    for ( pcur = text ; *pcur != 0 ; pcur++ )
+	{
+	switch (state)
+	{
+	  case 0:
+	    if (*pcur == '\\')
+		{
+			appendText(pliteral, (int)(pcur - pliteral));
+			state = 1;
+	    } else if (*pcur == START_MACRO)
+		{
+			appendText(pliteral, (int)(pcur - pliteral));
+			pstart = pcur;
+			parg0 = parg1 = NULL;
+			state = 2;
+	    }
+	    break;
+
+	  case 1:
+	    // Keep the backslash unless it quotes a '$'.
+	    pliteral = (*pcur != START_MACRO) ? pcur - 1 : pcur;
+	    state = 0;
+	    break;
+
+	  case 2:
+	    if (*pcur == MACRO_BRACKET1)
+		{
+			pmacro0 = pcur+1;
+			state = 3;
+	    } else
+		{
+			pliteral = pstart;
+			state = 0;
+	    }
+	    break;
+
+	  case 3:
+	    if ( *pcur == MACRO_ARG1 )
+		{
+			pmacro1 = pcur;
+			parg0 = pcur+1;
+			state = 4;
+	    } else if (*pcur == MACRO_BRACKET2)
+		{
+			pmacro1 = pcur;
+			appendMacro(pstart, (int)(pcur+1 - pstart), pmacro0, (int)(pmacro1 - pmacro0), NULL, 0);
+			pliteral = pcur+1;
+			state = 0;
+	    } else if ( ! (isalnum((unsigned char)*pcur)||*pcur==UNDERSCORE) )
+		{
+			pliteral = pstart;
+			state = 0;
+	    }
+	    break;
+
+	  case 4:
+	    if ( *pcur == MACRO_ARG2 )
+		{
+			parg1 = pcur;
+			state = 5;
+	    } else if ( ! (isalnum((unsigned char)*pcur)||*pcur==UNDERSCORE||*pcur==PERCENT_SIGN) )
+		{
+			pliteral = pstart;
+			state = 0;
+	    }
+	    break;
+
+	  case 5:
+	    if ( *pcur == MACRO_BRACKET2 )
+		{
+			appendMacro(pstart, (int)(pcur+1 - pstart), pmacro0, (int)(pmacro1 - pmacro0),
+			            parg0, (int)(parg1 - parg0));
+			pliteral = pcur+1;
+		} else
+		{
+			pliteral = pstart;
+		}
+		state = 0;
+		break;
+	}
+    }
+
+    if ( state == 0 )
+	{
+		appendText(pliteral, (int)(pcur - pliteral));
+    }
+}
+
 int MleTemplateSection::go(MleTemplateProcess *tp)
 {
-    int result = 0;
-    for ( Line *lp = m_head ; lp != NULL ; lp = lp->m_next )
+    for ( int i = 0 ; i < m_code.size() ; i++ )
 	{
-		result += tp->goLine(lp->m_text);
+		const Op &op = m_code[i];
+		if ( op.m_type == Op::MACRO )
+		{
+			char *arg = (op.m_arg >= 0) ? m_text + op.m_arg : NULL;
+			if ( tp->expandMacro(op.m_name, arg) != 0 )
+			{
+				continue;
+			}
+		}
+		tp->outtext(m_text + op.m_offset, op.m_length, op.m_column);
     }
-    return result;
+    return 0;
 }
 
 int MleTemplateSection::copyOut(FILE *pfd)
@@ -294,14 +623,69 @@ int MleTemplateSection::copyOut(FILE *pfd)
     return 0;
 }
 
+int MleTemplateSection::copyOut(MleOutputSink *sink)
+{
+    for ( Line *lp = m_head ; lp != NULL ; lp = lp->m_next )
+	{
+		if ( sink->write(lp->m_text, strlen(lp->m_text)) != MLE_S_OK )
+		{
+			return -1;
+		}
+    }
+    return 0;
+}
+
 //////////////////////////////////////////////////////////////////////
 // MleTemplateBinding
 //////////////////////////////////////////////////////////////////////
 
-MleTemplateBindings::MleTemplateBindings()
+struct MleTemplateBindings::Table
 {
-    m_head = NULL;
-    m_tail = NULL;
+    Table()
+	  : m_refs(1), m_head(NULL), m_tail(NULL)
+    {}
+
+    ~Table()
+    {
+		Binding *pb, *pb2;
+		for ( pb = m_head ; pb != NULL ; pb = pb2 )
+		{
+			pb2 = pb->m_next;
+			delete pb;
+		}
+    }
+
+    std::atomic<int> m_refs;
+
+    Binding *m_head;
+    Binding *m_tail;
+
+    MleHashMap<MleAtom, Binding *> m_index;
+};
+
+MleTemplateBindings::MleTemplateBindings(MleTemplateBindings *parent)
+{
+    m_table = new Table();
+    m_parent = parent;
+}
+
+MleTemplateBindings::MleTemplateBindings(const MleTemplateBindings &bindings)
+{
+    m_table = bindings.m_table;
+    m_table->m_refs.fetch_add(1, std::memory_order_relaxed);
+    m_parent = bindings.m_parent;
+}
+
+MleTemplateBindings &MleTemplateBindings::operator=(const MleTemplateBindings &bindings)
+{
+    if ( m_table != bindings.m_table )
+	{
+		bindings.m_table->m_refs.fetch_add(1, std::memory_order_relaxed);
+		releaseTable(m_table);
+		m_table = bindings.m_table;
+    }
+    m_parent = bindings.m_parent;
+    return *this;
 }
 
 //
@@ -314,78 +698,117 @@ MleTemplateBindings::MleTemplateBindings()
 
 MleTemplateBindings::~MleTemplateBindings()
 {
-    Binding *pb, *pb2;
+    releaseTable(m_table);
+}
+
+void MleTemplateBindings::releaseTable(Table *table)
+{
+    if ( table->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1 )
+	{
+		delete table;
+    }
+}
+
+MleTemplateBindings::Table *MleTemplateBindings::getWritableTable()
+{
+    if ( m_table->m_refs.load(std::memory_order_acquire) == 1 )
+	{
+		return m_table;
+    }
 
-    pb2 = NULL;
-    for ( pb = m_head ; pb != NULL ; pb = pb2 )
+    // Copy the shared bindings, keeping their order.
+    Table *table = new Table();
+    for ( Binding *pb = m_table->m_head ; pb != NULL ; pb = pb->m_next )
 	{
-		pb2 = pb->m_next;
-		delete pb;
+		Binding *copy = new Binding();
+		copy->m_type = pb->m_type;
+		copy->m_name = pb->m_name;
+		copy->m_value = pb->m_value;
+		if ( pb->m_type == Binding::STR )
+		{
+#if defined(_WINDOWS)
+			copy->m_value.m_sval = _strdup(pb->m_value.m_sval);
+#else
+			copy->m_value.m_sval = strdup(pb->m_value.m_sval);
+#endif
+		}
+		copy->m_prev = table->m_tail;
+		copy->m_next = NULL;
+		if ( table->m_head == NULL )
+		{
+			table->m_head = copy;
+		} else
+		{
+			table->m_tail->m_next = copy;
+		}
+		table->m_tail = copy;
+		table->m_index.insert(copy->m_name, copy);
     }
+
+    releaseTable(m_table);
+    m_table = table;
+    return table;
 }
 
 MleTemplateBindings::Binding::~Binding()
 {
+    // The strings are from strdup().
     if ( m_type == STR && m_value.m_sval != NULL )
 	{
-		delete m_value.m_sval;
+		free(m_value.m_sval);
     }
-    delete m_pName;
 }
 
 void MleTemplateBindings::addBinding(Binding *pbinding)
 {
-    if ( m_head == NULL )
+    Table *table = getWritableTable();
+    if ( table->m_head == NULL )
 	{
-		m_head = pbinding;
+		table->m_head = pbinding;
     } else
 	{
-		m_tail->m_next = pbinding;
+		table->m_tail->m_next = pbinding;
     }
-    m_tail = pbinding;
-    m_tail->m_next = NULL;
+    pbinding->m_prev = table->m_tail;
+    pbinding->m_next = NULL;
+    table->m_tail = pbinding;
+    table->m_index.insert(pbinding->m_name, pbinding);
 }
 
 void MleTemplateBindings::defineConstant(const char *name, int _ival)
 {
-    removeBinding(name);
+    MleAtom atom(name);
+    removeBinding(atom);
     Binding *pbinding = new Binding();
     pbinding->m_next = NULL;
     pbinding->m_type = Binding::INT;
-#if defined(_WINDOWS)
-    pbinding->m_pName = _strdup(name);
-#else
-    pbinding->m_pName = strdup(name);
-#endif
+    pbinding->m_name = atom;
     pbinding->m_value.m_ival = _ival;
     addBinding(pbinding);
 }
 
 void MleTemplateBindings::defineConstant(const char *name, double _fval)
 {
-    removeBinding(name);
+    MleAtom atom(name);
+    removeBinding(atom);
     Binding *pbinding = new Binding();
     pbinding->m_next = NULL;
     pbinding->m_type =  Binding::DOUBLE;
-#if defined(_WINDOWS)
-    pbinding->m_pName = _strdup(name);
-#else
-    pbinding->m_pName = strdup(name);
-#endif
+    pbinding->m_name = atom;
     pbinding->m_value.m_fval = _fval;
     addBinding(pbinding);
 }
 void MleTemplateBindings::defineConstant(const char *name, const char *_sval)
 {
-    removeBinding(name);
+    MleAtom atom(name);
+    removeBinding(atom);
     Binding *pbinding = new Binding();
     pbinding->m_next = NULL;
     pbinding->m_type =  Binding::STR;
+    pbinding->m_name = atom;
 #if defined(_WINDOWS)
-    pbinding->m_pName = _strdup(name);
     pbinding->m_value.m_sval = _strdup(_sval);
 #else
-    pbinding->m_pName = strdup(name);
     pbinding->m_value.m_sval = strdup(_sval);
 #endif
 
@@ -397,57 +820,64 @@ void MleTemplateBindings::defineCallback(
     MleTemplateBindingCallback *cb,
     void *clientdata)
 {
-    removeBinding(name);
+    MleAtom atom(name);
+    removeBinding(atom);
     Binding *pbinding = new Binding();
     pbinding->m_next = NULL;
     pbinding->m_type =  Binding::PROC;
-#if defined(_WINDOWS)
-    pbinding->m_pName = _strdup(name);
-#else
-    pbinding->m_pName = strdup(name);
-#endif
+    pbinding->m_name = atom;
     pbinding->m_value.m_cb.m_proc = cb;
     pbinding->m_value.m_cb.m_clientdata = clientdata;
     addBinding(pbinding);
 }
 
-void MleTemplateBindings::removeBinding(const char *name)
+void MleTemplateBindings::removeBinding(const MleAtom &name)
 {
-    Binding *pb, *prev;
-    prev = NULL;
-    for ( pb = m_head ; pb != NULL ; pb = pb->m_next )
-	{
-		if ( strcmp(name, pb->m_pName) == 0 )
-		{
-			break;
-		}
-		prev = pb;
-    }
-    if ( pb == NULL )
+    if ( ! m_table->m_index.contains(name) )
 	{
 		return;
     }
-    if ( prev == NULL )
+    Table *table = getWritableTable();
+    Binding *pb = *table->m_index.find(name);
+    table->m_index.erase(name);
+
+    if ( pb->m_prev == NULL )
 	{
-		m_head = pb->m_next;
+		table->m_head = pb->m_next;
     } else
 	{
-		prev->m_next = pb->m_next;
+		pb->m_prev->m_next = pb->m_next;
     }
-    if ( pb == m_tail )
+    if ( pb->m_next == NULL )
 	{
-		m_tail = prev;
+		table->m_tail = pb->m_prev;
+    } else
+	{
+		pb->m_next->m_prev = pb->m_prev;
     }
     delete pb;
 }
 
 void MleTemplateProcess::outstr(char *str)
 {
-	//while ( *str != NULL )
-    while ( *str != '\0' )
+    outtext(str, (int)strlen(str), -1);
+}
+
+void MleTemplateProcess::outtext(const char *text, int length, int column)
+{
+    m_pSink->write(text, length);
+    if ( column > 0 )
+	{
+		m_column = column;
+    } else if ( column == 0 )
+	{
+		m_column += length;
+    } else
 	{
-		outchar((int)*str);
-		str++;
+		for ( int i = 0 ; i < length ; i++ )
+		{
+			m_column = advanceColumn(m_column, text[i]);
+		}
     }
 }
 
@@ -461,32 +891,58 @@ void MleTemplateProcess::tabTo(int c)
 
 void MleTemplateProcess::outchar(int c)
 {
-    fputc(c, m_pFd);
-    switch ( c )
+    char ch = (char)c;
+    m_pSink->write(&ch, 1);
+    m_column = advanceColumn(m_column, c);
+}
+
+const MleTemplateBindings::Binding *MleTemplateBindings::lookupBinding(const MleAtom &name) const
+{
+    // Search this table, then its parents.
+    for ( const MleTemplateBindings *ptb = this ; ptb != NULL ; ptb = ptb->m_parent )
 	{
-      case '\n':
-		m_column = 1;
-		break;
-      case '\t':
-		m_column = ((m_column-1)/8)*8 + 8 + 1;
-		break;
-      default:
-		m_column++;
+		Binding * const *ppb = ptb->m_table->m_index.find(name);
+		if ( ppb != NULL )
+		{
+			return *ppb;
+		}
     }
+    return NULL;
 }
 
-int MleTemplateBindings::processMacro(char *name, char *arg, MleTemplateProcess *ptp)
+int MleTemplateBindings::hashMacro(const MleAtom &name, MlULong *hash) const
 {
-    Binding *pb;
+    const Binding *pb = lookupBinding(name);
     char cvtbuf[64];
 
-    for ( pb = m_head ; pb != NULL ; pb = pb->m_next )
+    if ( pb == NULL )
 	{
-		if ( strcmp(name, pb->m_pName) == 0 )
-		{
-			break;
-		}
+		return 0;
     }
+    switch ( pb->m_type)
+	{
+      case Binding::INT:
+		sprintf(cvtbuf, "%d", pb->m_value.m_ival);
+		*hash = hashBytes(*hash, cvtbuf, strlen(cvtbuf));
+		break;
+      case Binding::DOUBLE:
+		sprintf(cvtbuf, "%g", pb->m_value.m_fval);
+		*hash = hashBytes(*hash, cvtbuf, strlen(cvtbuf));
+		break;
+      case Binding::STR:
+		*hash = hashBytes(*hash, pb->m_value.m_sval, strlen(pb->m_value.m_sval));
+		break;
+      case Binding::PROC:
+		return -1;
+    }
+    return 1;
+}
+
+int MleTemplateBindings::processMacro(const MleAtom &name, char *arg, MleTemplateProcess *ptp)
+{
+    const Binding *pb = lookupBinding(name);
+    char cvtbuf[64];
+
     if ( pb == NULL )
 	{
 		return 0;
@@ -520,20 +976,40 @@ MleTemplateProcess::MleTemplateProcess(
     MleTemplate *_template,
     MleTemplateBindings *bindings,
     FILE *fd)
+  : m_fileSink(fd)
 {
     m_pSection = name;
     m_pTemplate = _template;
     m_pBindings = bindings;
     m_pFd = fd;
+    m_pSink = &m_fileSink;
+    m_column = 1;
+}
+
+MleTemplateProcess::MleTemplateProcess(
+    const char *name,
+    MleTemplate *_template,
+    MleTemplateBindings *bindings,
+    MleOutputSink *sink)
+  : m_fileSink(NULL)
+{
+    m_pSection = name;
+    m_pTemplate = _template;
+    m_pBindings = bindings;
+    m_pFd = NULL;
+    m_pSink = sink;
     m_column = 1;
 }
 
 MleTemplateProcess::MleTemplateProcess(const char *name, MleTemplateProcess *ptp)
+  : m_fileSink(ptp->m_pFd)
 {
     m_pSection = name;
     m_pTemplate = ptp->m_pTemplate;
     m_pBindings = ptp->m_pBindings;
     m_pFd = ptp->m_pFd;
+    m_pSink = ptp->m_pSink;
+    m_column = ptp->m_column;
 }
 
 MleTemplateProcess::~MleTemplateProcess()
@@ -552,152 +1028,258 @@ int MleTemplateProcess::go()
     return pcursect->go(this);
 }
 
-//  STATE   \	$   (	)   *
-//    0	    1	2   -	-   -
-//    1	    -	-   -	-   -
-//    2	    1	0   3	0   0
-//    3	    -	-   -	0   -
+int MleTemplateProcess::processMacro(const MleAtom &name, char *arg, MleTemplateBindings *pb)
+{
+    if ( pb != NULL )
+	{
+		return pb->processMacro(name, arg, this);
+    }
+    return 0;
+}
 
-int MleTemplateProcess::goLine(char *text)
+// Expand a macro from the local bindings, then the global ones.
+int MleTemplateProcess::expandMacro(const MleAtom &name, char *arg)
 {
-    char *pcur;
-    int state;
-    char *pmacro, *pmacro0, *pmacro1, *parg, *parg0, *parg1, *pstart;
-    
-    pmacro = pmacro0 = pmacro1 = parg = parg0 = parg1 = pstart = NULL;
-    state = 0;
-    for ( pcur = text ; *pcur!=0 ; pcur++)
+    if ( processMacro(name, arg, m_pBindings) != 0 )
 	{
-	switch (state)
+		return 1;
+    }
+    return processMacro(name, arg, m_pTemplate->m_globalBindings);
+}
+
+//////////////////////////////////////////////////////////////////////
+// MleTemplateManifest
+//////////////////////////////////////////////////////////////////////
+
+// Give a new file the permissions of the file it is to replace, if any.
+static int copyFileMode(const char *from, const char *to)
+{
+#if defined(_WINDOWS)
+    struct _stat status;
+    if ( _stat(from, &status) != 0 )
 	{
-	  case 0:
-	    if (*pcur == '\\')
-		{
-			state = 1;
-	    } else if (*pcur == START_MACRO)
-		{
-			pstart = pcur;
-			pmacro0 = pmacro1 = NULL;
-			parg0 = parg1 = NULL;
-			state = 2;
-	    } else
-		{
-			outchar((int)*pcur);
-	    }
-	    break;
+		return (errno == ENOENT) ? 0 : -1;
+    }
+    return _chmod(to, status.st_mode & (_S_IREAD | _S_IWRITE));
+#else
+    struct stat status;
+    if ( stat(from, &status) != 0 )
+	{
+		return (errno == ENOENT) ? 0 : -1;
+    }
+    return chmod(to, status.st_mode & 07777);
+#endif /* _WINDOWS */
+}
 
-	  case 1:
-	    if (*pcur != START_MACRO)
-		{
-			outchar('\\');
-	    }
-	    outchar((int)*pcur);
-	    state = 0;
-	    break;
+// Rename a file over another, which rename() will not do on Windows.
+static int replaceFile(const char *from, const char *to)
+{
+#if defined(_WINDOWS)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    return ::rename(from, to);
+#endif /* _WINDOWS */
+}
 
-	  case 2:
-	    if (*pcur == MACRO_BRACKET1)
-		{
-			pmacro0 = pcur+1;
-			state = 3;
-	    } else
-		{
-#define DUMP_MACRO for ( ; pstart <= pcur ; pstart++ ) { outchar((int)*pstart); }
-			DUMP_MACRO
-			state = 0;
-	    }
-	    break;
+MleTemplateManifest::MleTemplateManifest()
+{
+    m_changed = FALSE;
+}
 
-	  case 3:
-	    if ( *pcur == MACRO_ARG1 )
-		{
-			pmacro1 = pcur-1;
-			pmacro = new char[pmacro1-pmacro0+2];
-			strncpy(pmacro, pmacro0, pmacro1-pmacro0+1);
-			pmacro[pmacro1-pmacro0+1] = 0;
-			parg0 = pcur+1;
-			state = 4;
-			break;
-	    }
-	    if (*pcur == MACRO_BRACKET2)
-		{
-			pmacro1 = pcur-1;
-			pmacro = new char[pmacro1-pmacro0+2];
-			strncpy(pmacro, pmacro0, pmacro1-pmacro0+1);
-			pmacro[pmacro1-pmacro0+1] = 0;
-			if (processMacro(pmacro, NULL, m_pBindings)==0)
-			{
-				if (processMacro(pmacro, NULL, m_pTemplate->m_globalBindings)==0 )
-				{
-					DUMP_MACRO;
-				}
-			}
-			delete pmacro;
-			state = 0;
-			break;
-	    }
-	    if ( ! (isalnum(*pcur)||*pcur==UNDERSCORE) )
-		{
-			DUMP_MACRO;
-			state = 0;
-			break;
-	    }
-	    break;
+MleTemplateManifest::~MleTemplateManifest()
+{
+	// Do nothing for now.
+}
 
-	  case 4:
-	    if ( *pcur == MACRO_ARG2 )
+int MleTemplateManifest::read(const char *filename)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_entries.clear();
+    m_changed = FALSE;
+
+    FILE *fd = fopen(filename, "r");
+    if ( fd == NULL )
+	{
+		return (errno == ENOENT) ? 0 : -1;
+    }
+
+    // Each entry is a line holding a hash and a path. Lines that do not
+    // parse are skipped; their files are regenerated.
+    char pbuf[BUFSIZ];
+    while ( fgets(pbuf, sizeof pbuf, fd) != NULL )
+	{
+		int len = (int)strlen(pbuf);
+		if ( len > 0 && pbuf[len-1] == '\n' )
 		{
-			parg1 = pcur-1;
-			parg = new char[parg1-parg0+2];
-			strncpy(parg, parg0, parg1-parg0+1);
-			parg[parg1-parg0+1] = 0;
-			state = 5;
-			break;
-	    }
-	    if (  ! (isalnum(*pcur)||*pcur==UNDERSCORE||*pcur==PERCENT_SIGN) )
+			pbuf[--len] = 0;
+		}
+
+		char *pend;
+		MlULong hash = strtoull(pbuf, &pend, 16);
+		if ( pend != pbuf + 16 || *pend != ' ' || pend[1] == 0 )
 		{
-			DUMP_MACRO;
-			state = 0;
-			break;
-	    }
-	    break;
+			continue;
+		}
+		m_entries.insert(pend + 1, hash);
+    }
 
-	  case 5:
-	    if ( *pcur == MACRO_BRACKET2 )
+    int result = ferror(fd) ? -1 : 0;
+    fclose(fd);
+    return result;
+}
+
+int MleTemplateManifest::write(const char *filename)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if ( ! m_changed )
+	{
+		return 0;
+    }
+
+    // Write the entries sorted, so that equal manifests are equal files.
+    std::vector<const MleHashMapEntry<std::string, MlULong> *> entries;
+    for ( MleHashMap<std::string, MlULong>::iterator it = m_entries.begin() ; it != m_entries.end() ; ++it )
+	{
+		entries.push_back(&*it);
+    }
+    std::sort(entries.begin(), entries.end(),
+        [](const MleHashMapEntry<std::string, MlULong> *a, const MleHashMapEntry<std::string, MlULong> *b)
+		{ return a->first < b->first; });
+
+    FILE *fd = fopen(filename, "w");
+    if ( fd == NULL )
+	{
+		return -1;
+    }
+    fprintf(fd, "%s\n", MANIFEST_HEADER);
+    for ( size_t i = 0 ; i < entries.size() ; i++ )
+	{
+		fprintf(fd, "%016llx %s\n", (unsigned long long)entries[i]->second, entries[i]->first.c_str());
+    }
+    int result = ferror(fd) ? -1 : 0;
+    if ( fclose(fd) != 0 )
+	{
+		result = -1;
+    }
+
+    if ( result == 0 )
+	{
+		m_changed = FALSE;
+    }
+    return result;
+}
+
+int MleTemplateManifest::generate(
+    MleTemplate *t,
+    const char *sectionName,
+    MleTemplateBindings *bindings,
+    const char *path)
+{
+    MlULong hash, recorded;
+    MlBoolean current = lookup(path, &recorded) && (mlAccess(path, F_OK) == 0);
+
+    // A section that can be hashed without expanding it need not be
+    // expanded if its output is already there.
+    if ( current && t->hashSection(sectionName, bindings, &hash) && hash == recorded )
+	{
+		return UNCHANGED;
+    }
+
+    MleBufferSink buffer;
+    MleTemplateProcess process(sectionName, t, bindings, &buffer);
+    if ( process.go() != 0 || buffer.flush() != MLE_S_OK )
+	{
+		return FAILED;
+    }
+    hash = MleTemplate::hashOutput(buffer.getData(), buffer.getLength());
+    if ( current && hash == recorded )
+	{
+		return UNCHANGED;
+    }
+
+    // Write a temporary file beside the target and rename it into place,
+    // so that a failed write leaves the previous file whole.
+    static std::atomic<unsigned int> s_tempCount(0);
+    std::string temp;
+    int fd = -1;
+    for ( int attempt = 0 ; fd < 0 && attempt < 100 ; attempt++ )
+	{
+		char suffix[32];
+		sprintf(suffix, ".%u.tmp", s_tempCount.fetch_add(1, std::memory_order_relaxed));
+		temp = std::string(path) + suffix;
+		fd = mlOpen(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+		if ( fd < 0 && errno != EEXIST )
 		{
-			if (processMacro(pmacro, parg, m_pBindings)==0)
-			{
-				if (processMacro(pmacro, parg, m_pTemplate->m_globalBindings)==0 )
-				{
-					DUMP_MACRO;
-				}
-			}
-			if ( pmacro != NULL )
-			{
-				delete pmacro;
-			}
-			if ( parg != NULL )
-			{
-				delete parg;
-			}
-			state = 0;
 			break;
 		}
-			DUMP_MACRO;
-			state = 0;
-			break;
+    }
+    if ( fd < 0 )
+	{
+		return FAILED;
+    }
+    MlResult result;
+    {
+		MleFileSink sink(fd);
+		result = sink.write(buffer.getData(), buffer.getLength());
+		if ( result == MLE_S_OK )
+		{
+			result = sink.flush();
 		}
     }
-    return 0;
+    if ( mlClose(fd) != 0 )
+	{
+		result = MLE_E_FAIL;
+    }
+    if ( result == MLE_S_OK &&
+         (copyFileMode(path, temp.c_str()) != 0 || replaceFile(temp.c_str(), path) != 0) )
+	{
+		result = MLE_E_FAIL;
+    }
+    if ( result != MLE_S_OK )
+	{
+		::remove(temp.c_str());
+		return FAILED;
+    }
+    update(path, hash);
+    return WRITTEN;
 }
 
-int MleTemplateProcess::processMacro(char *name, char *arg, MleTemplateBindings *pb)
+MlBoolean MleTemplateManifest::lookup(const char *path, MlULong *hash)
 {
-    if ( pb != NULL )
+    std::lock_guard<std::mutex> guard(m_lock);
+    const MlULong *entry = m_entries.find(path);
+    if ( entry == NULL )
 	{
-		return pb->processMacro(name, arg, this);
+		return FALSE;
     }
-    return 0;
+    *hash = *entry;
+    return TRUE;
+}
+
+void MleTemplateManifest::update(const char *path, MlULong hash)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    MlULong *entry = m_entries.find(path);
+    if ( entry == NULL || *entry != hash )
+	{
+		m_entries.insert(path, hash);
+		m_changed = TRUE;
+    }
+}
+
+void MleTemplateManifest::remove(const char *path)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if ( m_entries.erase(path) )
+	{
+		m_changed = TRUE;
+    }
+}
+
+int MleTemplateManifest::getCount()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_entries.size();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -785,9 +1367,9 @@ void MleTemplateBindings::dump(FILE *fd, int tab)
 {
     TAB;fprintf(fd, "(BINDINGS\n");
     tab++;
-    for ( Binding *pb = m_head ; pb != NULL ; pb = pb->m_next )
+    for ( Binding *pb = m_table->m_head ; pb != NULL ; pb = pb->m_next )
 	{
-		TAB;fprintf(fd, "(\"%s\" ", pb->m_pName);
+		TAB;fprintf(fd, "(\"%s\" ", pb->m_name.getString());
 		switch (pb->m_type)
 		{
 		  case  Binding::INT:
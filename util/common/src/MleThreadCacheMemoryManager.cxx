@@ -0,0 +1,739 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleThreadCacheMemoryManager.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the thread caching memory manager.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleThreadCacheMemoryManager.h"
+
+
+// Payload sizes of the cached size classes.
+static const uint_t g_sizeClasses[] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
+#define NUM_SIZE_CLASSES  (sizeof(g_sizeClasses) / sizeof(g_sizeClasses[0]))
+#define LARGE_CLASS       0xffffffff
+
+// Every block is preceded by a header recording its size class. The header
+// is padded to 16 bytes so that the payload keeps the platform alignment.
+#define HEADER_SIZE       16
+#define BLOCK_IN_USE      0x4d4c5443
+#define BLOCK_FREE        0x6d6c7463
+
+// Central heap spans are carved into blocks of a single size class.
+#define SPAN_SIZE         (64 * 1024)
+
+// Number of managers a single thread may hold caches for at once.
+#define MAX_THREAD_CACHES 4
+
+
+struct BlockHeader
+{
+    uint_t sizeClass;
+    uint_t state;
+    BlockHeader *next;   // Free list link, only valid while the block is free.
+};
+
+// The first bytes of each span link it into its central list.
+struct SpanHeader
+{
+    SpanHeader *next;
+};
+
+struct CentralList
+{
+    std::mutex lock;
+    BlockHeader *head;
+    SpanHeader *spans;
+};
+
+struct MleThreadCache
+{
+    struct List
+	{
+        BlockHeader *head;
+        uint_t count;
+    } lists[NUM_SIZE_CLASSES];
+
+    // Written only by the owning thread, read when counts are aggregated.
+    std::atomic<MlULong> allocationCount;
+
+    MleThreadCache *next;
+};
+
+struct MleThreadCacheHeap
+{
+    MlULong id;
+    MleThreadCacheHeap *nextHeap;
+
+    CentralList central[NUM_SIZE_CLASSES];
+
+    // Thread caches created for this heap and the counts of retired ones.
+    std::mutex cacheLock;
+    MleThreadCache *caches;
+    MlULong retiredCount;
+
+    // Allocations made by threads that could not be given a cache.
+    std::atomic<MlULong> uncachedCount;
+};
+
+
+//
+// Registry of live heaps. Thread exit uses it to find out whether the
+// manager owning a cache still exists; heap ids are never reused.
+//
+static std::atomic<MlULong> g_nextHeapId(1);
+static MleThreadCacheHeap *g_heapRegistry = NULL;
+
+static std::mutex &
+heapRegistryLock()
+{
+    // Never destroyed, so threads exiting during shutdown can still lock it.
+    static std::mutex *lock = new std::mutex();
+    return *lock;
+}
+
+static MleThreadCacheHeap *
+findHeap(MlULong id)
+{
+    for (MleThreadCacheHeap *heap = g_heapRegistry; heap != NULL; heap = heap->nextHeap)
+	{
+        if (heap->id == id)
+            return heap;
+    }
+    return NULL;
+}
+
+
+//
+// Per-thread cache slots. The slots are plain data so that the hot path
+// does not pay for thread_local guard checks; the flusher is armed when
+// the first cache is created and retires the caches at thread exit.
+//
+struct CacheSlot
+{
+    MlULong heapId;
+    MleThreadCache *cache;
+};
+
+static thread_local CacheSlot t_cacheSlots[MAX_THREAD_CACHES];
+
+static void retireThreadCaches();
+
+struct ThreadExitFlusher
+{
+    bool armed;
+    void arm() { armed = true; }
+    ~ThreadExitFlusher() { if (armed) retireThreadCaches(); }
+};
+
+static thread_local ThreadExitFlusher t_flusher;
+
+
+//
+// Large blocks come from the platform allocator through the base class;
+// requests past 32 bits take its 64 bit path.
+//
+static MlResult
+baseAllocate(MleMemoryManager *manager, void **memory, MlULong size)
+{
+    if (size <= 0xffffffff)
+        return manager->MleMemoryManager::allocate(memory, (uint_t) size);
+    return manager->MleMemoryManager::allocateLarge(memory, size);
+}
+
+static MlResult
+baseResize(MleMemoryManager *manager, void **memory, MlULong newSize)
+{
+    if (newSize <= 0xffffffff)
+        return manager->MleMemoryManager::resize(memory, (uint_t) newSize);
+    return manager->MleMemoryManager::resizeLarge(memory, newSize);
+}
+
+
+static inline uint_t
+sizeToClass(uint_t size)
+{
+    if (size <= 128)
+        return (size + 15) / 16 - 1;
+
+    uint_t sizeClass = 8;
+    while (g_sizeClasses[sizeClass] < size)
+        sizeClass++;
+    return sizeClass;
+}
+
+static inline uint_t
+batchSize(uint_t sizeClass)
+{
+    // Move about 16K at a time between a thread cache and the central heap.
+    uint_t count = (16 * 1024) / (g_sizeClasses[sizeClass] + HEADER_SIZE);
+    if (count < 2) count = 2;
+    if (count > 32) count = 32;
+    return count;
+}
+
+
+//
+// Carve a new span into blocks for the central list. Called with the
+// list lock held.
+//
+static MlBoolean
+centralGrow(MleMemoryManager *base, CentralList &list, uint_t sizeClass)
+{
+    void *memory;
+    if (base->MleMemoryManager::allocate(&memory, SPAN_SIZE) != MLE_S_OK)
+        return FALSE;
+
+    SpanHeader *span = (SpanHeader *) memory;
+    span->next = list.spans;
+    list.spans = span;
+
+    uint_t stride = g_sizeClasses[sizeClass] + HEADER_SIZE;
+    uint_t count = (SPAN_SIZE - HEADER_SIZE) / stride;
+    char *block = (char *) memory + HEADER_SIZE;
+    for (uint_t i = 0; i < count; i++, block += stride)
+	{
+        BlockHeader *header = (BlockHeader *) block;
+        header->sizeClass = sizeClass;
+        header->state = BLOCK_FREE;
+        header->next = list.head;
+        list.head = header;
+    }
+    return TRUE;
+}
+
+//
+// Take up to count blocks from the central list. Returns the number of
+// blocks placed on the chain.
+//
+static uint_t
+centralFetch(MleMemoryManager *base, CentralList &list, uint_t sizeClass,
+    uint_t count, BlockHeader **chain)
+{
+    std::lock_guard<std::mutex> guard(list.lock);
+
+    if (list.head == NULL && ! centralGrow(base, list, sizeClass))
+        return 0;
+
+    BlockHeader *first = list.head;
+    BlockHeader *last = first;
+    uint_t taken = 1;
+    while (taken < count && last->next != NULL)
+	{
+        last = last->next;
+        taken++;
+    }
+    list.head = last->next;
+    last->next = NULL;
+
+    *chain = first;
+    return taken;
+}
+
+//
+// Give a chain of blocks back to the central list.
+//
+static void
+centralReturn(CentralList &list, BlockHeader *first, BlockHeader *last)
+{
+    std::lock_guard<std::mutex> guard(list.lock);
+    last->next = list.head;
+    list.head = first;
+}
+
+//
+// Return every block held by a thread cache to the central heap.
+//
+static void
+drainThreadCache(MleThreadCacheHeap *heap, MleThreadCache *cache)
+{
+    for (uint_t c = 0; c < NUM_SIZE_CLASSES; c++)
+	{
+        MleThreadCache::List &list = cache->lists[c];
+        if (list.head == NULL)
+            continue;
+
+        BlockHeader *last = list.head;
+        while (last->next != NULL)
+            last = last->next;
+        centralReturn(heap->central[c], list.head, last);
+        list.head = NULL;
+        list.count = 0;
+    }
+}
+
+//
+// Thread exit: hand the calling thread's caches back to their heaps.
+//
+static void
+retireThreadCaches()
+{
+    std::lock_guard<std::mutex> registryGuard(heapRegistryLock());
+
+    for (int i = 0; i < MAX_THREAD_CACHES; i++)
+	{
+        CacheSlot &slot = t_cacheSlots[i];
+        if (slot.heapId == 0)
+            continue;
+
+        // If the manager is gone, it has already freed the cache.
+        MleThreadCacheHeap *heap = findHeap(slot.heapId);
+        if (heap != NULL)
+		{
+            MleThreadCache *cache = slot.cache;
+            drainThreadCache(heap, cache);
+
+            std::lock_guard<std::mutex> cacheGuard(heap->cacheLock);
+            MleThreadCache **link = &heap->caches;
+            while (*link != cache)
+                link = &(*link)->next;
+            *link = cache->next;
+            heap->retiredCount += cache->allocationCount.load(std::memory_order_relaxed);
+            delete cache;
+        }
+
+        slot.heapId = 0;
+        slot.cache = NULL;
+    }
+}
+
+//
+// Find, or create, the calling thread's cache for a heap. Returns NULL if
+// the thread already holds caches for too many live managers.
+//
+static MleThreadCache *
+lookupThreadCache(MleThreadCacheHeap *heap)
+{
+    for (int i = 0; i < MAX_THREAD_CACHES; i++)
+	{
+        if (t_cacheSlots[i].heapId == heap->id)
+            return t_cacheSlots[i].cache;
+    }
+
+    int freeSlot = -1;
+    for (int i = 0; i < MAX_THREAD_CACHES && freeSlot < 0; i++)
+	{
+        if (t_cacheSlots[i].heapId == 0)
+            freeSlot = i;
+    }
+
+    if (freeSlot < 0)
+	{
+        // Reclaim slots left behind by managers that have been destroyed.
+        std::lock_guard<std::mutex> registryGuard(heapRegistryLock());
+        for (int i = 0; i < MAX_THREAD_CACHES; i++)
+		{
+            if (findHeap(t_cacheSlots[i].heapId) == NULL)
+			{
+                t_cacheSlots[i].heapId = 0;
+                t_cacheSlots[i].cache = NULL;
+                if (freeSlot < 0)
+                    freeSlot = i;
+            }
+        }
+        if (freeSlot < 0)
+            return NULL;
+    }
+
+    MleThreadCache *cache = new (std::nothrow) MleThreadCache();
+    if (cache == NULL)
+        return NULL;
+    memset(cache->lists, 0, sizeof(cache->lists));
+    cache->allocationCount.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> cacheGuard(heap->cacheLock);
+        cache->next = heap->caches;
+        heap->caches = cache;
+    }
+
+    t_cacheSlots[freeSlot].heapId = heap->id;
+    t_cacheSlots[freeSlot].cache = cache;
+    t_flusher.arm();
+
+    return cache;
+}
+
+static inline void
+countAllocation(MleThreadCacheHeap *heap, MleThreadCache *cache)
+{
+    if (cache != NULL)
+	{
+        // Single writer, so a plain load and store is enough.
+        MlULong count = cache->allocationCount.load(std::memory_order_relaxed);
+        cache->allocationCount.store(count + 1, std::memory_order_relaxed);
+    }
+    else
+        heap->uncachedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+MleThreadCacheMemoryManager::MleThreadCacheMemoryManager()
+{
+    m_heap = new MleThreadCacheHeap();
+    m_heap->id = g_nextHeapId.fetch_add(1);
+    for (uint_t c = 0; c < NUM_SIZE_CLASSES; c++)
+	{
+        m_heap->central[c].head = NULL;
+        m_heap->central[c].spans = NULL;
+    }
+    m_heap->caches = NULL;
+    m_heap->retiredCount = 0;
+    m_heap->uncachedCount.store(0);
+
+    std::lock_guard<std::mutex> registryGuard(heapRegistryLock());
+    m_heap->nextHeap = g_heapRegistry;
+    g_heapRegistry = m_heap;
+}
+
+
+MleThreadCacheMemoryManager::~MleThreadCacheMemoryManager()
+{
+    {
+        std::lock_guard<std::mutex> registryGuard(heapRegistryLock());
+        MleThreadCacheHeap **link = &g_heapRegistry;
+        while (*link != m_heap)
+            link = &(*link)->nextHeap;
+        *link = m_heap->nextHeap;
+    }
+
+    // Other threads may still name the caches in their slots, but they will
+    // no longer find the heap and so never touch them.
+    for (MleThreadCache *cache = m_heap->caches; cache != NULL; )
+	{
+        MleThreadCache *next = cache->next;
+        delete cache;
+        cache = next;
+    }
+
+    for (uint_t c = 0; c < NUM_SIZE_CLASSES; c++)
+	{
+        for (SpanHeader *span = m_heap->central[c].spans; span != NULL; )
+		{
+            void *memory = span;
+            span = span->next;
+            MleMemoryManager::release(&memory);
+        }
+    }
+
+    delete m_heap;
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::allocate(void **memory, uint_t size)
+{
+    MLE_ASSERT(size > 0);
+    if (size == 0)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    BlockHeader *header;
+    MleThreadCache *cache = lookupThreadCache(m_heap);
+
+    if (size <= MAX_CACHED_SIZE)
+	{
+        if (! allocationAllowed())
+		{
+            return MLE_E_FAIL;
+        }
+
+        uint_t sizeClass = sizeToClass(size);
+        if (cache != NULL)
+		{
+            MleThreadCache::List &list = cache->lists[sizeClass];
+            if (list.head == NULL)
+			{
+                list.count = centralFetch(this, m_heap->central[sizeClass],
+                    sizeClass, batchSize(sizeClass), &list.head);
+                if (list.count == 0)
+				{
+                    return MLE_E_FAIL;
+                }
+            }
+            header = list.head;
+            list.head = header->next;
+            list.count--;
+        }
+        else if (centralFetch(this, m_heap->central[sizeClass], sizeClass, 1, &header) == 0)
+		{
+            return MLE_E_FAIL;
+        }
+    }
+    else
+	{
+        return allocateLarge(memory, size);
+    }
+
+    header->state = BLOCK_IN_USE;
+    countAllocation(m_heap, cache);
+
+    *memory = (char *) header + HEADER_SIZE;
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    if (size <= MAX_CACHED_SIZE)
+	{
+        return allocate(memory, (uint_t) size);
+    }
+
+    void *raw;
+    if (baseAllocate(this, &raw, size + HEADER_SIZE) != MLE_S_OK)
+	{
+        return MLE_E_FAIL;
+    }
+    BlockHeader *header = (BlockHeader *) raw;
+    header->sizeClass = LARGE_CLASS;
+    header->state = BLOCK_IN_USE;
+    countAllocation(m_heap, lookupThreadCache(m_heap));
+
+    *memory = (char *) header + HEADER_SIZE;
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::resize(void **memory, uint_t newSize)
+{
+    MLE_ASSERT(newSize > 0);
+    return resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    MLE_ASSERT(memory != NULL);
+    if (newSize == 0 || memory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    if (*memory == NULL)
+	{
+        return allocateLarge(memory, newSize);
+    }
+
+    BlockHeader *header = (BlockHeader *) ((char *) *memory - HEADER_SIZE);
+    MLE_ASSERT(header->state == BLOCK_IN_USE);
+    if (header->state != BLOCK_IN_USE)
+	{
+        return MLE_E_FAIL;
+    }
+
+    if (header->sizeClass == LARGE_CLASS)
+	{
+        void *raw = header;
+        if (baseResize(this, &raw, newSize + HEADER_SIZE) != MLE_S_OK)
+		{
+            return MLE_E_FAIL;
+        }
+        countAllocation(m_heap, lookupThreadCache(m_heap));
+        *memory = (char *) raw + HEADER_SIZE;
+        return MLE_S_OK;
+    }
+
+    uint_t oldSize = g_sizeClasses[header->sizeClass];
+    if (newSize <= oldSize)
+	{
+        // Still fits the size class, so the block stays where it is.
+        if (! allocationAllowed())
+		{
+            return MLE_E_FAIL;
+        }
+        countAllocation(m_heap, lookupThreadCache(m_heap));
+        return MLE_S_OK;
+    }
+
+    void *newMemory;
+    if (allocateLarge(&newMemory, newSize) != MLE_S_OK)
+	{
+        return MLE_E_FAIL;
+    }
+    memcpy(newMemory, *memory, oldSize);
+    release(memory);
+    *memory = newMemory;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::release(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+    if (memory == NULL)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    if (*memory == NULL)
+	{
+        return MLE_S_OK;
+    }
+
+    BlockHeader *header = (BlockHeader *) ((char *) *memory - HEADER_SIZE);
+    MLE_ASSERT(header->state == BLOCK_IN_USE);
+    if (header->state != BLOCK_IN_USE)
+	{
+        return MLE_E_FAIL;
+    }
+    header->state = BLOCK_FREE;
+
+    if (header->sizeClass == LARGE_CLASS)
+	{
+        void *raw = header;
+        if (MleMemoryManager::release(&raw) != MLE_S_OK)
+		{
+            header->state = BLOCK_IN_USE;
+            return MLE_E_FAIL;
+        }
+        *memory = NULL;
+        return MLE_S_OK;
+    }
+
+    uint_t sizeClass = header->sizeClass;
+    MleThreadCache *cache = lookupThreadCache(m_heap);
+    if (cache != NULL)
+	{
+        MleThreadCache::List &list = cache->lists[sizeClass];
+        header->next = list.head;
+        list.head = header;
+        list.count++;
+
+        // Keep the cache bounded; hand a batch back once it holds two.
+        uint_t batch = batchSize(sizeClass);
+        if (list.count > 2 * batch)
+		{
+            BlockHeader *last = list.head;
+            for (uint_t i = 1; i < batch; i++)
+                last = last->next;
+            BlockHeader *first = list.head;
+            list.head = last->next;
+            list.count -= batch;
+            centralReturn(m_heap->central[sizeClass], first, last);
+        }
+    }
+    else
+	{
+        centralReturn(m_heap->central[sizeClass], header, header);
+    }
+
+    *memory = NULL;
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleThreadCacheMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    MLE_ASSERT(newSize > 0);
+    if (memory == NULL || newSize == 0)
+	{
+	    return MLE_E_FAIL;
+    }
+
+    return (getUsableSize(memory) >= newSize) ? MLE_S_OK : MLE_E_FAIL;
+}
+
+
+MlULong
+MleThreadCacheMemoryManager::getUsableSize(void *memory)
+{
+    if (memory == NULL)
+	{
+	    return 0;
+    }
+
+    BlockHeader *header = (BlockHeader *) ((char *) memory - HEADER_SIZE);
+    MLE_ASSERT(header->state == BLOCK_IN_USE);
+    if (header->sizeClass != LARGE_CLASS)
+	{
+        return g_sizeClasses[header->sizeClass];
+    }
+
+    MlULong usable = MleMemoryManager::getUsableSize(header);
+    return (usable > HEADER_SIZE) ? usable - HEADER_SIZE : 0;
+}
+
+
+void
+MleThreadCacheMemoryManager::flushThreadCache()
+{
+    for (int i = 0; i < MAX_THREAD_CACHES; i++)
+	{
+        if (t_cacheSlots[i].heapId == m_heap->id)
+		{
+            drainThreadCache(m_heap, t_cacheSlots[i].cache);
+            return;
+        }
+    }
+}
+
+
+MlULong
+MleThreadCacheMemoryManager::getAllocationCount()
+{
+    std::lock_guard<std::mutex> cacheGuard(m_heap->cacheLock);
+
+    MlULong count = m_heap->retiredCount +
+        m_heap->uncachedCount.load(std::memory_order_relaxed);
+    for (MleThreadCache *cache = m_heap->caches; cache != NULL; cache = cache->next)
+	{
+        count += cache->allocationCount.load(std::memory_order_relaxed);
+    }
+    return count;
+}
@@ -0,0 +1,151 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleThreadPool.cxx
+ *  @ingroup MleCore
+ *
+ *  A pool of worker threads for running loops in parallel.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <stdlib.h>
+
+// Include Magic Lantern header files.
+#include "mle/MleThreadPool.h"
+
+
+// Set while the thread is running the iterations of a loop, to run nested loops in place.
+static thread_local MlBoolean g_inLoop = FALSE;
+
+
+MleThreadPool::MleThreadPool(uint_t numThreads)
+  : m_generation(0), m_busy(0), m_stop(FALSE), m_body(NULL), m_count(0)
+{
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    m_next.store(0);
+
+    for (uint_t i = 1; i < numThreads; i++)
+        m_workers.push_back(std::thread(&MleThreadPool::work, this));
+}
+
+
+MleThreadPool::~MleThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = TRUE;
+    }
+    m_wake.notify_all();
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+        m_workers[i].join();
+}
+
+
+void
+MleThreadPool::run(int count, const std::function<void (int)> &body)
+{
+    if (count <= 0)
+        return;
+
+    std::unique_lock<std::mutex> running(m_runLock, std::defer_lock);
+    if (m_workers.empty() || count == 1 || g_inLoop || ! running.try_lock())
+	{
+        for (int i = 0; i < count; i++)
+            body(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_body = &body;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = (uint_t) m_workers.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    runIterations();
+
+    // The body may not be released until every worker is done with it.
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (m_busy > 0)
+        m_done.wait(guard);
+    m_body = NULL;
+}
+
+
+void
+MleThreadPool::work()
+{
+    MlULong seen = 0;
+    std::unique_lock<std::mutex> guard(m_lock);
+    for (;;)
+	{
+        while (! m_stop && m_generation == seen)
+            m_wake.wait(guard);
+        if (m_stop)
+            return;
+        seen = m_generation;
+
+        guard.unlock();
+        runIterations();
+        guard.lock();
+
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+
+void
+MleThreadPool::runIterations()
+{
+    g_inLoop = TRUE;
+    for (int i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+        (*m_body)(i);
+    g_inLoop = FALSE;
+}
+
+
+MleThreadPool *
+MleThreadPool::getDefault()
+{
+    static MleThreadPool pool;
+    return &pool;
+}
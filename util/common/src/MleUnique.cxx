@@ -0,0 +1,77 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleUnique.cxx
+ *  @ingroup MleCore
+ *
+ *  The mlUnique() function, built on the sort based strategy of MleUnique.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlUnique.h"
+#include "mle/MleUnique.h"
+
+
+int
+mlUniqueOrdered(void *ap, int n, int size, int (*compare)(const void *, const void *))
+{
+    if (n <= 1)
+        return (n > 0) ? n : 0;
+
+    char *base = (char *) ap;
+    auto less = [base, size, compare](int a, int b) -> bool
+        { return compare(base + (size_t) a * size, base + (size_t) b * size) < 0; };
+    MlUChar *first = MleUnique::findFirstOccurrences(n, less);
+    if (first == NULL)
+        return mlUnique(ap, n, size, compare);
+
+    int kept = 0;
+    for (int i = 0; i < n; i++)
+	{
+        if (first[i])
+		{
+            if (kept != i)
+                memcpy(base + (size_t) kept * size, base + (size_t) i * size, size);
+            kept++;
+        }
+    }
+
+    mlFree(first);
+    return kept;
+}
@@ -367,12 +367,18 @@ static void appendStr(VStr *vstr, char *str)
 static void appendChar(VStr *vstr, char ch)
 {
     if (vstr->used+1 >= vstr->allocked) {
+        size_t usable;
         vstr->allocked += ALLOC_INC;
         if (vstr->str==NULL) {
             vstr->str = (char *)mlMalloc(vstr->allocked);
         } else {
             vstr->str = (char *)mlRealloc(vstr->str, vstr->allocked);
         }
+        /* Use any slack the allocator gave us before growing again. */
+        usable = mlMallocUsableSize(vstr->str);
+        if (usable > (size_t) vstr->allocked) {
+            vstr->allocked = (int) usable;
+        }
     }
     vstr->str[vstr->used++] = ch;
     vstr->str[vstr->used] = NIL;
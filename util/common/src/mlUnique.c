@@ -41,6 +41,7 @@
 // COPYRIGHT_END
 
 // Include system header files.
+#include <stddef.h>
 #include <memory.h>
 
 // Inlude Magic Lantern header files.
@@ -49,36 +50,41 @@
 /*
  * mleUnique - return an array identical to the input but with duplicate entries
  * compressed out.
+ *
+ * Each entry is compared with the entries kept before it and copied down
+ * once if it matches none of them, so the array is compacted in a single
+ * pass. See mlUniqueOrdered() in MleUnique.cxx for large arrays.
  */
 
 int
 mlUnique(void *ap, int n, int size, int(*compare)(const void *, const void *))
 {
-    int i, j;
+    char *base = (char *)ap;
+    int i, j, kept;
 
-    for ( i = 0; i < n-1 ; i++ )
+    kept = 0;
+    for ( i = 0 ; i < n ; i++ )
 	{
-		for ( j = i+1 ; j < n ; )
+		char *entry = base + (size_t)i*size;
+		for ( j = 0 ; j < kept ; j++ )
 		{
-			if ( compare(((char *)ap)+i*size, ((char *)ap)+j*size) == 0 )
+			if ( compare(base + (size_t)j*size, entry) == 0 )
 			{
-#if 0
-				int k;
-				for ( k = j+1 ; k < n ; k++ )
-				{
-				   memcpy(((char *)ap)+(k-1)*size, ((char *)ap)+k*size, size);
- 				}
-#endif
-				memcpy(((char *)ap)+j*size, ((char *)ap)+(j+1)*size, (n-(j+1))*size);
-				n--;
-			} else {
-				j++;
+				break;
 			}
 		}
+		if ( j == kept )
+		{
+			if ( kept != i )
+			{
+				memcpy(base + (size_t)kept*size, entry, size);
+			}
+			kept++;
+		}
     }
-    return n;
+    return kept;
 }
-	    
+
 #ifdef UNIT_TEST
 
 //#include <unistd.h>
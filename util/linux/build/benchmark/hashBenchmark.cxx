@@ -0,0 +1,237 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file hashBenchmark.cxx
+ *  @ingroup MleCore
+ *
+ *  Compare the speed of MleHashMap with std::unordered_map for integer
+ *  and string keys.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Include Magic Lantern utility header files.
+#include "mle/mlHashTable.h"
+
+
+static void
+usage()
+{
+    fprintf(stderr, "usage: hashBenchmark [-n entries] [-p passes]\n");
+    exit(1);
+}
+
+// Time passes of an operation over all the keys and return the
+// nanoseconds per key.
+template <class F> static double
+measure(F operation, int count, int passes)
+{
+    std::chrono::steady_clock::duration total(0);
+    for (int pass = 0; pass < passes; pass++)
+	{
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        operation();
+        total += std::chrono::steady_clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(total).count() / ((double) count * passes);
+}
+
+static void
+report(const char *name, double mle, double std)
+{
+    printf("  %-24s %8.2f ns  %8.2f ns  %5.1fx\n", name, mle, std, std / mle);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int count = 1000000;
+    int passes = 5;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:p:")) != -1)
+	{
+        switch (option)
+		{
+          case 'n':
+            count = atoi(optarg);
+            break;
+          case 'p':
+            passes = atoi(optarg);
+            break;
+          default:
+            usage();
+        }
+    }
+    if ((optind != argc) || (count <= 0) || (passes <= 0))
+        usage();
+
+    // Keys in a random order, and as many that are not in the tables.
+    std::vector<int> keys(count);
+    std::vector<int> missing(count);
+    srand(1);
+    for (int i = 0; i < count; i++)
+	{
+        keys[i] = i * 2;
+        missing[i] = i * 2 + 1;
+    }
+    for (int i = count - 1; i > 0; i--)
+	{
+        int j = rand() % (i + 1);
+        std::swap(keys[i], keys[j]);
+        std::swap(missing[i], missing[j]);
+    }
+
+    printf("%d entries, %d passes\n", count, passes);
+    printf("  %-24s %11s  %11s  %6s\n", "", "MleHashMap", "unordered", "");
+    volatile long long sink = 0;
+
+    printf("int keys\n");
+    MleHashMap<int, int> mle;
+    std::unordered_map<int, int> std;
+    double m = measure([&]()
+    {
+        mle.clear();
+        for (int i = 0; i < count; i++)
+            mle.insert(keys[i], i);
+    }, count, passes);
+    double s = measure([&]()
+    {
+        std.clear();
+        for (int i = 0; i < count; i++)
+            std[keys[i]] = i;
+    }, count, passes);
+    report("insert", m, s);
+
+    m = measure([&]()
+    {
+        long long total = 0;
+        for (int i = 0; i < count; i++)
+            total += *mle.find(keys[i]);
+        sink = total;
+    }, count, passes);
+    s = measure([&]()
+    {
+        long long total = 0;
+        for (int i = 0; i < count; i++)
+            total += std.find(keys[i])->second;
+        sink = total;
+    }, count, passes);
+    report("find, present", m, s);
+
+    m = measure([&]()
+    {
+        int found = 0;
+        for (int i = 0; i < count; i++)
+            found += mle.contains(missing[i]);
+        sink = found;
+    }, count, passes);
+    s = measure([&]()
+    {
+        int found = 0;
+        for (int i = 0; i < count; i++)
+            found += (int) std.count(missing[i]);
+        sink = found;
+    }, count, passes);
+    report("find, absent", m, s);
+
+    m = measure([&]()
+    {
+        for (int i = 0; i < count; i++)
+            mle.erase(keys[i]);
+        for (int i = 0; i < count; i++)
+            mle.insert(keys[i], i);
+    }, count * 2, passes);
+    s = measure([&]()
+    {
+        for (int i = 0; i < count; i++)
+            std.erase(keys[i]);
+        for (int i = 0; i < count; i++)
+            std[keys[i]] = i;
+    }, count * 2, passes);
+    report("erase and insert", m, s);
+
+    // Names of the length of typical class and property names.
+    printf("string keys, found by const char *\n");
+    std::vector<std::string> names(count);
+    for (int i = 0; i < count; i++)
+	{
+        char name[32];
+        snprintf(name, sizeof(name), "MleActorProperty%d", keys[i]);
+        names[i] = name;
+    }
+    MleHashMap<std::string, int> mleNames;
+    std::unordered_map<std::string, int> stdNames;
+    m = measure([&]()
+    {
+        mleNames.clear();
+        for (int i = 0; i < count; i++)
+            mleNames.insert(names[i], i);
+    }, count, passes);
+    s = measure([&]()
+    {
+        stdNames.clear();
+        for (int i = 0; i < count; i++)
+            stdNames[names[i]] = i;
+    }, count, passes);
+    report("insert", m, s);
+
+    m = measure([&]()
+    {
+        long long total = 0;
+        for (int i = 0; i < count; i++)
+            total += *mleNames.find(names[i].c_str());
+        sink = total;
+    }, count, passes);
+    s = measure([&]()
+    {
+        long long total = 0;
+        for (int i = 0; i < count; i++)
+            total += stdNames.find(names[i].c_str())->second;
+        sink = total;
+    }, count, passes);
+    report("find", m, s);
+
+    return 0;
+}
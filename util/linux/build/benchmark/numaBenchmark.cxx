@@ -0,0 +1,206 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file numaBenchmark.cxx
+ *  @ingroup MleCore
+ *
+ *  Compare memory bandwidth of buffers placed by first touch with
+ *  buffers placed on the node of the thread using them.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Include Magic Lantern utility header files.
+#include "mle/MleLinuxNumaMemoryManager.h"
+
+
+// Sample one page in this many when looking for remote pages.
+#define PAGE_SAMPLE     16
+
+struct Result
+{
+    double gigabytesPerSecond;
+    double remoteFraction;      // Negative if unknown.
+};
+
+
+static void
+usage()
+{
+    fprintf(stderr,
+        "usage: numaBenchmark [-t threads per node] [-s MB per thread] [-p passes]\n"
+        "Set MleNumaFakeNodes to exercise the code paths on a single node.\n");
+    exit(1);
+}
+
+// Add to every word of a buffer and return a checksum, so that each pass
+// reads and writes the whole buffer.
+static MlULong
+sweep(MlULong *words, size_t count)
+{
+    MlULong sum = 0;
+    for (size_t i = 0; i < count; i++)
+	{
+        words[i] += i;
+        sum += words[i];
+    }
+    return sum;
+}
+
+static Result
+run(MleLinuxNumaMemoryManager &numa, MlBoolean placeOnNode,
+    uint_t threadsPerNode, size_t size, uint_t passes)
+{
+    uint_t numNodes = numa.getNodeCount();
+    uint_t numThreads = numNodes * threadsPerNode;
+    MleMemoryManager plain;
+    std::vector<void *> buffers(numThreads, (void *) NULL);
+
+    // The buffers are all set up by this thread, as a loader thread would,
+    // so with first touch they all land on its node.
+    for (uint_t i = 0; i < numThreads; i++)
+	{
+        uint_t node = i % numNodes;
+        MlResult result = placeOnNode ? numa.allocateOnNode(&buffers[i], size, node) :
+            plain.allocateLarge(&buffers[i], size);
+        if (result != MLE_S_OK)
+		{
+            fprintf(stderr, "numaBenchmark: cannot allocate %lu bytes\n", (unsigned long) size);
+            exit(1);
+        }
+        memset(buffers[i], 0, size);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<MlULong> sums(numThreads, 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint_t i = 0; i < numThreads; i++)
+	{
+        threads.push_back(std::thread([&numa, &buffers, &sums, i, numNodes, size, passes]()
+        {
+            numa.bindThreadToNode(i % numNodes);
+            for (uint_t pass = 0; pass < passes; pass++)
+                sums[i] += sweep((MlULong *) buffers[i], size / sizeof(MlULong));
+        }));
+    }
+    for (uint_t i = 0; i < numThreads; i++)
+        threads[i].join();
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+
+    // Count the sampled pages that are not on the node of their thread.
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    MlULong sampled = 0, remote = 0;
+    for (uint_t i = 0; i < numThreads; i++)
+	{
+        for (size_t offset = 0; offset < size; offset += pageSize * PAGE_SAMPLE)
+		{
+            MlInt node = numa.getResidentNode((MlUChar *) buffers[i] + offset);
+            if (node < 0)
+                continue;
+            sampled++;
+            if ((uint_t) node != i % numNodes)
+                remote++;
+        }
+        if (placeOnNode)
+            numa.release(&buffers[i]);
+        else
+            plain.release(&buffers[i]);
+    }
+
+    double seconds = std::chrono::duration<double>(finish - start).count();
+    Result result;
+    result.gigabytesPerSecond = 2.0 * (double) size * numThreads * passes / seconds / 1e9;
+    result.remoteFraction = (sampled != 0) ? (double) remote / (double) sampled : -1.0;
+    return result;
+}
+
+static void
+report(const char *name, const Result &result)
+{
+    printf("  %-12s %8.2f GB/s", name, result.gigabytesPerSecond);
+    if (result.remoteFraction >= 0.0)
+        printf("   remote pages %5.1f%%\n", result.remoteFraction * 100.0);
+    else
+        printf("   remote pages unknown\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint_t threadsPerNode = 1;
+    size_t megabytes = 64;
+    uint_t passes = 10;
+
+    int option;
+    while ((option = getopt(argc, argv, "t:s:p:")) != -1)
+	{
+        switch (option)
+		{
+          case 't':
+            threadsPerNode = (uint_t) atoi(optarg);
+            break;
+          case 's':
+            megabytes = (size_t) atoi(optarg);
+            break;
+          case 'p':
+            passes = (uint_t) atoi(optarg);
+            break;
+          default:
+            usage();
+        }
+    }
+    if ((optind != argc) || (threadsPerNode == 0) || (megabytes == 0) || (passes == 0))
+        usage();
+
+    MleLinuxNumaMemoryManager numa;
+    printf("nodes %u%s, %u thread(s) per node, %lu MB per thread, %u passes\n",
+        numa.getNodeCount(), numa.isFakeTopology() ? " (fake)" : "",
+        threadsPerNode, (unsigned long) megabytes, passes);
+
+    size_t size = megabytes * 1024 * 1024;
+    report("first touch", run(numa, FALSE, threadsPerNode, size, passes));
+    report("on node", run(numa, TRUE, threadsPerNode, size, passes));
+
+    return 0;
+}
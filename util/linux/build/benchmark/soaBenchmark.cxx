@@ -0,0 +1,193 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file soaBenchmark.cxx
+ *  @ingroup MleCore
+ *
+ *  Compare the speed of scanning one field of many records stored as an
+ *  array of structures with the same records stored as a structure of
+ *  arrays.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+
+// Include Magic Lantern utility header files.
+#include "mle/mlArray.h"
+#include "mle/mlSoAArray.h"
+#include "mle/MleArrayOps.h"
+
+
+// A typical per-actor record of 64 bytes.
+struct Actor
+{
+    float m_x, m_y, m_z;
+    float m_vx, m_vy, m_vz;
+    float m_health;
+    int m_id;
+    float m_bounds[6];
+    void *m_owner;
+};
+
+typedef MleSoAArray<float, float, float, int> ActorColumns;   // x, vx, health, id
+
+static const float TIME_STEP = 1.0f / 60.0f;
+
+
+static void
+usage()
+{
+    fprintf(stderr, "usage: soaBenchmark [-n actors] [-p passes]\n");
+    exit(1);
+}
+
+// Time passes of a loop and return the nanoseconds per element.
+template <class F> static double
+measure(F loop, int count, int passes)
+{
+    loop();  // Warm the caches.
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+        loop();
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / ((double) count * passes);
+}
+
+static void
+report(const char *name, double nanoseconds, double baseline)
+{
+    printf("  %-28s %7.3f ns/actor  %7.1f M actors/s  %5.1fx\n",
+        name, nanoseconds, 1e3 / nanoseconds, baseline / nanoseconds);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int count = 1000000;
+    int passes = 50;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:p:")) != -1)
+	{
+        switch (option)
+		{
+          case 'n':
+            count = atoi(optarg);
+            break;
+          case 'p':
+            passes = atoi(optarg);
+            break;
+          default:
+            usage();
+        }
+    }
+    if ((optind != argc) || (count <= 0) || (passes <= 0))
+        usage();
+
+    MleArray<Actor> actors(count);
+    for (int i = 0; i < count; i++)
+	{
+        Actor &actor = actors[i];
+        actor.m_x = (float) (i % 1000);
+        actor.m_vx = (float) (i % 7) - 3.0f;
+        actor.m_health = (float) (i % 100);
+        actor.m_id = i;
+    }
+
+    ActorColumns columns;
+    if (! columns.fromArray(actors, &Actor::m_x, &Actor::m_vx, &Actor::m_health, &Actor::m_id))
+	{
+        fprintf(stderr, "soaBenchmark: cannot allocate %d actors\n", count);
+        return 1;
+    }
+
+    printf("%d actors of %lu bytes, %d passes, %s\n", count, (unsigned long) sizeof(Actor), passes,
+        MleArrayOps::getInstructionSetName(MleArrayOps::getInstructionSet()));
+
+    // Sum one field over all the actors.
+    volatile float sink = 0.0f;
+    printf("sum of health\n");
+    const Actor *records = actors + 0;
+    double aos = measure([&]()
+    {
+        float total = 0.0f;
+        for (int i = 0; i < count; i++)
+            total += records[i].m_health;
+        sink = total;
+    }, count, passes);
+    report("array of structures", aos, aos);
+
+    MleSpan<float> health = columns.field<2>();
+    report("structure of arrays", measure([&]()
+    {
+        float total = 0.0f;
+        for (float value : health)
+            total += value;
+        sink = total;
+    }, count, passes), aos);
+    report("structure of arrays, SIMD", measure([&]()
+    {
+        sink = MleArrayOps::sum(health.data(), health.size());
+    }, count, passes), aos);
+
+    // Move every actor along x, reading two fields and writing one.
+    printf("x += vx * dt\n");
+    Actor *writable = actors + 0;
+    aos = measure([&]()
+    {
+        for (int i = 0; i < count; i++)
+            writable[i].m_x += writable[i].m_vx * TIME_STEP;
+    }, count, passes);
+    report("array of structures", aos, aos);
+
+    MleSpan<float> x = columns.field<0>();
+    MleSpan<float> vx = columns.field<1>();
+    report("structure of arrays", measure([&]()
+    {
+        for (int i = 0; i < count; i++)
+            x[i] += vx[i] * TIME_STEP;
+    }, count, passes), aos);
+    report("structure of arrays, SIMD", measure([&]()
+    {
+        MleArrayOps::axpy(x.data(), TIME_STEP, vx.data(), x.size());
+    }, count, passes), aos);
+
+    return 0;
+}
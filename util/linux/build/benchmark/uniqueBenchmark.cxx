@@ -0,0 +1,195 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file uniqueBenchmark.cxx
+ *  @ingroup MleCore
+ *
+ *  Compare the speed of the C function mlUnique(), which compares
+ *  entries through a function pointer, with its typed versions and with
+ *  the strategies of MleUnique.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Include Magic Lantern utility header files.
+#include "mle/mlUnique.h"
+#include "mle/mlTypedUnique.h"
+#include "mle/MleUnique.h"
+
+
+// A 16 byte asset identifier.
+struct AssetId
+{
+    MlULong m_high;
+    MlULong m_low;
+};
+
+
+static void
+usage()
+{
+    fprintf(stderr, "usage: uniqueBenchmark [-n entries] [-d distinct] [-p passes]\n");
+    exit(1);
+}
+
+static int
+compareInt(const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static int
+compareLong(const void *a, const void *b)
+{
+    MlLong x = *(const MlLong *) a;
+    MlLong y = *(const MlLong *) b;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static int
+compareAssetId(const void *a, const void *b)
+{
+    return memcmp(a, b, sizeof(AssetId));
+}
+
+// Time passes of removing duplicates from a fresh copy of the entries and
+// return the nanoseconds per entry.
+template <class T, class F> static double
+measure(const std::vector<T> &entries, F unique, int passes, int &kept)
+{
+    std::vector<T> work(entries.size());
+    std::chrono::steady_clock::duration total(0);
+    for (int pass = 0; pass <= passes; pass++)
+	{
+        memcpy((void *) work.data(), (const void *) entries.data(), sizeof(T) * entries.size());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        kept = unique(work.data(), (int) work.size());
+        if (pass > 0)  // The first pass warms the caches.
+            total += std::chrono::steady_clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(total).count() / ((double) entries.size() * passes);
+}
+
+static void
+report(const char *name, double nanoseconds, double baseline, int kept)
+{
+    printf("  %-32s %8.3f ns/entry  %6.1fx  %d kept\n", name, nanoseconds, baseline / nanoseconds, kept);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int count = 100000;
+    int distinct = 200;
+    int passes = 20;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:d:p:")) != -1)
+	{
+        switch (option)
+		{
+          case 'n':
+            count = atoi(optarg);
+            break;
+          case 'd':
+            distinct = atoi(optarg);
+            break;
+          case 'p':
+            passes = atoi(optarg);
+            break;
+          default:
+            usage();
+        }
+    }
+    if ((optind != argc) || (count <= 0) || (distinct <= 0) || (passes <= 0))
+        usage();
+
+    std::vector<int> ints(count);
+    std::vector<MlLong> longs(count);
+    std::vector<AssetId> ids(count);
+    srand(1);
+    for (int i = 0; i < count; i++)
+	{
+        ints[i] = rand() % distinct;
+        longs[i] = ((MlLong) ints[i] << 32) | 0x1234;
+        ids[i].m_high = 0x0123456789abcdefULL;
+        ids[i].m_low = (MlULong) ints[i];
+    }
+
+    printf("%d entries, at most %d distinct, %d passes, scan limit %d\n", count, distinct, passes, MLE_UNIQUE_SCAN_LIMIT);
+
+    int kept;
+    printf("4 byte keys\n");
+    double c = measure(ints, [](int *data, int n)
+        { return mlUnique(data, n, sizeof(int), compareInt); }, passes, kept);
+    report("mlUnique, C", c, c, kept);
+    report("mlUniqueOrdered, C", measure(ints, [](int *data, int n)
+        { return mlUniqueOrdered(data, n, sizeof(int), compareInt); }, passes, kept), c, kept);
+    report("mlUnique<int>, equality lambda", measure(ints, [](int *data, int n)
+        { return mlUnique(data, n, [](int a, int b) { return a == b; }); }, passes, kept), c, kept);
+    report("mlUnique<int>", measure(ints, [](int *data, int n)
+        { return mlUnique(data, n); }, passes, kept), c, kept);
+    report("MleUnique::hashBased", measure(ints, [](int *data, int n)
+        { return MleUnique::hashBased(data, n); }, passes, kept), c, kept);
+    report("MleUnique::sortBased", measure(ints, [](int *data, int n)
+        { return MleUnique::sortBased(data, n); }, passes, kept), c, kept);
+
+    printf("8 byte keys\n");
+    c = measure(longs, [](MlLong *data, int n)
+        { return mlUnique(data, n, sizeof(MlLong), compareLong); }, passes, kept);
+    report("mlUnique, C", c, c, kept);
+    report("mlUnique<MlLong>", measure(longs, [](MlLong *data, int n)
+        { return mlUnique(data, n); }, passes, kept), c, kept);
+
+    printf("16 byte keys\n");
+    c = measure(ids, [](AssetId *data, int n)
+        { return mlUnique(data, n, sizeof(AssetId), compareAssetId); }, passes, kept);
+    report("mlUnique, C", c, c, kept);
+    report("mlUnique<AssetId>, bitwise", measure(ids, [](AssetId *data, int n)
+        { return mlUnique(data, n, MleBitwiseEqual()); }, passes, kept), c, kept);
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file mlreplay.cxx
+ *  @ingroup MleCore
+ *
+ *  Replay an allocation trace on a memory manager and report its
+ *  speed and memory use.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Include Magic Lantern utility header files.
+#include "mle/MleAllocationReplay.h"
+#include "mle/MleArenaMemoryManager.h"
+#include "mle/MleThreadCacheMemoryManager.h"
+
+
+static void
+usage()
+{
+    fprintf(stderr,
+        "usage: mlreplay [-m base|threadcache|arena] [-r repeat] [-f count] trace\n"
+        "  -m  the memory manager to replay the trace on (default base)\n"
+        "  -r  the number of timed replays; the fastest is reported (default 3)\n"
+        "  -f  fail the allocation or resize after count have succeeded\n");
+    exit(1);
+}
+
+static MleMemoryManager *
+createManager(const char *name)
+{
+    if (strcmp(name, "base") == 0)
+        return new MleMemoryManager();
+    if (strcmp(name, "threadcache") == 0)
+        return new MleThreadCacheMemoryManager();
+    if (strcmp(name, "arena") == 0)
+        return new MleArenaMemoryManager();
+    return NULL;
+}
+
+static MlResult
+replay(MleAllocationReplay &trace, const char *name, uint_t failAfter,
+       MleReplayStats &stats, MlBoolean measureMemory)
+{
+    MleMemoryManager *manager = createManager(name);
+    MleMemoryManager::setThreadAllocationLimit(failAfter);
+    MlResult result = trace.run(manager, stats, measureMemory);
+    MleMemoryManager::setThreadAllocationLimit(0);
+    delete manager;
+    return result;
+}
+
+static double
+megabytes(MlULong bytes)
+{
+    return (double) bytes / (1024.0 * 1024.0);
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *name = "base";
+    uint_t repeat = 3;
+    uint_t failAfter = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "m:r:f:")) != -1)
+	{
+        switch (option)
+		{
+          case 'm':
+            name = optarg;
+            break;
+          case 'r':
+            repeat = (uint_t) atoi(optarg);
+            break;
+          case 'f':
+            failAfter = (uint_t) atoi(optarg);
+            break;
+          default:
+            usage();
+        }
+    }
+    if ((optind != argc - 1) || (repeat == 0))
+        usage();
+
+    MleMemoryManager *check = createManager(name);
+    if (check == NULL)
+	{
+        fprintf(stderr, "mlreplay: unknown memory manager %s\n", name);
+        usage();
+    }
+    delete check;
+
+    MleAllocationReplay trace;
+    if (trace.load(argv[optind]) != MLE_S_OK)
+	{
+        fprintf(stderr, "mlreplay: cannot load allocation trace %s\n", argv[optind]);
+        return 1;
+    }
+
+    printf("trace: %s\n", argv[optind]);
+    printf("  records %llu, failed when recorded %llu, threads %u, peak blocks %u\n",
+        (unsigned long long) trace.getRecordCount(),
+        (unsigned long long) trace.getRecordedFailureCount(),
+        trace.getThreadCount(), trace.getObjectCount());
+
+    // Measure memory first, while the heap is as fresh as it gets.
+    MleReplayStats memory;
+    replay(trace, name, failAfter, memory, TRUE);
+
+    MleReplayStats best;
+    for (uint_t i = 0; i < repeat; i++)
+	{
+        MleReplayStats timed;
+        replay(trace, name, failAfter, timed, FALSE);
+        if ((i == 0) || (timed.m_elapsedNanoseconds < best.m_elapsedNanoseconds))
+            best = timed;
+    }
+
+    printf("manager: %s\n", name);
+    printf("  operations %llu, failures %llu\n",
+        (unsigned long long) best.m_operations, (unsigned long long) best.m_failures);
+    printf("  time %.1f ns/op (%.3f ms)\n",
+        best.m_nanosecondsPerOperation, (double) best.m_elapsedNanoseconds / 1e6);
+    printf("  peak requested %.2f MB, peak usable %.2f MB, internal fragmentation %.1f%%\n",
+        megabytes(memory.m_peakRequestedBytes), megabytes(memory.m_peakUsableBytes),
+        memory.m_internalFragmentation * 100.0);
+    printf("  resident %.2f MB, peak %.2f MB, external fragmentation %.1f%%\n",
+        megabytes(memory.m_baseResidentSize), megabytes(memory.m_peakResidentSize),
+        memory.m_externalFragmentation * 100.0);
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleLinuxNumaMemoryManager.h
+ *  @ingroup MleCore
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_LINUXNUMAMEMORYMANAGER_H_
+#define __MLE_LINUXNUMAMEMORYMANAGER_H_
+
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+
+
+// The per-node heaps, defined in the implementation.
+struct MleNumaHeaps;
+
+
+/**
+ * @ingroup MleCore
+ * @brief MleLinuxNumaMemoryManager is a memory manager that keeps a heap on
+ * each NUMA node and serves each thread from the heap on its own node.
+ *
+ * With the platform allocator, memory lands on whichever node first touches
+ * it, and a block released by one thread is reused by any other. This manager
+ * instead binds the memory of each heap to its node with mbind() before it
+ * is touched, and serves a request from the heap of the node the calling
+ * thread is running on. A released block goes back to the heap it came from,
+ * whichever thread releases it. Large shared buffers can be placed on a
+ * chosen node with allocateOnNode().
+ *
+ * Requests of up to MAX_SMALL_SIZE bytes are rounded up to a size class and
+ * carved from spans of SPAN_SIZE bytes; larger ones are mapped on their own.
+ * Each heap is guarded by its own lock. Spans are kept until the manager is
+ * destroyed.
+ *
+ * The topology is read from /sys/devices/system/node. Setting the
+ * <b>MleNumaFakeNodes</b> environment variable to a node count before the
+ * manager is constructed fakes that many nodes instead: threads are spread
+ * over them round robin and no memory policy is applied, so the heaps can be
+ * exercised on a single node machine.
+ *
+ * The manager may be installed application wide with
+ * MleMemoryManager::setManager(), or by setting the <b>MleNuma</b>
+ * environment variable before the first call to MleMemoryManager::getManager().
+ */
+class MleLinuxNumaMemoryManager : public MleMemoryManager
+{
+	public:
+
+		/**
+		 * The largest request, in bytes, that is served from the size classes.
+		 */
+		static const uint_t MAX_SMALL_SIZE = 256 * 1024;
+
+		/**
+		 * The size of the spans the size classes are carved from.
+		 */
+		static const uint_t SPAN_SIZE = 2 * 1024 * 1024;
+
+		/**
+		 * The largest number of nodes supported.
+		 */
+		static const uint_t MAX_NODES = 64;
+
+		/**
+		 * Constructor.
+		 */
+		MleLinuxNumaMemoryManager();
+
+		/**
+		 * Destructor.
+		 *
+		 * All memory is returned to the system. Blocks from this manager
+		 * that are still in use become invalid.
+		 */
+		virtual ~MleLinuxNumaMemoryManager();
+
+		/**
+		 * Get the number of nodes.
+		 *
+		 * @return The number of nodes, at least 1, is returned.
+		 */
+		uint_t getNodeCount();
+
+		/**
+		 * Check whether the topology is faked.
+		 *
+		 * @return <b>TRUE</b> is returned if <b>MleNumaFakeNodes</b> was set.
+		 * <b>FALSE</b> is returned otherwise.
+		 */
+		MlBoolean isFakeTopology();
+
+		/**
+		 * Get the node the calling thread allocates from.
+		 *
+		 * @return The node set with setThreadNode() is returned, or else the
+		 * node the thread is running on.
+		 */
+		uint_t getCurrentNode();
+
+		/**
+		 * Set the node the calling thread allocates from.
+		 *
+		 * This does not move the thread; see bindThreadToNode().
+		 *
+		 * @param node The node, or -1 to use the node the thread is running
+		 * on.
+		 */
+		static void setThreadNode(MlInt node);
+
+		/**
+		 * Restrict the calling thread to the CPUs of a node and allocate from
+		 * that node. With a faked topology only the allocation node is set.
+		 *
+		 * @param node The node.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the thread was bound.
+		 *	   <li><b>MLE_E_FAIL</b> is returned if the node does not exist or
+		 *     the affinity could not be set.
+		 * </ul>
+		 */
+		MlResult bindThreadToNode(uint_t node);
+
+		/**
+		 * Allocates a chunk of memory on a given node.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 * @param node The node to place the memory on.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned if the node does not exist or
+		 *      the memory could not be allocated.
+		 * </ul>
+		 */
+		MlResult allocateOnNode(void **memory, MlULong size, uint_t node);
+
+		/**
+		 * Get the node whose heap a chunk of memory came from.
+		 *
+		 * @param memory The allocated memory.
+		 *
+		 * @return The node is returned.
+		 */
+		uint_t getNode(void *memory);
+
+		/**
+		 * Ask the kernel which node a page of memory is on.
+		 *
+		 * The page is faulted in if it has not been touched yet.
+		 *
+		 * @param memory An address in the page.
+		 *
+		 * @return The node is returned, or -1 if it cannot be found out, as
+		 * with a faked topology.
+		 */
+		MlInt getResidentNode(void *memory);
+
+		/**
+		 * Get the number of bytes of memory mapped for a node.
+		 *
+		 * @param node The node.
+		 *
+		 * @return The number of bytes in spans and large blocks on the node
+		 * is returned.
+		 */
+		MlULong getNodeMappedSize(uint_t node);
+
+		/**
+		 * Allocates a chunk of memory on the calling thread's node.
+		 * See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the newly allocated memory.
+		 * Will be unchanged if allocation fails.
+		 * @param size The amount of new memory to allocate.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *	    <li><b>MLE_S_OK</b> is returned if memory is successfully allocated.
+		 *	    <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult allocate(void **memory, uint_t size);
+
+		/**
+		 * Resizes a chunk of memory.  See base class description.
+		 *
+		 * The memory stays on the node it was allocated on.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * unchanged if resize fails.  May change if resize succeeds.
+		 * @param newSize The size of new memory chunk.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if memory is successfully resized.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult resize(void **memory, uint_t newSize);
+
+		/**
+		 * Releases an allocated chunk of memory.  See base class description.
+		 *
+		 * @param memory A pointer to a pointer to the allocated memory.  Will be
+		 * set to NULL if release succeeds.
+		 *
+		 * @return A MlResult is returned.
+		 * <ul>
+		 *     <li><b>MLE_S_OK</b> is returned if the memory is successfully released.
+		 *	   <li><b>MLE_E_FAIL</b> is returned otherwise.
+		 * </ul>
+		 */
+		virtual MlResult release(void **memory);
+
+		/**
+		 * Resizes a chunk of memory without moving it.  See base class description.
+		 */
+		virtual MlResult tryResizeInPlace(void *memory, MlULong newSize);
+
+		/**
+		 * Get the number of bytes that may be used in a chunk of memory.
+		 * See base class description.
+		 */
+		virtual MlULong getUsableSize(void *memory);
+
+		/**
+		 * Allocates a chunk of memory whose size may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult allocateLarge(void **memory, MlULong size);
+
+		/**
+		 * Resizes a chunk of memory to a size that may not fit in 32 bits.
+		 * See base class description.
+		 */
+		virtual MlResult resizeLarge(void **memory, MlULong newSize);
+
+	private:
+
+		// Hide the copy constructor and assignment operator.
+		MleLinuxNumaMemoryManager(const MleLinuxNumaMemoryManager &);
+		MleLinuxNumaMemoryManager &operator=(const MleLinuxNumaMemoryManager &);
+
+		//
+		// The heaps, one per node.
+		//
+		MleNumaHeaps *m_heaps;
+};
+
+
+#endif /* __MLE_LINUXNUMAMEMORYMANAGER_H_ */
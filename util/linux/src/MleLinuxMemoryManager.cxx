@@ -50,47 +50,364 @@
 #else
 #include <malloc.h>
 #endif
+#include <stdint.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 // Include Magic Lantern header files.
 #include "mle/MleMemoryManager.h"
 
+#define MLE_HUGE_PAGES "MleHugePages"
+
+// Size of a transparent huge page on the architectures we support.
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Number of independently locked parts of the mapping table.
+#define MAPPING_SHARDS 64
+
+
+//
+// Platform state, present only when the huge page mode is enabled by the
+// MleHugePages environment variable. Requests of at least the threshold
+// are mapped directly, aligned to a huge page and advised to use
+// transparent huge pages; the rest are served by malloc.
+//
+// Mapped blocks start on a huge page boundary, so any other pointer is
+// known to come from malloc without a lookup. The rest are found in a
+// table split by address, so that frees of different blocks seldom
+// contend for a lock.
+//
+struct MappingShard
+{
+    alignas(64) std::mutex lock;
+    std::unordered_map<void *, size_t> mappings;   // Mapped blocks and their lengths.
+};
+
+struct LinuxHeap
+{
+    size_t threshold;
+    std::atomic<size_t> numMappings;               // Checked before taking a lock.
+    MappingShard shards[MAPPING_SHARDS];
+};
+
+
+static MappingShard *
+shardOf(LinuxHeap *heap, void *memory)
+{
+    return &heap->shards[((uintptr_t) memory / HUGE_PAGE_SIZE) % MAPPING_SHARDS];
+}
+
+
+static MlBoolean
+mayBeMapped(LinuxHeap *heap, void *memory)
+{
+    return (heap != NULL) && (memory != NULL) &&
+           (((uintptr_t) memory & (HUGE_PAGE_SIZE - 1)) == 0) &&
+           (heap->numMappings.load(std::memory_order_acquire) != 0);
+}
+
+
+static void
+addMapping(LinuxHeap *heap, void *block, size_t length)
+{
+    MappingShard *shard = shardOf(heap, block);
+    std::lock_guard<std::mutex> guard(shard->lock);
+    shard->mappings[block] = length;
+    heap->numMappings.fetch_add(1, std::memory_order_release);
+}
+
+
+static size_t
+removeMapping(LinuxHeap *heap, void *block)
+{
+    MappingShard *shard = shardOf(heap, block);
+    std::lock_guard<std::mutex> guard(shard->lock);
+    std::unordered_map<void *, size_t>::iterator entry = shard->mappings.find(block);
+    if (entry == shard->mappings.end())
+        return 0;
+    size_t length = entry->second;
+    shard->mappings.erase(entry);
+    heap->numMappings.fetch_sub(1, std::memory_order_release);
+    return length;
+}
+
+
+static void *
+mapAligned(size_t length)
+{
+    // Map an extra huge page and trim the ends to align the block.
+    MlUChar *region = (MlUChar *) mmap(NULL, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+        return NULL;
+
+    MlUChar *block = (MlUChar *) (((uintptr_t) region + HUGE_PAGE_SIZE - 1) & ~((uintptr_t) HUGE_PAGE_SIZE - 1));
+    if (block > region)
+        munmap(region, block - region);
+    if (block + length < region + length + HUGE_PAGE_SIZE)
+        munmap(block + length, region + length + HUGE_PAGE_SIZE - (block + length));
+
+    // Transparent huge pages may be disabled; the mapping works regardless.
+    madvise(block, length, MADV_HUGEPAGE);
+
+    return block;
+}
+
+
+static void *
+mapHugePages(LinuxHeap *heap, size_t size)
+{
+    size_t length = (size + HUGE_PAGE_SIZE - 1) & ~((size_t) HUGE_PAGE_SIZE - 1);
+    if (length < size)
+        return NULL;
+
+    void *block = mapAligned(length);
+    if (block != NULL)
+        addMapping(heap, block, length);
+
+    return block;
+}
+
+
+static size_t
+findMapping(LinuxHeap *heap, void *memory)
+{
+    if (! mayBeMapped(heap, memory))
+        return 0;
+
+    MappingShard *shard = shardOf(heap, memory);
+    std::lock_guard<std::mutex> guard(shard->lock);
+    std::unordered_map<void *, size_t>::iterator entry = shard->mappings.find(memory);
+    return (entry != shard->mappings.end()) ? entry->second : 0;
+}
+
+
+static MlBoolean
+unmapHugePages(LinuxHeap *heap, void *memory)
+{
+    if (! mayBeMapped(heap, memory))
+        return FALSE;
+
+    size_t length = removeMapping(heap, memory);
+    if (length == 0)
+        return FALSE;
+    munmap(memory, length);
+
+    return TRUE;
+}
+
 
 void
 MleMemoryManager::platformInit(void *&cookie)
 {
     cookie = NULL;
-    // Nothing to do for linux.
+
+    const char *threshold = getenv(MLE_HUGE_PAGES);
+    if (threshold != NULL)
+	{
+        LinuxHeap *heap = new LinuxHeap();
+        heap->threshold = (size_t) strtoull(threshold, NULL, 10);
+        if (heap->threshold < HUGE_PAGE_SIZE)
+            heap->threshold = HUGE_PAGE_SIZE;
+        heap->numMappings.store(0);
+        cookie = heap;
+    }
 }
 
 
 void
 MleMemoryManager::platformCleanup(void *&cookie)
 {
-    // Nothing to do for linux.
+    LinuxHeap *heap = (LinuxHeap *) cookie;
+    if (heap != NULL)
+	{
+        for (int i = 0; i < MAPPING_SHARDS; i++)
+            for (std::unordered_map<void *, size_t>::iterator entry = heap->shards[i].mappings.begin();
+                 entry != heap->shards[i].mappings.end(); ++entry)
+                munmap(entry->first, entry->second);
+        delete heap;
+        cookie = NULL;
+    }
 }
 
 
 void *
-MleMemoryManager::platformAllocate(void * /* cookie */, MlUInt size)
+MleMemoryManager::platformAllocate(void *cookie, MlULong size)
 {
+    if (size > SIZE_MAX)
+        return NULL;
+
+    LinuxHeap *heap = (LinuxHeap *) cookie;
+    if (heap != NULL && size >= heap->threshold)
+        return mapHugePages(heap, (size_t) size);
+
 //#undef mlMalloc
-    return mlMalloc(size);
+    return mlMalloc((size_t) size);
 }
 
 
 void *
-MleMemoryManager::platformResize(void * /* cookie */, void *memory, MlUInt newSize)
+MleMemoryManager::platformResize(void *cookie, void *memory, MlULong newSize)
 {
+    if (newSize > SIZE_MAX)
+        return NULL;
+
+    LinuxHeap *heap = (LinuxHeap *) cookie;
+    if (heap != NULL && memory != NULL)
+	{
+        size_t length = findMapping(heap, memory);
+        if (length != 0)
+		{
+            if (newSize >= heap->threshold)
+			{
+                if (newSize <= length)
+                    return memory;
+
+                // Let the kernel move the pages rather than copying them,
+                // onto an aligned range so that the block stays recognizable.
+                size_t newLength = ((size_t) newSize + HUGE_PAGE_SIZE - 1) & ~((size_t) HUGE_PAGE_SIZE - 1);
+                void *block = mapAligned(newLength);
+                if (block == NULL)
+                    return NULL;
+                if (mremap(memory, length, newLength, MREMAP_MAYMOVE | MREMAP_FIXED, block) == MAP_FAILED)
+				{
+                    munmap(block, newLength);
+                    return NULL;
+                }
+                madvise(block, newLength, MADV_HUGEPAGE);
+                removeMapping(heap, memory);
+                addMapping(heap, block, newLength);
+                return block;
+            }
+
+            // Shrunk below the threshold: move back to the heap.
+            void *block = mlMalloc((size_t) newSize);
+            if (block == NULL)
+                return NULL;
+            memcpy(block, memory, (size_t) newSize);
+            unmapHugePages(heap, memory);
+            return block;
+        }
+
+        if (newSize >= heap->threshold)
+		{
+            void *block = mapHugePages(heap, (size_t) newSize);
+            if (block == NULL)
+                return NULL;
+            size_t oldSize = malloc_usable_size(memory);
+            memcpy(block, memory, (oldSize < newSize) ? oldSize : (size_t) newSize);
+            mlFree(memory);
+            return block;
+        }
+    }
+
 //#undef mlRealloc
-    return mlRealloc(memory, newSize);
+    return mlRealloc(memory, (size_t) newSize);
 }
 
 
 MlResult
-MleMemoryManager::platformRelease(void * /* cookie */, void *memory)
+MleMemoryManager::platformRelease(void *cookie, void *memory)
 {
+    if (unmapHugePages((LinuxHeap *) cookie, memory))
+        return MLE_S_OK;
+
 //#undef mlFree
     mlFree(memory);
 
     return MLE_S_OK;
 }
+
+
+MlULong
+MleMemoryManager::platformUsableSize(void *cookie, void *memory)
+{
+    size_t length = findMapping((LinuxHeap *) cookie, memory);
+    if (length != 0)
+        return length;
+
+    return mlMallocUsableSize(memory);
+}
+
+
+void *
+MleMemoryManager::platformAllocateAligned(void *cookie, MlULong size, uint_t alignment)
+{
+    if (size > SIZE_MAX)
+        return NULL;
+
+    LinuxHeap *heap = (LinuxHeap *) cookie;
+    if (heap != NULL && size >= heap->threshold && alignment <= HUGE_PAGE_SIZE)
+        return mapHugePages(heap, (size_t) size);
+
+    void *memory;
+    if (posix_memalign(&memory, alignment, (size_t) size) != 0)
+        return NULL;
+
+    return memory;
+}
+
+
+MlResult
+MleMemoryManager::platformReleaseAligned(void *cookie, void *memory)
+{
+    return platformRelease(cookie, memory);
+}
+
+
+MlULong
+MleMemoryManager::platformResidentSize()
+{
+    // Read the file directly; stdio would allocate while the heap is
+    // being measured.
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    char buffer[128];
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0)
+        return 0;
+    buffer[length] = '\0';
+
+    // The second field is the number of resident pages.
+    char *field = strchr(buffer, ' ');
+    if (field == NULL)
+        return 0;
+    return strtoull(field + 1, NULL, 10) * (MlULong) sysconf(_SC_PAGESIZE);
+}
+
+
+uint_t
+MleMemoryManager::platformBacktrace(void **frames, uint_t maxFrames)
+{
+    int count = backtrace(frames, (int) maxFrames);
+    return (count > 0) ? (uint_t) count : 0;
+}
+
+
+MlBoolean
+MleMemoryManager::platformSymbolName(void *address, char *name, uint_t size)
+{
+    Dl_info info;
+    if ((size == 0) || (dladdr(address, &info) == 0) || (info.dli_sname == NULL))
+        return FALSE;
+
+    int status;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+    const char *symbol = (demangled != NULL) ? demangled : info.dli_sname;
+    strncpy(name, symbol, size - 1);
+    name[size - 1] = '\0';
+    free(demangled);
+
+    return TRUE;
+}
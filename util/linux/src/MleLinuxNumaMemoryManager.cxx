@@ -0,0 +1,594 @@
+/** @defgroup MleCore Magic Lantern Core Utility Library API */
+
+/**
+ *  @file MleLinuxNumaMemoryManager.cxx
+ *  @ingroup MleCore
+ *
+ *  Implementation of the NUMA aware memory manager for Linux.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Include Magic Lantern header files.
+#include "mle/mlAssert.h"
+#include "mle/MleLinuxNumaMemoryManager.h"
+
+#define MLE_NUMA_FAKE_NODES "MleNumaFakeNodes"
+
+// Memory policy constants, as in <linux/mempolicy.h>; glibc has no wrappers
+// for these system calls.
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MPOL_F_NODE    (1 << 0)
+#define NUMA_MPOL_F_ADDR    (1 << 1)
+
+// Every block is preceded by a header naming its node and size class.
+#define HEADER_SIZE     16
+
+// Size classes: multiples of 16 bytes up to 128, then four classes per
+// power of two. A class is the size of the whole block, header included.
+#define NUM_CLASSES     53
+#define LARGE_CLASS     0xffffffff
+
+#define CACHE_LINE      64
+
+struct NumaBlockHeader
+{
+    MlULong length;     // The length of the block, header included.
+    uint_t node;
+    uint_t sizeClass;   // LARGE_CLASS if the block is mapped on its own.
+};
+
+struct alignas(CACHE_LINE) NodeHeap
+{
+    std::mutex lock;
+
+    // Free blocks of each size class, linked through their first word.
+    void *freeLists[NUM_CLASSES];
+
+    // The unused part of the newest span.
+    MlUChar *spanNext;
+    size_t spanLeft;
+
+    std::vector<void *> spans;
+    std::unordered_map<void *, size_t> largeBlocks;
+    std::atomic<MlULong> mappedSize;
+};
+
+struct MleNumaHeaps
+{
+    uint_t numNodes;
+    MlBoolean fake;
+
+    // The system node number of each node, and the node of each CPU.
+    std::vector<uint_t> systemNodes;
+    std::vector<uint_t> cpuNodes;
+    std::vector<cpu_set_t> nodeCpus;
+
+    NodeHeap *heaps;
+};
+
+
+// The node set with setThreadNode(), or -1.
+static thread_local MlInt t_threadNode = -1;
+
+// Threads are spread over faked nodes in the order they first allocate.
+static std::atomic<uint_t> g_nextFakeThread(0);
+static thread_local MlInt t_fakeThread = -1;
+
+
+static inline uint_t
+sizeClass(MlULong length)
+{
+    if (length <= 128)
+        return (uint_t) ((length + 15) / 16) - 1;
+
+    // 2^bits < length <= 2^(bits + 1); four classes in between.
+    uint_t bits = 63 - __builtin_clzll(length - 1);
+    MlULong step = (MlULong) 1 << (bits - 2);
+    uint_t within = (uint_t) ((length - ((MlULong) 1 << bits) + step - 1) / step);
+    return 8 + (bits - 7) * 4 + within - 1;
+}
+
+static inline MlULong
+classLength(uint_t sizeClass)
+{
+    if (sizeClass < 8)
+        return 16 * (sizeClass + 1);
+
+    uint_t bits = 7 + (sizeClass - 8) / 4;
+    return ((MlULong) 1 << bits) + ((sizeClass - 8) % 4 + 1) * ((MlULong) 1 << (bits - 2));
+}
+
+// Parse a list such as "0-3,8,10-11", calling add for each number.
+template <typename Function>
+static void
+parseList(const char *list, Function add)
+{
+    const char *next = list;
+    while (*next != '\0' && *next != '\n')
+	{
+        char *end;
+        unsigned long first = strtoul(next, &end, 10);
+        if (end == next)
+            break;
+        unsigned long last = first;
+        if (*end == '-')
+		{
+            next = end + 1;
+            last = strtoul(next, &end, 10);
+            if (end == next)
+                break;
+        }
+        for (unsigned long number = first; number <= last; number++)
+            add((uint_t) number);
+        next = (*end == ',') ? end + 1 : end;
+    }
+}
+
+static MlBoolean
+readLine(const char *path, char *buffer, size_t size)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+        return FALSE;
+    MlBoolean found = (fgets(buffer, (int) size, file) != NULL) ? TRUE : FALSE;
+    fclose(file);
+    return found;
+}
+
+static void
+readTopology(MleNumaHeaps *heaps)
+{
+    char buffer[4096];
+    if (readLine("/sys/devices/system/node/online", buffer, sizeof(buffer)))
+	{
+        parseList(buffer, [heaps](uint_t node)
+        {
+            if (node < MleLinuxNumaMemoryManager::MAX_NODES &&
+                heaps->systemNodes.size() < MleLinuxNumaMemoryManager::MAX_NODES)
+                heaps->systemNodes.push_back(node);
+        });
+    }
+    if (heaps->systemNodes.empty())
+        heaps->systemNodes.push_back(0);
+    heaps->numNodes = (uint_t) heaps->systemNodes.size();
+    heaps->nodeCpus.resize(heaps->numNodes);
+
+    for (uint_t node = 0; node < heaps->numNodes; node++)
+	{
+        CPU_ZERO(&heaps->nodeCpus[node]);
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist",
+                 heaps->systemNodes[node]);
+        if (! readLine(path, buffer, sizeof(buffer)))
+            continue;
+        parseList(buffer, [heaps, node](uint_t cpu)
+        {
+            if (cpu >= heaps->cpuNodes.size())
+                heaps->cpuNodes.resize(cpu + 1, 0);
+            heaps->cpuNodes[cpu] = node;
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &heaps->nodeCpus[node]);
+        });
+    }
+}
+
+// Map memory and ask the kernel to place it on a node before it is touched.
+static void *
+mapOnNode(MleNumaHeaps *heaps, uint_t node, size_t length)
+{
+    void *memory = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return NULL;
+
+    if (! heaps->fake)
+	{
+        // Preferred rather than bound, so that a full node spills over
+        // instead of failing. Should the call be refused, as under some
+        // sandboxes, the memory is still usable.
+        unsigned long mask = 1UL << heaps->systemNodes[node];
+        syscall(SYS_mbind, memory, length, NUMA_MPOL_PREFERRED, &mask,
+                (unsigned long) (sizeof(mask) * 8 + 1), 0);
+    }
+
+    heaps->heaps[node].mappedSize.fetch_add(length, std::memory_order_relaxed);
+    return memory;
+}
+
+static void *
+allocateBlock(MleNumaHeaps *heaps, uint_t node, MlULong size)
+{
+    if (size > SIZE_MAX / 2)
+        return NULL;
+
+    MlULong length = size + HEADER_SIZE;
+    NodeHeap &heap = heaps->heaps[node];
+    NumaBlockHeader *header;
+    uint_t cls;
+
+    if (size <= MleLinuxNumaMemoryManager::MAX_SMALL_SIZE)
+	{
+        cls = sizeClass(length);
+        length = classLength(cls);
+
+        std::lock_guard<std::mutex> guard(heap.lock);
+        header = (NumaBlockHeader *) heap.freeLists[cls];
+        if (header != NULL)
+            heap.freeLists[cls] = *(void **) header;
+        else
+		{
+            if (heap.spanLeft < length)
+			{
+                // The rest of the old span is given up.
+                void *span = mapOnNode(heaps, node, MleLinuxNumaMemoryManager::SPAN_SIZE);
+                if (span == NULL)
+                    return NULL;
+                heap.spans.push_back(span);
+                heap.spanNext = (MlUChar *) span;
+                heap.spanLeft = MleLinuxNumaMemoryManager::SPAN_SIZE;
+            }
+            header = (NumaBlockHeader *) heap.spanNext;
+            heap.spanNext += length;
+            heap.spanLeft -= length;
+        }
+    }
+    else
+	{
+        size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+        length = (length + pageSize - 1) & ~((MlULong) pageSize - 1);
+        cls = LARGE_CLASS;
+
+        header = (NumaBlockHeader *) mapOnNode(heaps, node, (size_t) length);
+        if (header == NULL)
+            return NULL;
+
+        std::lock_guard<std::mutex> guard(heap.lock);
+        heap.largeBlocks[header] = (size_t) length;
+    }
+
+    header->length = length;
+    header->node = node;
+    header->sizeClass = cls;
+    return (MlUChar *) header + HEADER_SIZE;
+}
+
+static void
+releaseBlock(MleNumaHeaps *heaps, NumaBlockHeader *header)
+{
+    NodeHeap &heap = heaps->heaps[header->node];
+    if (header->sizeClass == LARGE_CLASS)
+	{
+        size_t length = (size_t) header->length;
+        {
+            std::lock_guard<std::mutex> guard(heap.lock);
+            heap.largeBlocks.erase(header);
+        }
+        munmap(header, length);
+        heap.mappedSize.fetch_sub(length, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(heap.lock);
+    *(void **) header = heap.freeLists[header->sizeClass];
+    heap.freeLists[header->sizeClass] = header;
+}
+
+// Grow a large block without moving it. Returns FALSE if it cannot.
+static MlBoolean
+growInPlace(MleNumaHeaps *heaps, NumaBlockHeader *header, MlULong length)
+{
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    length = (length + pageSize - 1) & ~((MlULong) pageSize - 1);
+    if (length > SIZE_MAX)
+        return FALSE;
+
+    // The new pages join the mapping and so inherit its memory policy.
+    if (mremap(header, (size_t) header->length, (size_t) length, 0) == MAP_FAILED)
+        return FALSE;
+
+    NodeHeap &heap = heaps->heaps[header->node];
+    heap.mappedSize.fetch_add(length - header->length, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(heap.lock);
+    heap.largeBlocks[header] = (size_t) length;
+    header->length = length;
+    return TRUE;
+}
+
+
+MleLinuxNumaMemoryManager::MleLinuxNumaMemoryManager()
+{
+    m_heaps = new MleNumaHeaps();
+    m_heaps->fake = FALSE;
+
+    const char *fakeNodes = getenv(MLE_NUMA_FAKE_NODES);
+    if ((fakeNodes != NULL) && (atoi(fakeNodes) > 0))
+	{
+        m_heaps->fake = TRUE;
+        m_heaps->numNodes = (uint_t) atoi(fakeNodes);
+        if (m_heaps->numNodes > MAX_NODES)
+            m_heaps->numNodes = MAX_NODES;
+        for (uint_t node = 0; node < m_heaps->numNodes; node++)
+            m_heaps->systemNodes.push_back(node);
+    }
+    else
+        readTopology(m_heaps);
+
+    m_heaps->heaps = new NodeHeap[m_heaps->numNodes];
+    for (uint_t node = 0; node < m_heaps->numNodes; node++)
+	{
+        NodeHeap &heap = m_heaps->heaps[node];
+        memset(heap.freeLists, 0, sizeof(heap.freeLists));
+        heap.spanNext = NULL;
+        heap.spanLeft = 0;
+        heap.mappedSize.store(0);
+    }
+}
+
+
+MleLinuxNumaMemoryManager::~MleLinuxNumaMemoryManager()
+{
+    for (uint_t node = 0; node < m_heaps->numNodes; node++)
+	{
+        NodeHeap &heap = m_heaps->heaps[node];
+        for (size_t i = 0; i < heap.spans.size(); i++)
+            munmap(heap.spans[i], SPAN_SIZE);
+        for (std::unordered_map<void *, size_t>::iterator entry = heap.largeBlocks.begin();
+             entry != heap.largeBlocks.end(); ++entry)
+            munmap(entry->first, entry->second);
+    }
+    delete [] m_heaps->heaps;
+    delete m_heaps;
+}
+
+
+uint_t
+MleLinuxNumaMemoryManager::getNodeCount()
+{
+    return m_heaps->numNodes;
+}
+
+
+MlBoolean
+MleLinuxNumaMemoryManager::isFakeTopology()
+{
+    return m_heaps->fake;
+}
+
+
+uint_t
+MleLinuxNumaMemoryManager::getCurrentNode()
+{
+    if ((t_threadNode >= 0) && ((uint_t) t_threadNode < m_heaps->numNodes))
+        return (uint_t) t_threadNode;
+
+    if (m_heaps->fake)
+	{
+        if (t_fakeThread < 0)
+            t_fakeThread = (MlInt) g_nextFakeThread.fetch_add(1, std::memory_order_relaxed);
+        return (uint_t) t_fakeThread % m_heaps->numNodes;
+    }
+
+    int cpu = sched_getcpu();
+    if ((cpu < 0) || ((size_t) cpu >= m_heaps->cpuNodes.size()))
+        return 0;
+    return m_heaps->cpuNodes[cpu];
+}
+
+
+void
+MleLinuxNumaMemoryManager::setThreadNode(MlInt node)
+{
+    t_threadNode = (node >= 0) ? node : -1;
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::bindThreadToNode(uint_t node)
+{
+    if (node >= m_heaps->numNodes)
+        return MLE_E_FAIL;
+
+    if (! m_heaps->fake &&
+        (sched_setaffinity(0, sizeof(cpu_set_t), &m_heaps->nodeCpus[node]) != 0))
+        return MLE_E_FAIL;
+
+    setThreadNode((MlInt) node);
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::allocateOnNode(void **memory, MlULong size, uint_t node)
+{
+    MLE_ASSERT(memory != NULL);
+    MLE_ASSERT(size > 0);
+
+    if ((node >= m_heaps->numNodes) || ! allocationAllowed())
+        return MLE_E_FAIL;
+
+    void *block = allocateBlock(m_heaps, node, size);
+    if (block == NULL)
+        return MLE_E_FAIL;
+
+    *memory = block;
+    return MLE_S_OK;
+}
+
+
+uint_t
+MleLinuxNumaMemoryManager::getNode(void *memory)
+{
+    MLE_ASSERT(memory != NULL);
+    return ((NumaBlockHeader *) ((MlUChar *) memory - HEADER_SIZE))->node;
+}
+
+
+MlInt
+MleLinuxNumaMemoryManager::getResidentNode(void *memory)
+{
+    if (m_heaps->fake)
+        return -1;
+
+    int systemNode = -1;
+    if (syscall(SYS_get_mempolicy, &systemNode, NULL, 0UL, memory,
+                (unsigned long) (NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR)) != 0)
+        return -1;
+
+    for (uint_t node = 0; node < m_heaps->numNodes; node++)
+	{
+        if (m_heaps->systemNodes[node] == (uint_t) systemNode)
+            return (MlInt) node;
+    }
+    return -1;
+}
+
+
+MlULong
+MleLinuxNumaMemoryManager::getNodeMappedSize(uint_t node)
+{
+    if (node >= m_heaps->numNodes)
+        return 0;
+    return m_heaps->heaps[node].mappedSize.load(std::memory_order_relaxed);
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::allocate(void **memory, uint_t size)
+{
+    return allocateLarge(memory, size);
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::allocateLarge(void **memory, MlULong size)
+{
+    return allocateOnNode(memory, size, getCurrentNode());
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::resize(void **memory, uint_t newSize)
+{
+    return resizeLarge(memory, newSize);
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::resizeLarge(void **memory, MlULong newSize)
+{
+    MLE_ASSERT(memory != NULL);
+    MLE_ASSERT(newSize > 0);
+
+    if (*memory == NULL)
+        return allocateLarge(memory, newSize);
+
+    if (! allocationAllowed())
+        return MLE_E_FAIL;
+
+    if (tryResizeInPlace(*memory, newSize) == MLE_S_OK)
+        return MLE_S_OK;
+
+    // Move the block, keeping it on its node.
+    NumaBlockHeader *header = (NumaBlockHeader *) ((MlUChar *) *memory - HEADER_SIZE);
+    void *block = allocateBlock(m_heaps, header->node, newSize);
+    if (block == NULL)
+        return MLE_E_FAIL;
+
+    MlULong oldSize = header->length - HEADER_SIZE;
+    memcpy(block, *memory, (size_t) ((oldSize < newSize) ? oldSize : newSize));
+    releaseBlock(m_heaps, header);
+    *memory = block;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::release(void **memory)
+{
+    MLE_ASSERT(memory != NULL);
+
+    if (*memory == NULL)
+        return MLE_S_OK;
+
+    releaseBlock(m_heaps, (NumaBlockHeader *) ((MlUChar *) *memory - HEADER_SIZE));
+    *memory = NULL;
+
+    return MLE_S_OK;
+}
+
+
+MlResult
+MleLinuxNumaMemoryManager::tryResizeInPlace(void *memory, MlULong newSize)
+{
+    if ((memory == NULL) || (newSize > ~((MlULong) 0) - HEADER_SIZE))
+        return MLE_E_FAIL;
+
+    NumaBlockHeader *header = (NumaBlockHeader *) ((MlUChar *) memory - HEADER_SIZE);
+    if (newSize + HEADER_SIZE <= header->length)
+        return MLE_S_OK;
+
+    if ((header->sizeClass == LARGE_CLASS) && growInPlace(m_heaps, header, newSize + HEADER_SIZE))
+        return MLE_S_OK;
+
+    return MLE_E_FAIL;
+}
+
+
+MlULong
+MleLinuxNumaMemoryManager::getUsableSize(void *memory)
+{
+    if (memory == NULL)
+        return 0;
+    return ((NumaBlockHeader *) ((MlUChar *) memory - HEADER_SIZE))->length - HEADER_SIZE;
+}
@@ -0,0 +1,751 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <string>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/mlArray.h"
+#include "mle/mlSmallArray.h"
+#include "mle/MleArrayOps.h"
+#include "mle/mlSoAArray.h"
+#include "mle/mlConcurrentArray.h"
+#include "mle/MleArenaMemoryManager.h"
+#include "mle/MleProfilingMemoryManager.h"
+
+
+// Counts the live instances so that leaks and double destruction show up.
+struct Tracked
+{
+    static int s_live;
+    int m_value;
+    Tracked() : m_value(0) { s_live++; }
+    Tracked(int value) : m_value(value) { s_live++; }
+    Tracked(const Tracked &other) : m_value(other.m_value) { s_live++; }
+    Tracked(Tracked &&other) noexcept : m_value(other.m_value) { other.m_value = -1; s_live++; }
+    ~Tracked() { s_live--; }
+    Tracked &operator=(const Tracked &other) { m_value = other.m_value; return *this; }
+};
+
+int Tracked::s_live = 0;
+
+
+TEST(MleArrayTest, IndexGrowsGeometrically) {
+    MleArray<int> array;
+    int reallocations = 0;
+    int *data = NULL;
+    for (int i = 0; i < 10000; i++)
+	{
+        array[i] = i;
+        if (array + 0 != data)
+		{
+            data = array + 0;
+            reallocations++;
+        }
+    }
+    EXPECT_EQ(array.size(), 10000);
+    EXPECT_GE(array.capacity(), 10000);
+    EXPECT_LT(reallocations, 20);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(array[i], i);
+
+    // Indexing the element just past the end grows the array too.
+    array[array.size()] = -1;
+    EXPECT_EQ(array.size(), 10001);
+}
+
+TEST(MleArrayTest, ReserveAndShrink) {
+    MleArray<double> array;
+    ASSERT_TRUE(array.reserve(100) != NULL);
+    EXPECT_EQ(array.size(), 0);
+    EXPECT_GE(array.capacity(), 100);
+
+    double *data = array + 0;
+    for (int i = 0; i < 100; i++)
+        ASSERT_TRUE(array.push_back(i * 0.5) != NULL);
+    EXPECT_EQ(array + 0, data);
+
+    array.resize(10);
+    array.shrink_to_fit();
+    EXPECT_EQ(array.size(), 10);
+    EXPECT_LT(array.capacity(), 100);
+    EXPECT_EQ(array[9], 4.5);
+
+    array.resize(0);
+    array.shrink_to_fit();
+    EXPECT_EQ(array.capacity(), 0);
+}
+
+TEST(MleArrayTest, NonTrivialElements) {
+    {
+        MleArray<Tracked> array;
+        for (int i = 0; i < 100; i++)
+            ASSERT_TRUE(array.emplace_back(i) != NULL);
+        EXPECT_EQ(Tracked::s_live, 100);
+
+        // Appending an element of the array while it grows.
+        while (array.size() < array.capacity())
+            array.push_back(Tracked(0));
+        array.push_back(array[3]);
+        EXPECT_EQ(array[array.size() - 1].m_value, 3);
+        EXPECT_EQ(Tracked::s_live, array.size());
+
+        array.resize(50);
+        EXPECT_EQ(Tracked::s_live, 50);
+        for (int i = 0; i < 50; i++)
+            ASSERT_EQ(array[i].m_value, i);
+
+        // A negative size empties the array.
+        EXPECT_TRUE(array.resize(-5) == NULL);
+        EXPECT_EQ(array.size(), 0);
+        EXPECT_EQ(Tracked::s_live, 0);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+
+    MleArray<std::string> strings;
+    for (int i = 0; i < 1000; i++)
+        strings.push_back(std::string(40, (char) ('a' + i % 26)));
+    EXPECT_EQ(strings[999], std::string(40, 'a' + 999 % 26));
+}
+
+TEST(MleArrayTest, CopyAndMove) {
+    {
+        MleArray<Tracked> array(3);
+        array[0].m_value = 7;
+        array[2].m_value = 9;
+
+        MleArray<Tracked> copy(array);
+        EXPECT_EQ(copy.size(), 3);
+        EXPECT_EQ(copy[2].m_value, 9);
+        EXPECT_EQ(Tracked::s_live, 6);
+
+        MleArray<Tracked> moved(std::move(copy));
+        EXPECT_EQ(copy.size(), 0);
+        EXPECT_EQ(moved[0].m_value, 7);
+        EXPECT_EQ(Tracked::s_live, 6);
+
+        MleArray<Tracked> assigned;
+        assigned.push_back(Tracked(1));
+        assigned = array;
+        EXPECT_EQ(assigned.size(), 3);
+        assigned = std::move(moved);
+        EXPECT_EQ(assigned[2].m_value, 9);
+        EXPECT_EQ(Tracked::s_live, 6);
+
+        assigned = assigned;
+        EXPECT_EQ(assigned.size(), 3);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+
+    MleArray<int> numbers;
+    for (int i = 0; i < 5; i++)
+        numbers.push_back(i);
+    MleArray<int> copy;
+    copy = numbers;
+    EXPECT_EQ(copy.size(), 5);
+    EXPECT_EQ(copy[4], 4);
+}
+
+TEST(MleArrayTest, ManagerAllocator) {
+    // The default policy has no state to store.
+    EXPECT_EQ(sizeof(MleArray<int>), 2 * sizeof(int) + sizeof(int *));
+
+    MleProfilingMemoryManager manager;
+    MleAllocationStats stats;
+    {
+        MleArray<int, MleManagerAllocator> array((MleManagerAllocator(&manager)));
+        for (int i = 0; i < 100; i++)
+            ASSERT_NE(array.push_back(i), (int *) NULL);
+        manager.getStats(stats);
+        EXPECT_GE(stats.m_bytesLive, 100 * sizeof(int));
+        EXPECT_GE(stats.m_allocations, 1u);
+
+        // Copies and moves stay bound to the manager.
+        MleArray<int, MleManagerAllocator> copy(array);
+        EXPECT_EQ(copy.getAllocator().getManager(), &manager);
+        MleArray<int, MleManagerAllocator> moved(std::move(copy));
+        EXPECT_EQ(moved.getAllocator().getManager(), &manager);
+        EXPECT_EQ(moved[99], 99);
+        manager.getStats(stats);
+        EXPECT_GE(stats.m_bytesLive, 200 * sizeof(int));
+
+        MleArray<Tracked, MleManagerAllocator> tracked(3, MleManagerAllocator(&manager));
+        tracked.emplace_back(5);
+        EXPECT_EQ(tracked[3].m_value, 5);
+    }
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_bytesLive, 0u);
+    EXPECT_EQ(stats.m_releases, stats.m_allocations);
+}
+
+TEST(MleArrayTest, ArenaAllocator) {
+    MleArenaMemoryManager arena;
+    MleArenaMemoryManager::Scope scope(arena);
+    MlULong before = arena.getAllocatedSize();
+
+    MleArray<int, MleManagerAllocator> array((MleManagerAllocator(&arena)));
+    array.reserve(64);
+    EXPECT_GE(arena.getAllocatedSize(), before + 64 * sizeof(int));
+
+    // The last block of an arena grows in place.
+    int *data = array.resize(64);
+    array.reserve(1000);
+    EXPECT_EQ(array + 0, data);
+
+    MleSmallArray<int, 8, MleManagerAllocator> small((MleManagerAllocator(&arena)));
+    MlULong allocated = arena.getAllocatedSize();
+    for (int i = 0; i < 8; i++)
+        small.push_back(i);
+    EXPECT_EQ(arena.getAllocatedSize(), allocated);
+    small.push_back(8);
+    EXPECT_GT(arena.getAllocatedSize(), allocated);
+    EXPECT_EQ(small[8], 8);
+}
+
+TEST(MleSmallArrayTest, StaysInlineUpToN) {
+    MleSmallArray<int, 8> array;
+    EXPECT_TRUE(array.isInline());
+    EXPECT_EQ(array.capacity(), 8);
+    EXPECT_EQ(array.resize(0), (int *) NULL);
+
+    int *data = array + 0;
+    for (int i = 0; i < 8; i++)
+        ASSERT_NE(array.push_back(i), (int *) NULL);
+    EXPECT_TRUE(array.isInline());
+    EXPECT_EQ(array + 0, data);
+    EXPECT_GE((char *) data, (char *) &array);
+    EXPECT_LT((char *) data, (char *) &array + sizeof(array));
+
+    // The ninth element spills the array to the heap.
+    array[8] = 8;
+    EXPECT_FALSE(array.isInline());
+    EXPECT_GE(array.capacity(), 16);
+    for (int i = 0; i < 1000; i++)
+        array[i] = i;
+    EXPECT_EQ(array.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(array[i], i);
+
+    // Shrinking to fit brings the elements back once they fit.
+    array.resize(5);
+    array.shrink_to_fit();
+    EXPECT_TRUE(array.isInline());
+    EXPECT_EQ(array.capacity(), 8);
+    for (int i = 0; i < 5; i++)
+        ASSERT_EQ(array[i], i);
+
+    EXPECT_NE(array.reserve(100), (int *) NULL);
+    EXPECT_FALSE(array.isInline());
+    EXPECT_EQ(array.size(), 5);
+    EXPECT_EQ(array[4], 4);
+}
+
+TEST(MleSmallArrayTest, NonTrivialElements) {
+    Tracked::s_live = 0;
+    {
+        MleSmallArray<Tracked, 4> array(3);
+        EXPECT_EQ(Tracked::s_live, 3);
+        array.emplace_back(7);
+        EXPECT_TRUE(array.isInline());
+
+        // Appending an element of the array itself while spilling.
+        array.push_back(array[3]);
+        EXPECT_FALSE(array.isInline());
+        EXPECT_EQ(array.size(), 5);
+        EXPECT_EQ(array[4].m_value, 7);
+        EXPECT_EQ(Tracked::s_live, 5);
+
+        array.resize(2);
+        EXPECT_EQ(Tracked::s_live, 2);
+        array.shrink_to_fit();
+        EXPECT_TRUE(array.isInline());
+        EXPECT_EQ(Tracked::s_live, 2);
+
+        array.resize(-1);
+        EXPECT_EQ(array.size(), 0);
+        EXPECT_EQ(Tracked::s_live, 0);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+}
+
+TEST(MleSmallArrayTest, CopyAndMove) {
+    Tracked::s_live = 0;
+    {
+        MleSmallArray<Tracked, 4> small;
+        MleSmallArray<Tracked, 4> large;
+        for (int i = 0; i < 3; i++)
+            small.emplace_back(i);
+        for (int i = 0; i < 10; i++)
+            large.emplace_back(i);
+
+        MleSmallArray<Tracked, 4> copy(large);
+        EXPECT_FALSE(copy.isInline());
+        EXPECT_EQ(copy.size(), 10);
+        EXPECT_EQ(copy[9].m_value, 9);
+        copy = small;
+        EXPECT_EQ(copy.size(), 3);
+        EXPECT_EQ(copy[2].m_value, 2);
+        EXPECT_EQ(Tracked::s_live, 16);
+
+        // Moving embedded elements moves each one; moving a heap block
+        // takes it over.
+        MleSmallArray<Tracked, 4> movedSmall(std::move(small));
+        EXPECT_TRUE(movedSmall.isInline());
+        EXPECT_EQ(movedSmall.size(), 3);
+        EXPECT_EQ(movedSmall[1].m_value, 1);
+        EXPECT_EQ(small.size(), 0);
+
+        Tracked *data = large + 0;
+        MleSmallArray<Tracked, 4> movedLarge(std::move(large));
+        EXPECT_EQ(movedLarge + 0, data);
+        EXPECT_EQ(movedLarge.size(), 10);
+        EXPECT_EQ(large.size(), 0);
+        EXPECT_TRUE(large.isInline());
+        EXPECT_EQ(Tracked::s_live, 16);
+
+        copy = std::move(movedLarge);
+        EXPECT_EQ(copy + 0, data);
+        EXPECT_EQ(Tracked::s_live, 13);
+        movedSmall = std::move(copy);
+        EXPECT_EQ(movedSmall.size(), 10);
+        EXPECT_EQ(Tracked::s_live, 10);
+
+        // The emptied arrays are still usable.
+        large.push_back(Tracked(5));
+        EXPECT_EQ(large[0].m_value, 5);
+        EXPECT_EQ(Tracked::s_live, 11);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+}
+
+TEST(MleArrayTest, AlignedAllocator) {
+    MleArray<float, MleAlignedAllocator<64> > array;
+    for (int i = 0; i < 5000; i++)
+	{
+        array[i] = (float) i;
+        ASSERT_EQ(((uintptr_t) (array + 0)) % 64, 0u);
+    }
+    for (int i = 0; i < 5000; i++)
+        ASSERT_EQ(array[i], (float) i);
+
+    array.resize(10);
+    array.shrink_to_fit();
+    EXPECT_EQ(((uintptr_t) (array + 0)) % 64, 0u);
+    EXPECT_EQ(array[9], 9.0f);
+
+    MleSmallArray<double, 4, MleAlignedAllocator<32> > small(100);
+    EXPECT_EQ(((uintptr_t) (small + 0)) % 32, 0u);
+}
+
+
+// Checks every operation on element type T against plain loops, for every
+// instruction set the processor supports, at sizes and offsets that cover
+// the vector loops and their tails.
+template <class T> static void
+checkArrayOps(T (*value)(int))
+{
+    MleArrayOps::InstructionSet supported = MleArrayOps::getSupportedInstructionSet();
+    for (int set = MleArrayOps::SCALAR; set <= supported; set++)
+	{
+        EXPECT_EQ(MleArrayOps::setInstructionSet((MleArrayOps::InstructionSet) set), set);
+        SCOPED_TRACE(MleArrayOps::getInstructionSetName((MleArrayOps::InstructionSet) set));
+
+        T data[300], other[300];
+        for (int count = 0; count <= 200; count += (count < 40) ? 1 : 23)
+		{
+            for (int offset = 0; offset < 3; offset++)
+			{
+                SCOPED_TRACE(count);
+                T *a = data + offset;
+                T *b = other + offset;
+                for (int i = 0; i < count; i++)
+                    a[i] = value(i);
+
+                T low = 0, high = 0, total = 0;
+                for (int i = 0; i < count; i++)
+				{
+                    low = (i == 0 || a[i] < low) ? a[i] : low;
+                    high = (i == 0 || a[i] > high) ? a[i] : high;
+                    total += a[i];
+                }
+                T minimum = 1, maximum = 1;
+                EXPECT_EQ(MleArrayOps::minMax(a, count, minimum, maximum), (count > 0) ? TRUE : FALSE);
+                if (count > 0)
+				{
+                    EXPECT_EQ(minimum, low);
+                    EXPECT_EQ(maximum, high);
+                }
+                EXPECT_EQ(MleArrayOps::sum(a, count), total);
+
+                for (int i = 0; i < count; i += 7)
+				{
+                    int first = 0;
+                    while (a[first] != a[i])
+                        first++;
+                    EXPECT_EQ(MleArrayOps::find(a, count, a[i]), (size_t) first);
+                }
+                EXPECT_EQ(MleArrayOps::find(a, count, (T) 1000), (size_t) count);
+
+                MleArrayOps::copy(b, a, count);
+                EXPECT_EQ(MleArrayOps::compare(a, b, count), (size_t) count);
+                for (int i = 0; i < count; i += 5)
+				{
+                    b[i] = (T) 999;
+                    EXPECT_EQ(MleArrayOps::compare(a, b, count), (size_t) i);
+                    b[i] = a[i];
+                }
+
+                MleArrayOps::axpy(b, (T) 3, a, count);
+                for (int i = 0; i < count; i++)
+                    ASSERT_EQ(b[i], a[i] * 4);
+                MleArrayOps::scale(b, (T) 2, count);
+                MleArrayOps::add(b, a, count);
+                for (int i = 0; i < count; i++)
+                    ASSERT_EQ(b[i], a[i] * 9);
+
+                b[count] = (T) 5;
+                MleArrayOps::fill(b, (T) 7, count);
+                for (int i = 0; i < count; i++)
+                    ASSERT_EQ(b[i], (T) 7);
+                EXPECT_EQ(b[count], (T) 5);
+            }
+        }
+    }
+    MleArrayOps::setInstructionSet(supported);
+}
+
+// Small whole numbers, so that float and double sums are exact.
+static float floatValue(int i) { return (float) ((i * 37) % 101 - 50); }
+static double doubleValue(int i) { return (double) ((i * 53) % 97 - 48); }
+static int intValue(int i) { return (i * 7919) % 1009 - 504; }
+
+TEST(MleArrayOpsTest, Float) {
+    checkArrayOps<float>(floatValue);
+}
+
+TEST(MleArrayOpsTest, Double) {
+    checkArrayOps<double>(doubleValue);
+}
+
+TEST(MleArrayOpsTest, Int) {
+    checkArrayOps<int>(intValue);
+
+    // Arithmetic wraps around as it would in unsigned arithmetic.
+    int big[64];
+    MleArrayOps::fill(big, 0x40000000, 64);
+    EXPECT_EQ(MleArrayOps::sum(big, 64), 0);
+    MleArrayOps::scale(big, 4, 64);
+    EXPECT_EQ(big[63], 0);
+}
+
+TEST(MleArrayOpsTest, Arrays) {
+    MleArray<float, MleAlignedAllocator<64> > x;
+    MleArray<float> y;
+    for (int i = 0; i < 1000; i++)
+        x[i] = (float) i;
+
+    EXPECT_EQ(MleArrayOps::copy(y, x), TRUE);
+    EXPECT_EQ(y.size(), 1000);
+    EXPECT_EQ(MleArrayOps::compare(x, y), -1);
+    MleArrayOps::axpy(y, 2.0f, x);
+    EXPECT_EQ(y[999], 2997.0f);
+    EXPECT_EQ(MleArrayOps::compare(x, y), 1);
+    MleArrayOps::scale(y, 0.5f);
+    EXPECT_EQ(MleArrayOps::find(x, 500.0f), 500);
+    EXPECT_EQ(MleArrayOps::find(x, -1.0f), -1);
+    EXPECT_EQ(MleArrayOps::sum(x), 499500.0f);
+
+    float low, high;
+    EXPECT_EQ(MleArrayOps::minMax(x, low, high), TRUE);
+    EXPECT_EQ(low, 0.0f);
+    EXPECT_EQ(high, 999.0f);
+    MleArray<float> empty;
+    EXPECT_EQ(MleArrayOps::minMax(empty, low, high), FALSE);
+    EXPECT_EQ(MleArrayOps::sum(empty), 0.0f);
+    EXPECT_EQ(MleArrayOps::compare(empty, x), 0);
+
+    MleArrayOps::fill(x, 1.0f);
+    MleArrayOps::add(y, x);
+    EXPECT_EQ(y[10], 16.0f);
+}
+
+TEST(MleSoAArrayTest, Columns) {
+    MleSoAArray<float, double, char> array;
+    for (int i = 0; i < 1000; i++)
+        ASSERT_TRUE(array.push_back((float) i, i * 0.5, (char) ('a' + i % 26)));
+    EXPECT_EQ(array.size(), 1000);
+    EXPECT_GE(array.capacity(), 1000);
+
+    // Each column is contiguous and aligned.
+    MleSpan<float> x = array.field<0>();
+    MleSpan<double> y = array.field<1>();
+    MleSpan<char> tag = array.field<2>();
+    EXPECT_EQ(x.size(), 1000);
+    EXPECT_EQ(((uintptr_t) x.data()) % 64, 0u);
+    EXPECT_EQ(((uintptr_t) y.data()) % 64, 0u);
+    EXPECT_EQ(((uintptr_t) tag.data()) % 64, 0u);
+    EXPECT_EQ(&x[1], &x[0] + 1);
+    EXPECT_EQ(MleArrayOps::sum(x.data(), x.size()), 499500.0f);
+    char sum = 0;
+    for (char c : tag)
+        sum += c;
+    EXPECT_NE(sum, 0);
+
+    // Elements are seen through tuples of references.
+    auto [first, half, letter] = array[3];
+    EXPECT_EQ(first, 3.0f);
+    EXPECT_EQ(half, 1.5);
+    EXPECT_EQ(letter, 'd');
+    std::get<1>(array[3]) = 7.0;
+    EXPECT_EQ(array.get<1>(3), 7.0);
+    array[4] = MleSoAArray<float, double, char>::Value(-1.0f, -2.0, 'z');
+    EXPECT_EQ(array.get<0>(4), -1.0f);
+    EXPECT_EQ(y[4], -2.0);
+
+    // Indexing past the end grows the array.
+    std::get<2>(array[1500]) = 'q';
+    EXPECT_EQ(array.size(), 1501);
+    EXPECT_EQ(array.get<2>(1500), 'q');
+    EXPECT_EQ(array.get<0>(999), 999.0f);
+
+    array.resize(10);
+    array.shrink_to_fit();
+    EXPECT_EQ(array.capacity(), 10);
+    EXPECT_EQ(array.get<0>(9), 9.0f);
+    const MleSoAArray<float, double, char> &constant = array;
+    EXPECT_EQ(std::get<2>(constant[2]), 'c');
+    EXPECT_EQ(constant.field<1>()[2], 1.0);
+}
+
+TEST(MleSoAArrayTest, NonTrivialFields) {
+    Tracked::s_live = 0;
+    {
+        MleSoAArray<Tracked, int> array(2);
+        EXPECT_EQ(Tracked::s_live, 2);
+        for (int i = 0; i < 50; i++)
+            array.push_back(Tracked(i), i);
+
+        // Appending an element of the array itself while growing.
+        while (array.size() < array.capacity())
+            array.push_back(Tracked(0), 0);
+        array.push_back(array.get<0>(10), array.get<1>(10));
+        EXPECT_EQ(array.get<0>(array.size() - 1).m_value, 8);
+        EXPECT_EQ(Tracked::s_live, array.size());
+
+        MleSoAArray<Tracked, int> copy(array);
+        EXPECT_EQ(Tracked::s_live, 2 * array.size());
+        MleSoAArray<Tracked, int> moved(std::move(copy));
+        EXPECT_EQ(copy.size(), 0);
+        EXPECT_EQ(moved.get<0>(20).m_value, 18);
+        EXPECT_EQ(Tracked::s_live, 2 * array.size());
+
+        array = moved;
+        array.resize(5);
+        moved = std::move(array);
+        EXPECT_EQ(moved.size(), 5);
+        EXPECT_EQ(Tracked::s_live, 5);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+}
+
+struct Particle
+{
+    float m_x;
+    float m_y;
+    int m_id;
+    double m_unused;
+};
+
+TEST(MleSoAArrayTest, ConvertArrayOfStructures) {
+    MleArray<Particle> particles;
+    for (int i = 0; i < 100; i++)
+	{
+        particles[i].m_x = (float) i;
+        particles[i].m_y = (float) -i;
+        particles[i].m_id = i * 3;
+    }
+
+    MleBasicSoAArray<MleMallocAllocator, float, float, int> array;
+    ASSERT_TRUE(array.fromArray(particles, &Particle::m_x, &Particle::m_y, &Particle::m_id));
+    EXPECT_EQ(array.size(), 100);
+    EXPECT_EQ(array.get<1>(50), -50.0f);
+    EXPECT_EQ(array.get<2>(99), 297);
+
+    MleArrayOps::scale(array.field<0>().data(), 2.0f, array.size());
+    MleArray<Particle> result;
+    ASSERT_TRUE(array.toArray(result, &Particle::m_x, &Particle::m_y, &Particle::m_id));
+    EXPECT_EQ(result.size(), 100);
+    EXPECT_EQ(result[7].m_x, 14.0f);
+    EXPECT_EQ(result[7].m_y, -7.0f);
+    EXPECT_EQ(result[7].m_id, 21);
+
+    MleArray<Particle> empty;
+    ASSERT_TRUE(array.fromArray(empty, &Particle::m_x, &Particle::m_y, &Particle::m_id));
+    EXPECT_EQ(array.size(), 0);
+    ASSERT_TRUE(array.toArray(result, &Particle::m_x, &Particle::m_y, &Particle::m_id));
+    EXPECT_EQ(result.size(), 0);
+}
+
+TEST(MleConcurrentArrayTest, StableElements) {
+    MleConcurrentArray<int> array;
+    EXPECT_EQ(array.get(0), (int *) NULL);
+
+    int *pointers[5000];
+    for (int i = 0; i < 5000; i++)
+	{
+        pointers[i] = array.push_back(i);
+        ASSERT_NE(pointers[i], (int *) NULL);
+    }
+    EXPECT_EQ(array.size(), 5000);
+    for (int i = 0; i < 5000; i++)
+	{
+        ASSERT_EQ(array.get(i), pointers[i]);
+        ASSERT_EQ(array[i], i);
+    }
+    EXPECT_EQ(array.get(5000), (int *) NULL);
+    EXPECT_EQ(array.get(-1), (int *) NULL);
+
+    // Segments double in size, so the elements sit in runs of 32, 64, ...
+    EXPECT_EQ(pointers[31], pointers[0] + 31);
+    EXPECT_EQ(pointers[95], pointers[32] + 63);
+
+    int count = 0;
+    long long total = 0;
+    array.forEach([&](int value) { count++; total += value; });
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(total, 5000LL * 4999 / 2);
+
+    array.clear();
+    EXPECT_EQ(array.size(), 0);
+    EXPECT_EQ(array.get(0), (int *) NULL);
+    EXPECT_EQ(*array.push_back(7), 7);
+}
+
+TEST(MleConcurrentArrayTest, NonTrivialElements) {
+    Tracked::s_live = 0;
+    {
+        MleConcurrentArray<Tracked> array;
+        for (int i = 0; i < 100; i++)
+            array.emplace_back(i);
+        EXPECT_EQ(Tracked::s_live, 100);
+        EXPECT_EQ(array[99].m_value, 99);
+    }
+    EXPECT_EQ(Tracked::s_live, 0);
+}
+
+TEST(MleConcurrentArrayTest, ConcurrentAppend) {
+    const int THREADS = 8;
+    const int PER_THREAD = 20000;
+
+    // Once the segments are reserved, appending does not allocate.
+    MleProfilingMemoryManager manager;
+    MleConcurrentArray<int, MleManagerAllocator> array((MleManagerAllocator(&manager)));
+    ASSERT_TRUE(array.reserve(THREADS * PER_THREAD));
+    MleAllocationStats stats;
+    manager.getStats(stats);
+    MlULong allocations = stats.m_allocations;
+
+    std::atomic<bool> done(false);
+    std::atomic<int> readerErrors(0);
+    std::thread reader([&]()
+    {
+        while (! done.load())
+		{
+            int size = array.size();
+            for (int i = 0; i < size; i += 97)
+			{
+                const int *element = array.get(i);
+                if ((element != NULL) && ((*element >> 20) >= THREADS))
+                    readerErrors++;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; t++)
+	{
+        writers.push_back(std::thread([&array, t, PER_THREAD]()
+        {
+            for (int n = 0; n < PER_THREAD; n++)
+                array.push_back((t << 20) | n);
+        }));
+    }
+    for (int t = 0; t < THREADS; t++)
+        writers[t].join();
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(readerErrors.load(), 0);
+    EXPECT_EQ(array.size(), THREADS * PER_THREAD);
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_allocations, allocations);
+
+    // Every value is there once, and each thread's values are in order.
+    int next[THREADS] = { 0 };
+    array.forEach([&](int value)
+    {
+        int t = value >> 20;
+        ASSERT_EQ(value & 0xfffff, next[t]);
+        next[t]++;
+    });
+    for (int t = 0; t < THREADS; t++)
+        EXPECT_EQ(next[t], PER_THREAD);
+}
+
+TEST(MleConcurrentArrayTest, ConcurrentSegmentAllocation) {
+    // Threads race to install the same segments.
+    for (int round = 0; round < 20; round++)
+	{
+        MleConcurrentArray<MlULong> array;
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; t++)
+		{
+            writers.push_back(std::thread([&array]()
+            {
+                for (int n = 0; n < 3000; n++)
+                    array.push_back((MlULong) n);
+            }));
+        }
+        for (int t = 0; t < 4; t++)
+            writers[t].join();
+        ASSERT_EQ(array.size(), 12000);
+        for (int i = 0; i < 12000; i++)
+            ASSERT_NE(array.get(i), (MlULong *) NULL);
+    }
+}
@@ -0,0 +1,146 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/MleAtom.h"
+#include "mle/mlHashTable.h"
+
+
+TEST(MleAtomTest, InternAndFind) {
+    MleAtom none;
+    EXPECT_TRUE(none.isNull());
+    EXPECT_EQ(none.getId(), 0u);
+    EXPECT_STREQ(none.getString(), "");
+    EXPECT_TRUE(MleAtom("").isNull());
+    EXPECT_TRUE(MleAtom((const char *) NULL).isNull());
+
+    EXPECT_TRUE(MleAtom::find("testAtom.neverInterned").isNull());
+
+    char name[] = "testAtom.position";
+    MleAtom position(name);
+    EXPECT_FALSE(position.isNull());
+    EXPECT_STREQ(position.getString(), "testAtom.position");
+    EXPECT_EQ(position.getLength(), strlen(name));
+    EXPECT_NE(position.getString(), name);
+
+    // Equal strings give the same atom, however they are spelled out.
+    std::string copy(name);
+    EXPECT_EQ(MleAtom(copy.c_str()), position);
+    EXPECT_EQ(MleAtom("testAtom.position.x", 17), position);
+    EXPECT_EQ(MleAtom::find("testAtom.position"), position);
+    EXPECT_EQ(MleAtom(name).getString(), position.getString());
+    EXPECT_EQ(MleAtom(name).getHash(), position.getHash());
+
+    MleAtom rotation("testAtom.rotation");
+    EXPECT_NE(rotation, position);
+    EXPECT_NE(rotation.getId(), position.getId());
+    EXPECT_TRUE(position < rotation);
+
+    EXPECT_EQ(MleAtom::fromId(position.getId()), position);
+    EXPECT_EQ(MleAtom::fromId(rotation.getId()), rotation);
+    EXPECT_TRUE(MleAtom::fromId(0).isNull());
+    EXPECT_TRUE(MleAtom::fromId(MleAtom::getCount() + 1).isNull());
+}
+
+TEST(MleAtomTest, ManyAtoms) {
+    // Enough strings to grow the index several times.
+    const int count = 20000;
+    std::vector<MleAtom> atoms;
+    char name[64];
+    for (int i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "testAtom.many.%d", i);
+        atoms.push_back(MleAtom(name));
+    }
+    EXPECT_GE(MleAtom::getCount(), (uint_t) count);
+
+    for (int i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "testAtom.many.%d", i);
+        MleAtom atom = MleAtom::find(name);
+        if (atom != atoms[i]) {
+            ASSERT_EQ(atom, atoms[i]) << name;
+        }
+        EXPECT_EQ(MleAtom::fromId(atom.getId()), atom);
+    }
+
+    // Atoms make keys for the hash table.
+    MleHashMap<MleAtom, int> indices;
+    for (int i = 0; i < count; i++)
+        indices.insert(atoms[i], i);
+    MleAtom key = MleAtom::find("testAtom.many.1234");
+    ASSERT_NE(indices.find(key), (int *) NULL);
+    EXPECT_EQ(*indices.find(key), 1234);
+}
+
+TEST(MleAtomTest, ConcurrentInterning) {
+    // Threads intern overlapping sets of names and must agree on the atoms.
+    const int numThreads = 4;
+    const int count = 5000;
+    std::vector<std::vector<MleAtom> > results(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&results, t]() {
+            char name[64];
+            for (int i = 0; i < count; i++) {
+                int n = (t % 2 == 0) ? i : count - 1 - i;
+                snprintf(name, sizeof(name), "testAtom.shared.%d", n);
+                MleAtom atom(name);
+                results[t].push_back(atom);
+                if (MleAtom::find(name) != atom || strcmp(atom.getString(), name) != 0)
+                    results[t].back() = MleAtom();
+            }
+        }));
+    }
+    for (int t = 0; t < numThreads; t++)
+        threads[t].join();
+
+    for (int i = 0; i < count; i++) {
+        MleAtom atom = results[0][i];
+        ASSERT_FALSE(atom.isNull());
+        for (int t = 1; t < numThreads; t++) {
+            int n = (t % 2 == 0) ? i : count - 1 - i;
+            if (results[t][n] != atom) {
+                ASSERT_EQ(results[t][n], atom) << i;
+            }
+        }
+    }
+}
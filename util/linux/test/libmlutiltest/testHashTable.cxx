@@ -0,0 +1,243 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/mlHashTable.h"
+#include "mle/MleProfilingMemoryManager.h"
+
+
+// A value that counts how many of its kind are alive.
+struct LiveValue
+{
+    static int s_live;
+    int m_value;
+    LiveValue(int value) : m_value(value) { s_live++; }
+    LiveValue(const LiveValue &other) : m_value(other.m_value) { s_live++; }
+    LiveValue(LiveValue &&other) noexcept : m_value(other.m_value) { other.m_value = -1; s_live++; }
+    ~LiveValue() { s_live--; }
+    LiveValue &operator=(const LiveValue &other) { m_value = other.m_value; return *this; }
+};
+
+int LiveValue::s_live = 0;
+
+// A hash function that puts every key in the same group.
+struct CollidingHash
+{
+    size_t operator()(int) const { return 42; }
+};
+
+
+TEST(MleHashMapTest, InsertFindErase) {
+    MleHashMap<int, int> map;
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.find(1), (int *) NULL);
+    EXPECT_FALSE(map.erase(1));
+
+    for (int i = 0; i < 10000; i++)
+        ASSERT_NE(map.insert(i, i * 2), (int *) NULL);
+    EXPECT_EQ(map.size(), 10000);
+    EXPECT_GE(map.capacity() - map.capacity() / 8, 10000);
+    for (int i = 0; i < 10000; i++) {
+        const int *value = map.find(i);
+        ASSERT_NE(value, (const int *) NULL);
+        ASSERT_EQ(*value, i * 2);
+    }
+    EXPECT_FALSE(map.contains(10000));
+    EXPECT_FALSE(map.contains(-1));
+
+    // Insert replaces a value; emplace keeps it.
+    EXPECT_EQ(*map.insert(7, 70), 70);
+    EXPECT_EQ(*map.emplace(7, 700), 70);
+    EXPECT_EQ(*map.emplace(20000, 5), 5);
+    EXPECT_EQ(map.size(), 10001);
+
+    for (int i = 0; i < 10000; i += 2)
+        ASSERT_TRUE(map.erase(i));
+    EXPECT_EQ(map.size(), 5001);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(map.contains(i), (i % 2) != 0);
+
+    // Every entry is visited once.
+    long long sum = 0;
+    int count = 0;
+    for (MleHashMapEntry<int, int> &entry : map) {
+        sum += entry.first;
+        count++;
+    }
+    EXPECT_EQ(count, map.size());
+    EXPECT_EQ(sum, 25000000LL + 20000);
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(MleHashMapTest, ErasedSlotsAreReused) {
+    // Keys come and go, but no more than 100 are in the map at once.
+    MleHashMap<int, int> map;
+    for (int i = 0; i < 100000; i++) {
+        ASSERT_NE(map.insert(i, i), (int *) NULL);
+        if (i >= 100) {
+            ASSERT_TRUE(map.erase(i - 100));
+        }
+    }
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_LE(map.capacity(), 256);
+    for (int i = 99900; i < 100000; i++)
+        ASSERT_EQ(*map.find(i), i);
+
+    // Keys in one probe sequence stay reachable across erasures.
+    MleHashMap<int, int, CollidingHash> colliding;
+    for (int i = 0; i < 40; i++)
+        ASSERT_NE(colliding.insert(i, i), (int *) NULL);
+    for (int i = 0; i < 40; i += 3)
+        ASSERT_TRUE(colliding.erase(i));
+    for (int i = 0; i < 40; i++)
+        ASSERT_EQ(colliding.contains(i), (i % 3) != 0);
+    for (int i = 0; i < 40; i += 3)
+        ASSERT_EQ(*colliding.insert(i, -i), -i);
+    for (int i = 0; i < 40; i++)
+        ASSERT_EQ(*colliding.find(i), (i % 3) ? i : -i);
+}
+
+TEST(MleHashMapTest, StringKeys) {
+    MleHashMap<std::string, int> map;
+    const char *names[] = { "MleActor", "MleRole", "MleSet", "MleStage", "MleGroup" };
+    for (int i = 0; i < 5; i++)
+        ASSERT_NE(map.insert(names[i], i), (int *) NULL);
+
+    // Looked up by const char * without building a string.
+    EXPECT_EQ(*map.find("MleSet"), 2);
+    EXPECT_EQ(*map.find(std::string("MleStage")), 3);
+    EXPECT_EQ(map.find("MleScene"), (int *) NULL);
+    EXPECT_TRUE(map.erase("MleRole"));
+    EXPECT_FALSE(map.contains("MleRole"));
+
+    // const char * keys are compared by their characters.
+    MleHashMap<const char *, int> byName;
+    char buffer[16];
+    strcpy(buffer, "MleActor");
+    ASSERT_NE(byName.insert(names[0], 1), (int *) NULL);
+    EXPECT_EQ(*byName.find((const char *) buffer), 1);
+    EXPECT_TRUE(byName.contains(std::string("MleActor")));
+}
+
+TEST(MleHashMapTest, NonTrivialValues) {
+    {
+        MleHashMap<int, LiveValue> map;
+        for (int i = 0; i < 1000; i++)
+            ASSERT_NE(map.emplace(i, i), (LiveValue *) NULL);
+        EXPECT_EQ(LiveValue::s_live, 1000);
+
+        MleHashMap<int, LiveValue> copy(map);
+        EXPECT_EQ(LiveValue::s_live, 2000);
+        EXPECT_EQ(copy.find(500)->m_value, 500);
+
+        MleHashMap<int, LiveValue> moved(std::move(copy));
+        EXPECT_EQ(copy.size(), 0);
+        EXPECT_EQ(moved.size(), 1000);
+        EXPECT_EQ(LiveValue::s_live, 2000);
+
+        for (int i = 0; i < 1000; i += 2)
+            moved.erase(i);
+        EXPECT_EQ(LiveValue::s_live, 1500);
+
+        map = moved;
+        EXPECT_EQ(map.size(), 500);
+        EXPECT_EQ(LiveValue::s_live, 1000);
+        EXPECT_FALSE(map.contains(2));
+        EXPECT_EQ(map.find(3)->m_value, 3);
+
+        moved.clear();
+        EXPECT_EQ(LiveValue::s_live, 500);
+    }
+    EXPECT_EQ(LiveValue::s_live, 0);
+}
+
+TEST(MleHashMapTest, ManagerAllocator) {
+    MleProfilingMemoryManager manager;
+    MleAllocationStats stats;
+    {
+        MleHashMap<int, int, MleHash<int>, MleEqual<int>, MleManagerAllocator> map((MleManagerAllocator(&manager)));
+        ASSERT_TRUE(map.reserve(1000));
+        manager.getStats(stats);
+        EXPECT_EQ(stats.m_allocations, 1u);
+
+        // Reserved room is used without allocating.
+        for (int i = 0; i < 1000; i++)
+            ASSERT_NE(map.insert(i, i), (int *) NULL);
+        manager.getStats(stats);
+        EXPECT_EQ(stats.m_allocations, 1u);
+        EXPECT_GE(stats.m_bytesLive, 1000 * (sizeof(int) * 2 + 1));
+        EXPECT_EQ(map.getAllocator().getManager(), &manager);
+    }
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_bytesLive, 0u);
+    EXPECT_EQ(stats.m_releases, stats.m_allocations);
+}
+
+TEST(MleHashSetTest, InsertFindErase) {
+    MleHashSet<std::string> names;
+    const std::string *actor = names.insert("MleActor");
+    ASSERT_NE(actor, (const std::string *) NULL);
+    EXPECT_EQ(*actor, "MleActor");
+
+    // Inserting an equal key gives back the one in the set.
+    EXPECT_EQ(names.insert(std::string("MleActor")), actor);
+    EXPECT_EQ(names.find("MleActor"), actor);
+    EXPECT_EQ(names.size(), 1);
+
+    MleHashSet<int> set;
+    for (int i = 0; i < 500; i++)
+        ASSERT_NE(set.insert(i * 7), (const int *) NULL);
+    int count = 0;
+    for (const int &value : set) {
+        EXPECT_EQ(value % 7, 0);
+        count++;
+    }
+    EXPECT_EQ(count, 500);
+    EXPECT_TRUE(set.erase(14));
+    EXPECT_FALSE(set.erase(14));
+    EXPECT_FALSE(set.contains(14));
+    EXPECT_TRUE(set.contains(21));
+}
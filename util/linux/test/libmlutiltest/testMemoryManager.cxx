@@ -0,0 +1,930 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/MleMemoryManager.h"
+#include "mle/MleAllocationReplay.h"
+#include "mle/MleArenaMemoryManager.h"
+#include "mle/MleLinuxNumaMemoryManager.h"
+#include "mle/MleProfilingMemoryManager.h"
+#include "mle/MleRecordingMemoryManager.h"
+#include "mle/MleThreadCacheMemoryManager.h"
+
+
+TEST(MemoryManagerTest, AllocateResizeRelease) {
+    MleMemoryManager *manager = MleMemoryManager::getManager();
+    ASSERT_NE(manager, nullptr);
+
+    void *memory = NULL;
+    ASSERT_EQ(manager->allocate(&memory, 16), MLE_S_OK);
+    ASSERT_NE(memory, nullptr);
+    memset(memory, 0xa5, 16);
+
+    ASSERT_EQ(manager->resize(&memory, 4096), MLE_S_OK);
+    EXPECT_EQ(((unsigned char *)memory)[15], 0xa5);
+
+    ASSERT_EQ(manager->release(&memory), MLE_S_OK);
+    EXPECT_EQ(memory, nullptr);
+}
+
+TEST(MemoryManagerTest, ConcurrentFirstUse) {
+    MleMemoryManager *managers[8];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++)
+        threads.push_back(std::thread([&managers, t]() {
+            managers[t] = MleMemoryManager::getManager();
+        }));
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    for (int t = 1; t < 8; t++)
+        EXPECT_EQ(managers[t], managers[0]);
+}
+
+TEST(MemoryManagerTest, ThreadManagerStack) {
+    MleMemoryManager *global = MleMemoryManager::getManager();
+    MleArenaMemoryManager arena;
+    MleMemoryManager other;
+
+    EXPECT_EQ(MleMemoryManager::popManager(), nullptr);
+    {
+        MleMemoryManagerScope outer(&arena);
+        EXPECT_EQ(MleMemoryManager::getManager(), &arena);
+        {
+            MleMemoryManagerScope inner(&other);
+            EXPECT_EQ(MleMemoryManager::getManager(), &other);
+
+            // Other threads keep using the global manager.
+            MleMemoryManager *seen = NULL;
+            std::thread thread([&seen]() { seen = MleMemoryManager::getManager(); });
+            thread.join();
+            EXPECT_EQ(seen, global);
+        }
+        EXPECT_EQ(MleMemoryManager::getManager(), &arena);
+
+        MlChar *text = NULL;
+        ASSERT_EQ(MleMemoryManager::getManager()->dupString((const MlChar *)"arena", &text), MLE_S_OK);
+        EXPECT_GT(arena.getAllocatedSize(), 0u);
+    }
+    EXPECT_EQ(MleMemoryManager::getManager(), global);
+}
+
+TEST(MemoryManagerTest, FailureInjection) {
+    MleMemoryManager manager;
+    void *memory[4] = { NULL };
+
+    // Only the calling thread is limited.
+    MleMemoryManager::setThreadAllocationLimit(3);
+    for (int i = 0; i < 3; i++)
+        ASSERT_EQ(manager.allocate(&memory[i], 16), MLE_S_OK);
+    EXPECT_NE(manager.allocate(&memory[3], 16), MLE_S_OK);
+
+    MlResult result = MLE_E_FAIL;
+    std::thread thread([&manager, &result]() {
+        void *memory = NULL;
+        result = manager.allocate(&memory, 16);
+        manager.release(&memory);
+    });
+    thread.join();
+    EXPECT_EQ(result, MLE_S_OK);
+
+    MleMemoryManager::setThreadAllocationLimit(0);
+    ASSERT_EQ(manager.allocate(&memory[3], 16), MLE_S_OK);
+
+    MleMemoryManager::setAllocationLimit(1);
+    void *extra = NULL;
+    EXPECT_EQ(manager.allocate(&extra, 16), MLE_S_OK);
+    EXPECT_NE(manager.resize(&extra, 32), MLE_S_OK);
+    MleMemoryManager::setAllocationLimit(0);
+    EXPECT_EQ(manager.resize(&extra, 32), MLE_S_OK);
+    manager.release(&extra);
+
+    for (int i = 0; i < 4; i++)
+        manager.release(&memory[i]);
+}
+
+TEST(MemoryManagerTest, ResizeInPlace) {
+    MleMemoryManager manager;
+
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocate(&memory, 100), MLE_S_OK);
+    MlULong usable = manager.getUsableSize(memory);
+    EXPECT_GE(usable, 100u);
+
+    // Growing into the slack and shrinking keep the block where it is.
+    EXPECT_EQ(manager.tryResizeInPlace(memory, usable), MLE_S_OK);
+    EXPECT_EQ(manager.tryResizeInPlace(memory, 10), MLE_S_OK);
+    EXPECT_NE(manager.tryResizeInPlace(memory, usable + (1 << 20)), MLE_S_OK);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+
+    MleThreadCacheMemoryManager cache;
+    ASSERT_EQ(cache.allocate(&memory, 100), MLE_S_OK);
+    EXPECT_EQ(cache.getUsableSize(memory), 112u);
+    EXPECT_EQ(cache.tryResizeInPlace(memory, 112), MLE_S_OK);
+    EXPECT_NE(cache.tryResizeInPlace(memory, 113), MLE_S_OK);
+    ASSERT_EQ(cache.release(&memory), MLE_S_OK);
+
+    MleBlockMemoryManager<64> blocks(0);
+    ASSERT_EQ(blocks.allocate(&memory, 10), MLE_S_OK);
+    EXPECT_EQ(blocks.getUsableSize(memory), 64u);
+    EXPECT_EQ(blocks.tryResizeInPlace(memory, 64), MLE_S_OK);
+    EXPECT_NE(blocks.tryResizeInPlace(memory, 65), MLE_S_OK);
+    ASSERT_EQ(blocks.release(&memory), MLE_S_OK);
+}
+
+TEST(ArenaMemoryManagerTest, ResizeInPlace) {
+    MleArenaMemoryManager arena(4096);
+
+    void *first = NULL, *last = NULL;
+    ASSERT_EQ(arena.allocate(&first, 20), MLE_S_OK);
+    ASSERT_EQ(arena.allocate(&last, 20), MLE_S_OK);
+
+    // Earlier allocations can only use their padding.
+    EXPECT_EQ(arena.getUsableSize(first), 24u);
+    EXPECT_EQ(arena.tryResizeInPlace(first, 24), MLE_S_OK);
+    EXPECT_NE(arena.tryResizeInPlace(first, 25), MLE_S_OK);
+
+    // The most recent one can use the rest of its chunk.
+    EXPECT_EQ(arena.tryResizeInPlace(last, 2000), MLE_S_OK);
+    EXPECT_EQ(arena.getUsableSize(last), 2008u);
+    EXPECT_NE(arena.tryResizeInPlace(last, 8000), MLE_S_OK);
+}
+
+TEST(ProfilingMemoryManagerTest, ResizeInPlace) {
+    MleThreadCacheMemoryManager cache;
+    MleProfilingMemoryManager manager(&cache);
+
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocate(&memory, 50), MLE_S_OK);
+    // The profiling header comes out of the target's size class.
+    MlULong usable = manager.getUsableSize(memory);
+    EXPECT_GE(usable, 50u);
+    EXPECT_EQ(usable + 16, cache.getUsableSize((MlChar *) memory - 16));
+    ASSERT_EQ(manager.tryResizeInPlace(memory, usable), MLE_S_OK);
+    EXPECT_NE(manager.tryResizeInPlace(memory, usable + 1), MLE_S_OK);
+
+    MleAllocationStats stats;
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_bytesLive, usable);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+}
+
+TEST(MemoryManagerTest, AllocateAligned) {
+    MleMemoryManager manager;
+
+    uint_t alignments[] = { 1, 16, 32, 64, 4096 };
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++) {
+        void *memory = NULL;
+        ASSERT_EQ(manager.allocateAligned(&memory, 1000, alignments[i]), MLE_S_OK);
+        EXPECT_EQ((size_t)memory % alignments[i], 0u);
+        memset(memory, 0, 1000);
+        ASSERT_EQ(manager.releaseAligned(&memory), MLE_S_OK);
+        EXPECT_EQ(memory, nullptr);
+    }
+
+#ifndef MLE_DEBUG
+    // The alignment must be a power of two. Debug builds assert instead.
+    void *memory = NULL;
+    EXPECT_NE(manager.allocateAligned(&memory, 1000, 48), MLE_S_OK);
+#endif /* MLE_DEBUG */
+}
+
+TEST(MemoryManagerTest, AllocateLarge) {
+    MleMemoryManager manager;
+
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocateLarge(&memory, 100), MLE_S_OK);
+    memset(memory, 0x5a, 100);
+    ASSERT_EQ(manager.resizeLarge(&memory, (MlULong)1 << 20), MLE_S_OK);
+    EXPECT_EQ(((unsigned char *)memory)[99], 0x5a);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+
+    // Managers with their own heaps keep 64 bit requests to their limits.
+    MleArenaMemoryManager arena;
+    EXPECT_NE(arena.allocateLarge(&memory, (MlULong)1 << 33), MLE_S_OK);
+    ASSERT_EQ(arena.allocateLarge(&memory, 64), MLE_S_OK);
+
+    MleThreadCacheMemoryManager cache;
+    ASSERT_EQ(cache.allocateLarge(&memory, 64), MLE_S_OK);
+    ASSERT_EQ(cache.resizeLarge(&memory, 100000), MLE_S_OK);
+    ASSERT_EQ(cache.release(&memory), MLE_S_OK);
+}
+
+TEST(MemoryManagerTest, HugePageMode) {
+    setenv("MleHugePages", "2097152", 1);
+    MleMemoryManager manager;
+    unsetenv("MleHugePages");
+
+    // Large requests are mapped on huge page boundaries.
+    const uint_t hugePage = 2 * 1024 * 1024;
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocate(&memory, 3 * hugePage), MLE_S_OK);
+    EXPECT_EQ((size_t)memory % hugePage, 0u);
+    memset(memory, 0x11, 3 * hugePage);
+
+    ASSERT_EQ(manager.resize(&memory, 5 * hugePage), MLE_S_OK);
+    EXPECT_EQ((size_t)memory % hugePage, 0u);
+    EXPECT_EQ(((unsigned char *)memory)[3 * hugePage - 1], 0x11);
+    memset(memory, 0x22, 5 * hugePage);
+
+    // Shrinking below the threshold moves the block back to the heap.
+    ASSERT_EQ(manager.resize(&memory, 1000), MLE_S_OK);
+    EXPECT_EQ(((unsigned char *)memory)[999], 0x22);
+    ASSERT_EQ(manager.resize(&memory, 4 * hugePage), MLE_S_OK);
+    EXPECT_EQ(((unsigned char *)memory)[999], 0x22);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+
+    ASSERT_EQ(manager.allocateAligned(&memory, hugePage, 64), MLE_S_OK);
+    EXPECT_EQ((size_t)memory % hugePage, 0u);
+    ASSERT_EQ(manager.releaseAligned(&memory), MLE_S_OK);
+
+    // Heap blocks on a huge page boundary are not taken for mappings.
+    ASSERT_EQ(manager.allocateAligned(&memory, 4096, hugePage), MLE_S_OK);
+    EXPECT_EQ((size_t)memory % hugePage, 0u);
+    EXPECT_GE(manager.getUsableSize(memory), 4096u);
+    ASSERT_EQ(manager.releaseAligned(&memory), MLE_S_OK);
+
+    // Small requests still come from the heap.
+    ASSERT_EQ(manager.allocate(&memory, 64), MLE_S_OK);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+}
+
+TEST(ThreadCacheMemoryManagerTest, SmallAndLargeAllocations) {
+    MleThreadCacheMemoryManager manager;
+
+    uint_t sizes[] = { 1, 16, 17, 100, 128, 129, 1000, 2048, 2049, 100000 };
+    void *blocks[sizeof(sizes) / sizeof(sizes[0])];
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        ASSERT_EQ(manager.allocate(&blocks[i], sizes[i]), MLE_S_OK);
+        EXPECT_EQ(((size_t)blocks[i]) % 16, 0u);
+        memset(blocks[i], (int)i, sizes[i]);
+    }
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        EXPECT_EQ(((unsigned char *)blocks[i])[sizes[i] - 1], (unsigned char)i);
+        ASSERT_EQ(manager.release(&blocks[i]), MLE_S_OK);
+        EXPECT_EQ(blocks[i], nullptr);
+    }
+
+    EXPECT_EQ(manager.getAllocationCount(), (MlULong)(sizeof(sizes) / sizeof(sizes[0])));
+}
+
+TEST(ThreadCacheMemoryManagerTest, ReusesReleasedBlocks) {
+    MleThreadCacheMemoryManager manager;
+
+    void *first = NULL;
+    ASSERT_EQ(manager.allocate(&first, 40), MLE_S_OK);
+    void *saved = first;
+    ASSERT_EQ(manager.release(&first), MLE_S_OK);
+
+    void *second = NULL;
+    ASSERT_EQ(manager.allocate(&second, 48), MLE_S_OK);
+    EXPECT_EQ(second, saved);
+    ASSERT_EQ(manager.release(&second), MLE_S_OK);
+
+#ifndef MLE_DEBUG
+    // Releasing twice is caught. Debug builds assert instead.
+    EXPECT_NE(manager.release(&saved), MLE_S_OK);
+#endif /* MLE_DEBUG */
+}
+
+TEST(ThreadCacheMemoryManagerTest, ResizeKeepsContents) {
+    MleThreadCacheMemoryManager manager;
+
+    char *text = NULL;
+    ASSERT_EQ(manager.allocate((void **)&text, 10), MLE_S_OK);
+    strcpy(text, "123456789");
+
+    // Within the size class the block does not move.
+    char *before = text;
+    ASSERT_EQ(manager.resize((void **)&text, 16), MLE_S_OK);
+    EXPECT_EQ(text, before);
+
+    ASSERT_EQ(manager.resize((void **)&text, 300), MLE_S_OK);
+    EXPECT_STREQ(text, "123456789");
+    ASSERT_EQ(manager.resize((void **)&text, 5000), MLE_S_OK);
+    EXPECT_STREQ(text, "123456789");
+    ASSERT_EQ(manager.resize((void **)&text, 50000), MLE_S_OK);
+    EXPECT_STREQ(text, "123456789");
+
+    ASSERT_EQ(manager.release((void **)&text), MLE_S_OK);
+}
+
+TEST(ThreadCacheMemoryManagerTest, ConcurrentThreads) {
+    MleThreadCacheMemoryManager manager;
+    const int numThreads = 4;
+    const int numRounds = 2000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&manager, t]() {
+            void *blocks[64];
+            for (int round = 0; round < numRounds; round++) {
+                uint_t size = 8 + ((round * 37 + t * 11) % 1500);
+                void *&block = blocks[round % 64];
+                if (round >= 64)
+                    manager.release(&block);
+                if (manager.allocate(&block, size) == MLE_S_OK)
+                    memset(block, t, size);
+            }
+            for (int i = 0; i < 64; i++)
+                manager.release(&blocks[i]);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    // Exited threads hand their counts back to the manager.
+    EXPECT_EQ(manager.getAllocationCount(), (MlULong)(numThreads * numRounds));
+}
+
+TEST(BlockMemoryManagerTest, AllocateDistinctBlocks) {
+    MleBlockMemoryManager<48> manager(1024);
+    EXPECT_EQ(manager.getBlockSize(), 48u);
+    EXPECT_EQ(manager.getChunkCount(), 1u);
+
+    // Requests larger than the block size are refused.
+    void *memory = NULL;
+    EXPECT_NE(manager.allocate(&memory, 49), MLE_S_OK);
+
+    // Allocate enough blocks to force the heap to grow.
+    std::vector<void *> blocks(5000);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        ASSERT_EQ(manager.allocate(&blocks[i], 48), MLE_S_OK);
+        EXPECT_EQ((size_t)blocks[i] % 16, 0u);
+        memset(blocks[i], (int)i, 48);
+    }
+    EXPECT_GT(manager.getChunkCount(), 1u);
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        EXPECT_EQ(((unsigned char *)blocks[i])[0], (unsigned char)i);
+        EXPECT_EQ(((unsigned char *)blocks[i])[47], (unsigned char)i);
+        ASSERT_EQ(manager.release(&blocks[i]), MLE_S_OK);
+        EXPECT_EQ(blocks[i], nullptr);
+    }
+}
+
+TEST(BlockMemoryManagerTest, RejectsForeignMemory) {
+    MleBlockMemoryManager<64> first(64);
+    MleBlockMemoryManager<64> second(64);
+
+    void *memory = NULL;
+    ASSERT_EQ(first.allocate(&memory, 64), MLE_S_OK);
+    EXPECT_NE(second.release(&memory), MLE_S_OK);
+    EXPECT_EQ(first.release(&memory), MLE_S_OK);
+}
+
+TEST(BlockMemoryManagerTest, RejectsUnmappedAndMisalignedMemory) {
+    MleBlockMemoryManager<64> manager(64);
+
+    // The chunk-aligned address below this pointer is not readable.
+    const size_t span = 1024 * 1024;
+    char *region = (char *) mmap(NULL, span, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(region, (char *) MAP_FAILED);
+    char *aligned = (char *) (((size_t) region + span / 2 - 1) & ~(size_t) (span / 2 - 1));
+    void *memory = aligned + 256;
+    EXPECT_EQ(manager.release(&memory), (MlResult) MLE_E_FAIL);
+    munmap(region, span);
+
+    void *block = NULL;
+    ASSERT_EQ(manager.allocate(&block, 64), MLE_S_OK);
+    memory = (char *) block + 8;
+    EXPECT_EQ(manager.release(&memory), (MlResult) MLE_E_FAIL);
+    EXPECT_EQ(manager.release(&block), MLE_S_OK);
+}
+
+TEST(BlockMemoryManagerTest, TrimReleasesEmptyChunks) {
+    MleBlockMemoryManager<256> manager(0);
+    EXPECT_EQ(manager.getChunkCount(), 0u);
+
+    std::vector<void *> blocks(2000);
+    for (size_t i = 0; i < blocks.size(); i++)
+        ASSERT_EQ(manager.allocate(&blocks[i], 200), MLE_S_OK);
+    uint_t chunks = manager.getChunkCount();
+    ASSERT_GT(chunks, 2u);
+
+    // Keep the first block; every other chunk becomes empty.
+    for (size_t i = 1; i < blocks.size(); i++)
+        ASSERT_EQ(manager.release(&blocks[i]), MLE_S_OK);
+    EXPECT_EQ(manager.trim(), chunks - 1);
+    EXPECT_EQ(manager.getChunkCount(), 1u);
+
+    // The surviving chunk still serves allocations.
+    for (size_t i = 1; i < blocks.size(); i++)
+        ASSERT_EQ(manager.allocate(&blocks[i], 256), MLE_S_OK);
+    for (size_t i = 0; i < blocks.size(); i++)
+        ASSERT_EQ(manager.release(&blocks[i]), MLE_S_OK);
+}
+
+TEST(BlockMemoryManagerTest, ConcurrentThreads) {
+    MleBlockMemoryManager<32> manager(0);
+    const int numThreads = 4;
+    const int numRounds = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&manager, t]() {
+            void *blocks[128] = { NULL };
+            for (int round = 0; round < numRounds; round++) {
+                void *&block = blocks[round % 128];
+                if (block != NULL) {
+                    EXPECT_EQ(*(int *)block, t * numRounds + round - 128);
+                    manager.release(&block);
+                }
+                ASSERT_EQ(manager.allocate(&block, 32), MLE_S_OK);
+                *(int *)block = t * numRounds + round;
+            }
+            for (int i = 0; i < 128; i++)
+                manager.release(&blocks[i]);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    // Every block was returned, so every chunk can be released.
+    uint_t chunks = manager.getChunkCount();
+    EXPECT_EQ(manager.trim(), chunks);
+    EXPECT_EQ(manager.getChunkCount(), 0u);
+}
+
+TEST(ArenaMemoryManagerTest, AllocateAligned) {
+    MleArenaMemoryManager arena(4096);
+    EXPECT_EQ(arena.getReservedSize(), 0u);
+
+    void *blocks[100];
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(arena.allocate(&blocks[i], 1 + i * 3), MLE_S_OK);
+        EXPECT_EQ((size_t)blocks[i] % 16, 0u);
+        memset(blocks[i], i, 1 + i * 3);
+    }
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(((unsigned char *)blocks[i])[i * 3], (unsigned char)i);
+
+    // Requests larger than a chunk get a chunk of their own.
+    void *large = NULL;
+    ASSERT_EQ(arena.allocate(&large, 100000), MLE_S_OK);
+    memset(large, 0, 100000);
+    EXPECT_GT(arena.getReservedSize(), 100000u);
+
+    // Release is a no-op apart from clearing the pointer.
+    EXPECT_EQ(arena.release(&blocks[0]), MLE_S_OK);
+    EXPECT_EQ(blocks[0], nullptr);
+}
+
+TEST(ArenaMemoryManagerTest, ResizeLastInPlace) {
+    MleArenaMemoryManager arena;
+
+    char *first = NULL;
+    ASSERT_EQ(arena.dupString((const MlChar *)"first", (MlChar **)&first), MLE_S_OK);
+    char *text = NULL;
+    ASSERT_EQ(arena.dupString((const MlChar *)"grow me", (MlChar **)&text), MLE_S_OK);
+
+    char *before = text;
+    ASSERT_EQ(arena.resize((void **)&text, 1000), MLE_S_OK);
+    EXPECT_EQ(text, before);
+    EXPECT_STREQ(text, "grow me");
+
+    // An earlier allocation is copied.
+    ASSERT_EQ(arena.resize((void **)&first, 64), MLE_S_OK);
+    EXPECT_NE(first, before);
+    EXPECT_STREQ(first, "first");
+}
+
+TEST(ArenaMemoryManagerTest, RewindAndReset) {
+    MleArenaMemoryManager arena(4096);
+
+    void *memory = NULL;
+    ASSERT_EQ(arena.allocate(&memory, 100), MLE_S_OK);
+    MlULong allocated = arena.getAllocatedSize();
+
+    MleArenaMemoryManager::Marker marker = arena.getMarker();
+    for (int i = 0; i < 1000; i++)
+        ASSERT_EQ(arena.allocate(&memory, 64), MLE_S_OK);
+    EXPECT_GT(arena.getReservedSize(), 4096u * 10);
+
+    arena.rewind(marker);
+    EXPECT_EQ(arena.getAllocatedSize(), allocated);
+    EXPECT_LE(arena.getReservedSize(), 4096u * 2);
+
+    // Memory handed out after the rewind starts where the marker was taken.
+    void *next = NULL;
+    {
+        MleArenaMemoryManager::Scope scope(arena);
+        ASSERT_EQ(arena.allocate(&next, 16), MLE_S_OK);
+        EXPECT_GT(arena.getAllocatedSize(), allocated);
+    }
+    EXPECT_EQ(arena.getAllocatedSize(), allocated);
+
+    arena.reset();
+    EXPECT_EQ(arena.getAllocatedSize(), 0u);
+    ASSERT_EQ(arena.allocate(&memory, 16), MLE_S_OK);
+}
+
+TEST(ProfilingMemoryManagerTest, CountsPerTag) {
+    MleProfilingMemoryManager manager;
+    uint_t tag = MleProfilingMemoryManager::getTagId("profiling test");
+    EXPECT_EQ(MleProfilingMemoryManager::getTagId("profiling test"), tag);
+    EXPECT_NE(tag, 0u);
+
+    void *untagged = NULL;
+    ASSERT_EQ(manager.allocate(&untagged, 100), MLE_S_OK);
+
+    void *tagged[3];
+    {
+        MleAllocationTag scope(tag);
+        EXPECT_EQ(MleProfilingMemoryManager::getCurrentTag(), tag);
+        for (int i = 0; i < 3; i++)
+            ASSERT_EQ(manager.allocate(&tagged[i], 1000), MLE_S_OK);
+    }
+    EXPECT_EQ(MleProfilingMemoryManager::getCurrentTag(), 0u);
+
+    // Resized memory stays charged to its tag.
+    ASSERT_EQ(manager.resize(&tagged[0], 3000), MLE_S_OK);
+    ASSERT_EQ(manager.release(&tagged[1]), MLE_S_OK);
+    void *nothing = NULL;
+    EXPECT_EQ(manager.release(&nothing), MLE_S_OK);
+
+    MleAllocationStats stats;
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_allocations, 4u);
+    EXPECT_EQ(stats.m_releases, 1u);
+    EXPECT_EQ(stats.m_bytesLive, 100u + 3000u + 1000u);
+    EXPECT_GE(stats.m_peakBytesLive, stats.m_bytesLive);
+    EXPECT_EQ(stats.m_histogram[7], 1u);   // 100 bytes
+    EXPECT_EQ(stats.m_histogram[10], 3u);  // 1000 bytes
+    EXPECT_EQ(stats.m_histogram[12], 1u);  // 3000 bytes
+
+    bool found = false;
+    for (size_t i = 0; i < stats.m_tags.size(); i++) {
+        if (strcmp(stats.m_tags[i].m_name, "profiling test") == 0) {
+            found = true;
+            EXPECT_EQ(stats.m_tags[i].m_allocations, 3u);
+            EXPECT_EQ(stats.m_tags[i].m_releases, 1u);
+            EXPECT_EQ(stats.m_tags[i].m_bytesAllocated, 5000u);
+            EXPECT_EQ(stats.m_tags[i].m_bytesLive, 4000u);
+        }
+    }
+    EXPECT_TRUE(found);
+
+    manager.release(&untagged);
+    manager.release(&tagged[0]);
+    manager.release(&tagged[2]);
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_bytesLive, 0u);
+}
+
+TEST(ProfilingMemoryManagerTest, WrapsTargetAndDumps) {
+    MleArenaMemoryManager arena;
+    MleProfilingMemoryManager manager(&arena);
+
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocate(&memory, 40), MLE_S_OK);
+    EXPECT_GT(arena.getAllocatedSize(), 40u);
+
+    // Memory from another manager is refused.
+    void *foreign = NULL;
+    ASSERT_EQ(arena.allocate(&foreign, 40), MLE_S_OK);
+    memset(foreign, 0, 40);
+    EXPECT_NE(manager.release(&foreign), MLE_S_OK);
+
+    char buffer[4096];
+    FILE *file = fmemopen(buffer, sizeof(buffer), "w");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(manager.dumpStats(file, TRUE), MLE_S_OK);
+    fclose(file);
+    EXPECT_NE(strstr(buffer, "\"bytesLive\":40"), nullptr);
+    EXPECT_NE(strstr(buffer, "{\"name\":\"untagged\",\"allocations\":1,"), nullptr);
+
+    file = fmemopen(buffer, sizeof(buffer), "w");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(manager.dumpStats(file), MLE_S_OK);
+    fclose(file);
+    EXPECT_NE(strstr(buffer, "bytes live 40"), nullptr);
+
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+}
+
+TEST(ProfilingMemoryManagerTest, ConcurrentThreads) {
+    MleProfilingMemoryManager manager;
+    const int numThreads = 4;
+    const int numRounds = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&manager]() {
+            void *blocks[16] = { NULL };
+            for (int round = 0; round < numRounds; round++) {
+                void *&block = blocks[round % 16];
+                if (block != NULL)
+                    manager.release(&block);
+                manager.allocate(&block, 64 + round % 512);
+            }
+            for (int i = 0; i < 16; i++)
+                manager.release(&blocks[i]);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    MleAllocationStats stats;
+    manager.getStats(stats);
+    EXPECT_EQ(stats.m_allocations, (MlULong)(numThreads * numRounds));
+    EXPECT_EQ(stats.m_releases, stats.m_allocations);
+    EXPECT_EQ(stats.m_bytesLive, 0u);
+}
+
+TEST(ProfilingMemoryManagerTest, SamplesLiveAllocations) {
+    MleProfilingMemoryManager manager;
+    EXPECT_EQ(manager.getSampleInterval(), 0u);
+
+    // Without an interval nothing is sampled.
+    void *memory = NULL;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(manager.allocate(&memory, 1024), MLE_S_OK);
+        ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+    }
+    EXPECT_EQ(manager.getLiveSampleCount(), 0u);
+
+    // About one in four 1K allocations is sampled.
+    manager.setSampleInterval(4096);
+    std::vector<void *> blocks(4000);
+    for (size_t i = 0; i < blocks.size(); i++)
+        ASSERT_EQ(manager.allocate(&blocks[i], 1024), MLE_S_OK);
+    uint_t samples = manager.getLiveSampleCount();
+    EXPECT_GT(samples, 700u);
+    EXPECT_LT(samples, 1300u);
+
+    // Sampled allocations are tracked across resize and dropped on release.
+    for (size_t i = 0; i < blocks.size(); i += 2)
+        ASSERT_EQ(manager.resize(&blocks[i], 100000), MLE_S_OK);
+    EXPECT_EQ(manager.getLiveSampleCount(), samples);
+
+    char *buffer = NULL;
+    size_t length = 0;
+    FILE *file = open_memstream(&buffer, &length);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(manager.dumpHeapProfile(file), MLE_S_OK);
+    fclose(file);
+    EXPECT_EQ(strncmp(buffer, "heap profile: ", 14), 0);
+    EXPECT_NE(strstr(buffer, "@ heap_v2/4096\n"), nullptr);
+    EXPECT_NE(strstr(buffer, "MAPPED_LIBRARIES:"), nullptr);
+    free(buffer);
+
+    file = open_memstream(&buffer, &length);
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(manager.dumpHeapProfile(file, TRUE), MLE_S_OK);
+    fclose(file);
+    // Each line is a stack followed by its estimated live bytes.
+    ASSERT_GT(length, 0u);
+    EXPECT_EQ(buffer[length - 1], '\n');
+    char *weight = strrchr(buffer, ' ');
+    ASSERT_NE(weight, nullptr);
+    EXPECT_GT(strtoull(weight + 1, NULL, 10), 0u);
+    free(buffer);
+
+    for (size_t i = 0; i < blocks.size(); i++)
+        ASSERT_EQ(manager.release(&blocks[i]), MLE_S_OK);
+    EXPECT_EQ(manager.getLiveSampleCount(), 0u);
+}
+
+#define TRACE_FILE "MleAllocationTest.trace"
+
+TEST(AllocationTraceTest, RecordAndReplay) {
+    MleRecordingMemoryManager recorder;
+    ASSERT_EQ(recorder.startRecording(TRACE_FILE), MLE_S_OK);
+
+    void *a = NULL, *b = NULL, *c = NULL, *d = NULL, *e = NULL, *f = NULL;
+    ASSERT_EQ(recorder.allocate(&a, 100), MLE_S_OK);
+    ASSERT_EQ(recorder.allocate(&b, 200), MLE_S_OK);
+    ASSERT_EQ(recorder.resize(&a, 300), MLE_S_OK);
+    ASSERT_EQ(recorder.release(&b), MLE_S_OK);
+    ASSERT_EQ(recorder.allocate(&c, 50), MLE_S_OK);
+    ASSERT_EQ(recorder.allocateAligned(&d, 64, 64), MLE_S_OK);
+    ASSERT_EQ(recorder.releaseAligned(&d), MLE_S_OK);
+    EXPECT_EQ(recorder.tryResizeInPlace(c, 40), MLE_S_OK);
+
+    // An injected failure is recorded as such.
+    MleMemoryManager::setThreadAllocationLimit(1);
+    ASSERT_EQ(recorder.allocate(&e, 10), MLE_S_OK);
+    EXPECT_NE(recorder.allocate(&f, 10), MLE_S_OK);
+    MleMemoryManager::setThreadAllocationLimit(0);
+    ASSERT_EQ(recorder.release(&e), MLE_S_OK);
+
+    std::thread other([&recorder]()
+    {
+        void *memory = NULL;
+        ASSERT_EQ(recorder.allocate(&memory, 1000), MLE_S_OK);
+        ASSERT_EQ(recorder.release(&memory), MLE_S_OK);
+    });
+    other.join();
+
+    ASSERT_EQ(recorder.release(&a), MLE_S_OK);
+    EXPECT_EQ(recorder.getRecordCount(), 14u);
+    ASSERT_EQ(recorder.stopRecording(), MLE_S_OK);
+
+    // Not recorded any more.
+    ASSERT_EQ(recorder.release(&c), MLE_S_OK);
+
+    MleAllocationReplay replay;
+    ASSERT_EQ(replay.load(TRACE_FILE), MLE_S_OK);
+    EXPECT_EQ(replay.getRecordCount(), 14u);
+    EXPECT_EQ(replay.getRecordedFailureCount(), 1u);
+    EXPECT_EQ(replay.getThreadCount(), 2u);
+    EXPECT_EQ(replay.getObjectCount(), 3u);
+
+    MleMemoryManager manager;
+    MleReplayStats stats;
+    ASSERT_EQ(replay.run(&manager, stats, TRUE), MLE_S_OK);
+    EXPECT_EQ(stats.m_operations, 13u);
+    EXPECT_EQ(stats.m_failures, 0u);
+    EXPECT_EQ(stats.m_peakRequestedBytes, 300u + 40u + 1000u);
+    EXPECT_GE(stats.m_peakUsableBytes, stats.m_peakRequestedBytes);
+    EXPECT_GT(stats.m_peakResidentSize, 0u);
+
+    // The same requests fail at the same point every time.
+    for (int i = 0; i < 2; i++)
+	{
+        MleMemoryManager::setThreadAllocationLimit(2);
+        ASSERT_EQ(replay.run(&manager, stats), MLE_S_OK);
+        MleMemoryManager::setThreadAllocationLimit(0);
+        EXPECT_EQ(stats.m_operations, 9u);
+        EXPECT_EQ(stats.m_failures, 5u);
+    }
+
+    remove(TRACE_FILE);
+}
+
+TEST(AllocationTraceTest, LoadDamagedTrace) {
+    MleRecordingMemoryManager recorder;
+    ASSERT_EQ(recorder.startRecording(TRACE_FILE), MLE_S_OK);
+    void *memory = NULL;
+    ASSERT_EQ(recorder.allocate(&memory, 100000), MLE_S_OK);
+    ASSERT_EQ(recorder.release(&memory), MLE_S_OK);
+    ASSERT_EQ(recorder.stopRecording(), MLE_S_OK);
+
+    // Cut the trace in the middle of the first record's size.
+    FILE *file = fopen(TRACE_FILE, "rb");
+    ASSERT_TRUE(file != NULL);
+    unsigned char data[64];
+    size_t length = fread(data, 1, sizeof(data), file);
+    fclose(file);
+    ASSERT_GT(length, 19u);
+
+    file = fopen(TRACE_FILE, "wb");
+    fwrite(data, 1, 19, file);
+    fclose(file);
+
+    MleAllocationReplay replay;
+    ASSERT_EQ(replay.load(TRACE_FILE), MLE_S_OK);
+    EXPECT_EQ(replay.getRecordCount(), 0u);
+
+    // Anything else is rejected.
+    data[0] = 'X';
+    file = fopen(TRACE_FILE, "wb");
+    fwrite(data, 1, length, file);
+    fclose(file);
+    EXPECT_NE(replay.load(TRACE_FILE), MLE_S_OK);
+    EXPECT_NE(replay.load("MleAllocationTest.missing"), MLE_S_OK);
+
+    remove(TRACE_FILE);
+}
+
+TEST(NumaMemoryManagerTest, FakeTopology) {
+    setenv("MleNumaFakeNodes", "4", 1);
+    MleLinuxNumaMemoryManager manager;
+    unsetenv("MleNumaFakeNodes");
+
+    ASSERT_EQ(manager.getNodeCount(), 4u);
+    EXPECT_TRUE(manager.isFakeTopology());
+
+    // Each new thread gets the next node.
+    uint_t nodes[4];
+    for (int i = 0; i < 4; i++)
+	{
+        std::thread worker([&manager, &nodes, i]()
+        {
+            void *memory = NULL;
+            ASSERT_EQ(manager.allocate(&memory, 100), MLE_S_OK);
+            nodes[i] = manager.getNode(memory);
+            EXPECT_EQ(nodes[i], manager.getCurrentNode());
+            ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+        });
+        worker.join();
+    }
+    for (int i = 1; i < 4; i++)
+        EXPECT_EQ(nodes[i], (nodes[0] + i) % 4);
+
+    MleLinuxNumaMemoryManager::setThreadNode(2);
+    EXPECT_EQ(manager.getCurrentNode(), 2u);
+    void *small = NULL;
+    ASSERT_EQ(manager.allocate(&small, 100), MLE_S_OK);
+    EXPECT_EQ(manager.getNode(small), 2u);
+    EXPECT_EQ(manager.getNodeMappedSize(2), (MlULong) MleLinuxNumaMemoryManager::SPAN_SIZE);
+
+    // Resizing keeps the node, wherever the caller runs.
+    MleLinuxNumaMemoryManager::setThreadNode(0);
+    MlULong mapped = manager.getNodeMappedSize(0);
+    memset(small, 0x5a, 100);
+    ASSERT_EQ(manager.resize(&small, 5000), MLE_S_OK);
+    EXPECT_EQ(manager.getNode(small), 2u);
+    EXPECT_EQ(((MlUChar *) small)[99], 0x5a);
+    EXPECT_EQ(manager.getNodeMappedSize(0), mapped);
+
+    // A block released on another node goes back to its own heap.
+    void *released = small;
+    ASSERT_EQ(manager.release(&small), MLE_S_OK);
+    ASSERT_EQ(manager.allocateOnNode(&small, 5000, 2), MLE_S_OK);
+    EXPECT_EQ(small, released);
+    ASSERT_EQ(manager.release(&small), MLE_S_OK);
+
+    // Large buffers are mapped on their own.
+    void *large = NULL;
+    mapped = manager.getNodeMappedSize(3);
+    ASSERT_EQ(manager.allocateOnNode(&large, 4 << 20, 3), MLE_S_OK);
+    EXPECT_EQ(manager.getNode(large), 3u);
+    EXPECT_GE(manager.getNodeMappedSize(3), mapped + ((MlULong) 4 << 20));
+    EXPECT_EQ(manager.getResidentNode(large), -1);
+    ASSERT_EQ(manager.release(&large), MLE_S_OK);
+    EXPECT_EQ(manager.getNodeMappedSize(3), mapped);
+
+    EXPECT_NE(manager.allocateOnNode(&large, 100, 4), MLE_S_OK);
+    EXPECT_NE(manager.bindThreadToNode(4), MLE_S_OK);
+    MleLinuxNumaMemoryManager::setThreadNode(-1);
+}
+
+TEST(NumaMemoryManagerTest, SystemTopology) {
+    unsetenv("MleNumaFakeNodes");
+    MleLinuxNumaMemoryManager manager;
+    ASSERT_GE(manager.getNodeCount(), 1u);
+    EXPECT_FALSE(manager.isFakeTopology());
+
+    uint_t node = manager.getCurrentNode();
+    EXPECT_LT(node, manager.getNodeCount());
+
+    void *memory = NULL;
+    ASSERT_EQ(manager.allocate(&memory, 3 << 20), MLE_S_OK);
+    EXPECT_EQ(manager.getNode(memory), node);
+    memset(memory, 1, 3 << 20);
+
+    // The kernel may refuse to say, as in a sandbox.
+    MlInt resident = manager.getResidentNode(memory);
+    EXPECT_TRUE(resident == -1 || resident == (MlInt) node);
+
+    EXPECT_GE(manager.getUsableSize(memory), (MlULong) 3 << 20);
+    ASSERT_EQ(manager.resize(&memory, 8 << 20), MLE_S_OK);
+    EXPECT_EQ(((MlUChar *) memory)[(3 << 20) - 1], 1);
+    EXPECT_EQ(manager.tryResizeInPlace(memory, 100), MLE_S_OK);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+
+    // Failure injection applies.
+    MleMemoryManager::setThreadAllocationLimit(1);
+    ASSERT_EQ(manager.allocate(&memory, 10), MLE_S_OK);
+    void *other = NULL;
+    EXPECT_NE(manager.allocate(&other, 10), MLE_S_OK);
+    MleMemoryManager::setThreadAllocationLimit(0);
+    ASSERT_EQ(manager.release(&memory), MLE_S_OK);
+
+    if (manager.bindThreadToNode(node) == MLE_S_OK) {
+        EXPECT_EQ(manager.getCurrentNode(), node);
+    }
+    MleLinuxNumaMemoryManager::setThreadNode(-1);
+}
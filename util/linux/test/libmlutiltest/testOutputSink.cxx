@@ -0,0 +1,117 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/MleOutputSink.h"
+
+
+// Read back everything written to a temporary file.
+static std::string readBack(FILE *fp)
+{
+    std::string result;
+    fflush(fp);
+    rewind(fp);
+    int c;
+    while ((c = fgetc(fp)) != EOF)
+        result += (char) c;
+    return result;
+}
+
+
+TEST(MleOutputSinkTest, BufferSink) {
+    MleBufferSink sink;
+    EXPECT_EQ(sink.getLength(), 0u);
+    EXPECT_EQ(sink.getData(), (const char *) NULL);
+
+    EXPECT_EQ(sink.write("abc", 3), MLE_S_OK);
+    EXPECT_EQ(sink.write("", 0), MLE_S_OK);
+    std::string big(100000, 'x');
+    EXPECT_EQ(sink.write(big.data(), big.size()), MLE_S_OK);
+    EXPECT_EQ(sink.flush(), MLE_S_OK);
+    ASSERT_EQ(sink.getLength(), 3u + big.size());
+    EXPECT_EQ(std::string(sink.getData(), sink.getLength()), "abc" + big);
+
+    sink.clear();
+    EXPECT_EQ(sink.getLength(), 0u);
+    EXPECT_EQ(sink.write("def", 3), MLE_S_OK);
+    EXPECT_EQ(std::string(sink.getData(), sink.getLength()), "def");
+}
+
+TEST(MleOutputSinkTest, FileSink) {
+    FILE *fp = tmpfile();
+    std::string expected;
+    {
+        // A small buffer exercises staging, topping up and direct writes.
+        MleFileSink sink(fileno(fp), 16);
+        const char *pieces[] = { "one ", "two ", "three ", "four five six seven ", "8", "" };
+        for (int round = 0; round < 50; round++) {
+            for (int i = 0; i < 6; i++) {
+                EXPECT_EQ(sink.write(pieces[i], strlen(pieces[i])), MLE_S_OK);
+                expected += pieces[i];
+            }
+        }
+        std::string big(1000, 'y');
+        EXPECT_EQ(sink.write(big.data(), big.size()), MLE_S_OK);
+        expected += big;
+        EXPECT_EQ(sink.write("tail", 4), MLE_S_OK);
+        expected += "tail";
+    }
+    EXPECT_EQ(readBack(fp), expected);
+    fclose(fp);
+
+    // Writing to a bad descriptor fails, and keeps failing.
+    MleFileSink bad(-1, 16);
+    EXPECT_EQ(bad.write("0123456789abcdefghij", 20), (MlResult) MLE_E_FAIL);
+    EXPECT_EQ(bad.write("x", 1), (MlResult) MLE_E_FAIL);
+    EXPECT_EQ(bad.flush(), (MlResult) MLE_E_FAIL);
+}
+
+TEST(MleOutputSinkTest, StdioSink) {
+    FILE *fp = tmpfile();
+    MleStdioSink sink(fp);
+    EXPECT_EQ(sink.getFile(), fp);
+    EXPECT_EQ(sink.write("hello ", 6), MLE_S_OK);
+    EXPECT_EQ(sink.write("world", 5), MLE_S_OK);
+    EXPECT_EQ(sink.flush(), MLE_S_OK);
+    EXPECT_EQ(readBack(fp), "hello world");
+    fclose(fp);
+}
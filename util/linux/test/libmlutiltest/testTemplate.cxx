@@ -0,0 +1,466 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/MleTemplate.h"
+#include "mle/MleThreadPool.h"
+
+
+// Read a template from a string.
+static MleTemplate *readTemplate(const char *text)
+{
+    FILE *fd = tmpfile();
+    fputs(text, fd);
+    rewind(fd);
+    MleTemplate *t = new MleTemplate();
+    t->read(fd);
+    fclose(fd);
+    return t;
+}
+
+// Process a section and return what it wrote.
+static std::string expand(MleTemplate *t, const char *section, MleTemplateBindings *bindings)
+{
+    FILE *fd = tmpfile();
+    MleTemplateProcess process(section, t, bindings, fd);
+    process.go();
+
+    std::string result;
+    rewind(fd);
+    int c;
+    while ((c = fgetc(fd)) != EOF)
+        result += (char) c;
+    fclose(fd);
+    return result;
+}
+
+static void writeArgument(MleTemplateProcess *process, char *arg, void *data)
+{
+    (*(int *) data)++;
+    process->outstr((char *) "<");
+    process->outstr(arg != NULL ? arg : (char *) "null");
+    process->outstr((char *) ">");
+    process->tabTo(20);
+    process->outstr((char *) "|");
+}
+
+
+TEST(MleTemplateTest, ExpandsMacros) {
+    MleTemplate *t = readTemplate(
+        "%# A comment.\n"
+        "%% FIRST\n"
+        "int ${name} = ${value};\n"
+        "double pi = ${pi};\n"
+        "missing ${other} ${other(x)} ${}\n"
+        "%% SECOND\n"
+        "second\n");
+
+    MleTemplateBindings local;
+    local.defineConstant("name", "count");
+    local.defineConstant("value", 3);
+    MleTemplateBindings *global = new MleTemplateBindings();
+    global->defineConstant("pi", 3.5);
+    global->defineConstant("value", 4);
+    t->setGlobalBindings(global);
+
+    // Local bindings hide global ones; unbound macros are copied out.
+    const char *expected =
+        "int count = 3;\n"
+        "double pi = 3.5;\n"
+        "missing ${other} ${other(x)} ${}\n";
+    EXPECT_EQ(expand(t, "FIRST", &local), expected);
+    EXPECT_EQ(expand(t, "FIRST", &local), expected);
+    EXPECT_EQ(expand(t, "SECOND", &local), "second\n");
+    EXPECT_EQ(expand(t, "THIRD", &local), "");
+
+    // Redefining a binding replaces it.
+    local.defineConstant("value", "seven");
+    EXPECT_EQ(expand(t, "FIRST", NULL), "int ${name} = 4;\ndouble pi = 3.5;\nmissing ${other} ${other(x)} ${}\n");
+    EXPECT_EQ(expand(t, "FIRST", &local).substr(0, 18), "int count = seven;");
+
+    delete t;
+}
+
+TEST(MleTemplateTest, QuotingAndMalformedMacros) {
+    MleTemplate *t = readTemplate(
+        "%% S\n"
+        "a \\$ \\${one} \\\\${one} \\x $x $$ ${one$ ${a b} ${a(b c)} ${a(b)x\n"
+        "dropped ${one\n"
+        "joined \\\n"
+        "line ${one}\n");
+
+    MleTemplateBindings bindings;
+    bindings.defineConstant("one", 1);
+    EXPECT_EQ(expand(t, "S", &bindings),
+        "a $ ${one} \\\\1 \\x $x $$ ${one$ ${a b} ${a(b c)} ${a(b)x\n"
+        "dropped ${one\n"
+        "joined line 1\n");
+
+    delete t;
+}
+
+TEST(MleTemplateTest, Callbacks) {
+    MleTemplate *t = readTemplate(
+        "%% S\n"
+        "\t${cb(arg_%1)} ${cb()} ${cb}\n");
+
+    int calls = 0;
+    MleTemplateBindings bindings;
+    bindings.defineCallback("cb", writeArgument, &calls);
+
+    // The column follows tabs and text written by the callbacks.
+    EXPECT_EQ(expand(t, "S", &bindings), "\t<arg_%1>   | <>| <null>|\n");
+    EXPECT_EQ(calls, 3);
+
+    delete t;
+}
+
+TEST(MleTemplateTest, ManyBindingsAndSections) {
+    std::string text;
+    for (int i = 0; i < 300; i++)
+        text += "%% SECTION" + std::to_string(i) + "\n${b" + std::to_string(i) + "}\n";
+    text += "%% SECTION7\nhidden\n";
+    MleTemplate *t = readTemplate(text.c_str());
+
+    MleTemplateBindings bindings;
+    for (int i = 0; i < 300; i++)
+        bindings.defineConstant(("b" + std::to_string(i)).c_str(), i * 2);
+    for (int i = 0; i < 300; i += 3)
+        bindings.defineConstant(("b" + std::to_string(i)).c_str(), "redefined");
+
+    for (int i = 0; i < 300; i++) {
+        std::string expected = (i % 3 == 0) ? "redefined\n" : std::to_string(i * 2) + "\n";
+        std::string section = "SECTION" + std::to_string(i);
+        EXPECT_EQ(expand(t, section.c_str(), &bindings), expected) << section;
+    }
+    EXPECT_EQ(expand(t, "SECTION300", &bindings), "");
+
+    delete t;
+}
+
+TEST(MleTemplateTest, ChainedBindings) {
+    MleTemplate *t = readTemplate(
+        "%% S\n"
+        "${a} ${b} ${c} ${d}\n");
+
+    MleTemplateBindings *global = new MleTemplateBindings();
+    global->defineConstant("d", "global");
+    t->setGlobalBindings(global);
+
+    MleTemplateBindings outer;
+    outer.defineConstant("a", "outer");
+    outer.defineConstant("b", "outer");
+    MleTemplateBindings inner(&outer);
+    inner.defineConstant("b", "inner");
+    inner.defineConstant("c", "inner");
+    EXPECT_EQ(inner.getParent(), &outer);
+
+    // Inner bindings hide outer ones, and the global ones come last.
+    EXPECT_EQ(expand(t, "S", &inner), "outer inner inner global\n");
+    EXPECT_EQ(expand(t, "S", &outer), "outer outer ${c} global\n");
+
+    // Later changes to the parent are seen through the chain.
+    outer.defineConstant("a", 1);
+    EXPECT_EQ(expand(t, "S", &inner), "1 inner inner global\n");
+
+    delete t;
+}
+
+static void expandNested(MleTemplateProcess *process, char *arg, void *)
+{
+    MleTemplateProcess nested(arg, process);
+    nested.go();
+}
+
+TEST(MleTemplateTest, BufferSink) {
+    MleTemplate *t = readTemplate(
+        "%% OUTER\n"
+        "begin ${nest(INNER)} end\n"
+        "%% INNER\n"
+        "[${value}]");
+
+    MleTemplateBindings bindings;
+    bindings.defineConstant("value", 42);
+    bindings.defineCallback("nest", expandNested);
+
+    // Nested processes write to the same sink.
+    MleBufferSink sink;
+    MleTemplateProcess process("OUTER", t, &bindings, &sink);
+    EXPECT_EQ(process.getSink(), &sink);
+    EXPECT_EQ(process.getFileDescriptor(), (FILE *) NULL);
+    process.go();
+    EXPECT_EQ(std::string(sink.getData(), sink.getLength()), "begin [42] end\n");
+    EXPECT_EQ(expand(t, "OUTER", &bindings), "begin [42] end\n");
+
+    delete t;
+}
+
+TEST(MleTemplateTest, CopyOnWriteBindings) {
+    MleTemplate *t = readTemplate(
+        "%% S\n"
+        "${a} ${b} ${c}\n");
+
+    MleTemplateBindings base;
+    base.defineConstant("a", "base");
+    base.defineConstant("b", "base");
+
+    // Copies see the original's bindings, and changes stay with the table
+    // that made them.
+    MleTemplateBindings first(base);
+    MleTemplateBindings second = base;
+    first.defineConstant("b", "first");
+    second.defineConstant("c", "second");
+    EXPECT_EQ(expand(t, "S", &base), "base base ${c}\n");
+    EXPECT_EQ(expand(t, "S", &first), "base first ${c}\n");
+    EXPECT_EQ(expand(t, "S", &second), "base base second\n");
+
+    base.defineConstant("a", 1);
+    EXPECT_EQ(expand(t, "S", &first), "base first ${c}\n");
+    EXPECT_EQ(expand(t, "S", &base), "1 base ${c}\n");
+
+    second = first;
+    EXPECT_EQ(expand(t, "S", &second), "base first ${c}\n");
+
+    delete t;
+}
+
+TEST(MleTemplateTest, BatchProcessing) {
+    MleTemplate *t = readTemplate(
+        "%% HEADER\n"
+        "class ${name} { int m_index = ${index}; };\n"
+        "%% SOURCE\n"
+        "// ${name}\n"
+        "${name}::${name}() {}\n");
+    MleTemplateBindings *global = new MleTemplateBindings();
+    global->defineConstant("index", -1);
+    t->setGlobalBindings(global);
+
+    MleTemplateBindings base;
+    base.defineConstant("name", "Base");
+
+    const int numJobs = 200;
+    std::vector<MleTemplateBindings> bindings(numJobs / 2, base);
+    std::vector<MleBufferSink> sinks(numJobs + 1);
+    std::vector<MleTemplateJob> jobs(numJobs + 1);
+    for (int i = 0; i < numJobs; i++) {
+        MleTemplateBindings &local = bindings[i / 2];
+        if (i % 2 == 0) {
+            std::string name = "Actor" + std::to_string(i / 2);
+            local.defineConstant("name", name.c_str());
+            if (i % 4 == 0)
+                local.defineConstant("index", i / 2);
+        }
+        jobs[i].m_section = (i % 2 == 0) ? "HEADER" : "SOURCE";
+        jobs[i].m_bindings = &local;
+        jobs[i].m_sink = &sinks[i];
+    }
+    jobs[numJobs].m_section = "MISSING";
+    jobs[numJobs].m_bindings = &base;
+    jobs[numJobs].m_sink = &sinks[numJobs];
+
+    MleThreadPool pool(4);
+    EXPECT_EQ(t->process(&jobs[0], numJobs + 1, &pool), 1);
+    EXPECT_EQ(jobs[numJobs].m_result, -1);
+
+    // Every job matches the same section processed on its own.
+    for (int i = 0; i < numJobs; i++) {
+        EXPECT_EQ(jobs[i].m_result, 0);
+        std::string output(sinks[i].getData(), sinks[i].getLength());
+        EXPECT_EQ(output, expand(t, jobs[i].m_section, jobs[i].m_bindings)) << i;
+    }
+    EXPECT_EQ(std::string(sinks[4].getData(), sinks[4].getLength()),
+              "class Actor2 { int m_index = 2; };\n");
+    EXPECT_EQ(std::string(sinks[6].getData(), sinks[6].getLength()),
+              "class Actor3 { int m_index = -1; };\n");
+    EXPECT_EQ(expand(t, "HEADER", &base), "class Base { int m_index = -1; };\n");
+
+    delete t;
+}
+
+static void countCall(MleTemplateProcess *process, char *, void *data)
+{
+    (*(int *) data)++;
+    process->outstr((char *) "called");
+}
+
+static std::string readFile(const std::string &path)
+{
+    std::string result;
+    FILE *fd = fopen(path.c_str(), "r");
+    if (fd != NULL) {
+        int c;
+        while ((c = fgetc(fd)) != EOF)
+            result += (char) c;
+        fclose(fd);
+    }
+    return result;
+}
+
+static time_t modificationTime(const std::string &path)
+{
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) ? info.st_mtime : 0;
+}
+
+TEST(MleTemplateTest, HashSection) {
+    MleTemplate *t = readTemplate(
+        "%% PLAIN\n"
+        "a ${x} b ${y} c ${z}\n"
+        "%% CALLS\n"
+        "${call}\n");
+    MleTemplateBindings *global = new MleTemplateBindings();
+    global->defineConstant("y", 2.5);
+    t->setGlobalBindings(global);
+
+    int calls = 0;
+    MleTemplateBindings bindings;
+    bindings.defineConstant("x", "ex");
+    bindings.defineCallback("call", countCall, &calls);
+
+    // The hash matches the hash of the output, without producing it.
+    MlULong hash;
+    ASSERT_TRUE(t->hashSection("PLAIN", &bindings, &hash));
+    std::string output = expand(t, "PLAIN", &bindings);
+    EXPECT_EQ(hash, MleTemplate::hashOutput(output.data(), output.size()));
+
+    bindings.defineConstant("z", 3);
+    MlULong changed;
+    ASSERT_TRUE(t->hashSection("PLAIN", &bindings, &changed));
+    EXPECT_NE(changed, hash);
+
+    EXPECT_FALSE(t->hashSection("CALLS", &bindings, &hash));
+    EXPECT_FALSE(t->hashSection("MISSING", &bindings, &hash));
+    EXPECT_EQ(calls, 0);
+
+    // FNV-1a of "a".
+    EXPECT_EQ(MleTemplate::hashOutput("a", 1), 0xaf63dc4c8601ec8cULL);
+
+    delete t;
+}
+
+TEST(MleTemplateTest, Manifest) {
+    char dir[] = "/tmp/mleManifestXXXXXX";
+    ASSERT_NE(mkdtemp(dir), (char *) NULL);
+    std::string manifestFile = std::string(dir) + "/manifest";
+    std::string plain = std::string(dir) + "/plain.h";
+    std::string calls = std::string(dir) + "/calls.h";
+
+    MleTemplate *t = readTemplate(
+        "%% PLAIN\n"
+        "int ${name};\n"
+        "%% CALLS\n"
+        "// ${call}\n");
+
+    int numCalls = 0;
+    MleTemplateBindings bindings;
+    bindings.defineConstant("name", "first");
+    bindings.defineCallback("call", countCall, &numCalls);
+
+    {
+        MleTemplateManifest manifest;
+        EXPECT_EQ(manifest.read(manifestFile.c_str()), 0);
+        EXPECT_EQ(manifest.getCount(), 0);
+        EXPECT_EQ(manifest.generate(t, "PLAIN", &bindings, plain.c_str()), (int) MleTemplateManifest::WRITTEN);
+        EXPECT_EQ(manifest.generate(t, "CALLS", &bindings, calls.c_str()), (int) MleTemplateManifest::WRITTEN);
+        EXPECT_EQ(manifest.generate(t, "MISSING", &bindings, (std::string(dir) + "/x").c_str()),
+                  (int) MleTemplateManifest::FAILED);
+        EXPECT_EQ(manifest.generate(t, "PLAIN", &bindings, (std::string(dir) + "/none/x").c_str()),
+                  (int) MleTemplateManifest::FAILED);
+        EXPECT_EQ(manifest.getCount(), 2);
+        EXPECT_EQ(manifest.write(manifestFile.c_str()), 0);
+    }
+    EXPECT_EQ(readFile(plain), "int first;\n");
+    EXPECT_EQ(readFile(calls), "// called\n");
+    EXPECT_EQ(numCalls, 1);
+
+    // Backdate the files to see whether they are written again.
+    struct utimbuf old;
+    old.actime = old.modtime = 1000000000;
+    utime(plain.c_str(), &old);
+    utime(calls.c_str(), &old);
+
+    MleTemplateManifest manifest;
+    EXPECT_EQ(manifest.read(manifestFile.c_str()), 0);
+    EXPECT_EQ(manifest.getCount(), 2);
+
+    // Unchanged output is left alone. Sections with callbacks are expanded
+    // to find out.
+    EXPECT_EQ(manifest.generate(t, "PLAIN", &bindings, plain.c_str()), (int) MleTemplateManifest::UNCHANGED);
+    EXPECT_EQ(manifest.generate(t, "CALLS", &bindings, calls.c_str()), (int) MleTemplateManifest::UNCHANGED);
+    EXPECT_EQ(numCalls, 2);
+    EXPECT_EQ(modificationTime(plain), old.modtime);
+    EXPECT_EQ(modificationTime(calls), old.modtime);
+
+    // Changed bindings and missing files are generated again. A file that
+    // is replaced keeps its permissions.
+    ASSERT_EQ(chmod(plain.c_str(), 0640), 0);
+    bindings.defineConstant("name", "second");
+    EXPECT_EQ(manifest.generate(t, "PLAIN", &bindings, plain.c_str()), (int) MleTemplateManifest::WRITTEN);
+    EXPECT_EQ(readFile(plain), "int second;\n");
+    struct stat status;
+    ASSERT_EQ(stat(plain.c_str(), &status), 0);
+    EXPECT_EQ(status.st_mode & 0777, 0640u);
+    unlink(calls.c_str());
+    EXPECT_EQ(manifest.generate(t, "CALLS", &bindings, calls.c_str()), (int) MleTemplateManifest::WRITTEN);
+    EXPECT_EQ(readFile(calls), "// called\n");
+
+    EXPECT_EQ(manifest.write(manifestFile.c_str()), 0);
+    MleTemplateManifest reread;
+    EXPECT_EQ(reread.read(manifestFile.c_str()), 0);
+    MlULong hash, recorded;
+    ASSERT_TRUE(t->hashSection("PLAIN", &bindings, &hash));
+    ASSERT_TRUE(reread.lookup(plain.c_str(), &recorded));
+    EXPECT_EQ(recorded, hash);
+
+    reread.remove(plain.c_str());
+    EXPECT_FALSE(reread.lookup(plain.c_str(), &recorded));
+
+    unlink(plain.c_str());
+    unlink(calls.c_str());
+    unlink(manifestFile.c_str());
+    // No temporary files are left behind.
+    EXPECT_EQ(rmdir(dir), 0);
+    delete t;
+}
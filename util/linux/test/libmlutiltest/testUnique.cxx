@@ -0,0 +1,298 @@
+// COPYRIGHT_BEGIN
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+
+
+// Include system header files.
+#include <stdlib.h>
+#include <string>
+#include <atomic>
+#include <vector>
+#include <unordered_set>
+
+// Include Google Test header files.
+#include "gtest/gtest.h"
+
+// Include Magic Lantern header files.
+#include "mle/mlUnique.h"
+#include "mle/MleUnique.h"
+#include "mle/mlTypedUnique.h"
+#include "mle/MleThreadPool.h"
+
+
+// The first occurrences of the values, in order, as a reference.
+static std::vector<int> firstOccurrences(const std::vector<int> &values)
+{
+    std::vector<int> result;
+    std::unordered_set<int> seen;
+    for (size_t i = 0; i < values.size(); i++)
+        if (seen.insert(values[i]).second)
+            result.push_back(values[i]);
+    return result;
+}
+
+static std::vector<int> randomValues(int count, int range)
+{
+    std::vector<int> values(count);
+    srand(7);
+    for (int i = 0; i < count; i++)
+        values[i] = rand() % range;
+    return values;
+}
+
+// An equality test that is not an ordering, as mlUnique() allows.
+static int differInts(const void *a, const void *b)
+{
+    return (*(const int *) a != *(const int *) b) ? 1 : 0;
+}
+
+static int compareInts(const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+
+TEST(MleThreadPoolTest, RunsEveryIteration) {
+    MleThreadPool pool(4);
+    EXPECT_EQ(pool.getNumThreads(), 4u);
+
+    std::vector<std::atomic<int> > hits(1000);
+    for (int round = 0; round < 20; round++)
+        pool.run((int) hits.size(), [&](int i) { hits[i]++; });
+    for (size_t i = 0; i < hits.size(); i++)
+        EXPECT_EQ(hits[i].load(), 20);
+
+    // Nested loops run on the calling thread.
+    std::atomic<int> total(0);
+    pool.run(8, [&](int) {
+        pool.run(8, [&](int) { total++; });
+    });
+    EXPECT_EQ(total.load(), 64);
+
+    pool.run(0, [&](int) { total++; });
+    EXPECT_EQ(total.load(), 64);
+}
+
+TEST(MleUniqueTest, SortBased) {
+    MleThreadPool pool(4);
+    const int counts[] = { 0, 1, 2, 100, MleUnique::PARALLEL_THRESHOLD * 4 + 17 };
+    for (int c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++) {
+        std::vector<int> values = randomValues(counts[c], counts[c] / 3 + 1);
+        std::vector<int> expected = firstOccurrences(values);
+
+        int kept = MleUnique::sortBased(values.data(), (int) values.size(), std::less<int>(), &pool);
+        ASSERT_EQ(kept, (int) expected.size());
+        for (int i = 0; i < kept; i++)
+            ASSERT_EQ(values[i], expected[i]);
+    }
+
+    // A single thread gives the same answer.
+    MleThreadPool serial(1);
+    std::vector<int> values = randomValues(50000, 5000);
+    std::vector<int> expected = firstOccurrences(values);
+    ASSERT_EQ(MleUnique::sortBased(values.data(), (int) values.size(), std::less<int>(), &serial), (int) expected.size());
+    values.resize(expected.size());
+    EXPECT_EQ(values, expected);
+}
+
+TEST(MleUniqueTest, HashBased) {
+    const int counts[] = { 0, 1, 2, 100, 100000 };
+    for (int c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++) {
+        std::vector<int> values = randomValues(counts[c], counts[c] / 3 + 1);
+        std::vector<int> expected = firstOccurrences(values);
+
+        int kept = MleUnique::hashBased(values.data(), (int) values.size());
+        ASSERT_EQ(kept, (int) expected.size());
+        for (int i = 0; i < kept; i++)
+            ASSERT_EQ(values[i], expected[i]);
+    }
+
+    // Hashes that collide on every key still give the right answer.
+    std::vector<int> values = randomValues(2000, 300);
+    std::vector<int> expected = firstOccurrences(values);
+    int kept = MleUnique::hashBased(values.data(), (int) values.size(), [](int) { return (size_t) 1; });
+    ASSERT_EQ(kept, (int) expected.size());
+    values.resize(kept);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(MleUniqueTest, Arrays) {
+    const char *names[] = { "tree", "rock", "tree", "sky", "rock", "tree", "water" };
+    MleArray<std::string> sorted;
+    for (int i = 0; i < 7; i++)
+        sorted.push_back(names[i]);
+    MleArray<std::string> hashed(sorted);
+
+    EXPECT_EQ(MleUnique::sortBased(sorted), 4);
+    EXPECT_EQ(MleUnique::hashBased(hashed), 4);
+    ASSERT_EQ(sorted.size(), 4);
+    ASSERT_EQ(hashed.size(), 4);
+
+    const char *expected[] = { "tree", "rock", "sky", "water" };
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(sorted[i], expected[i]);
+        EXPECT_EQ(hashed[i], expected[i]);
+    }
+
+    // A custom ordering decides what counts as a duplicate.
+    MleArray<int> values;
+    for (int i = 0; i < 20; i++)
+        values.push_back(i);
+    EXPECT_EQ(MleUnique::sortBased(values, [](int a, int b) { return a / 5 < b / 5; }), 4);
+    EXPECT_EQ(values[0], 0);
+    EXPECT_EQ(values[1], 5);
+    EXPECT_EQ(values[2], 10);
+    EXPECT_EQ(values[3], 15);
+}
+
+TEST(MleUniqueTest, CFunction) {
+    int in1[] = { 1, 2, 3, 1, 2, 3, 1 };
+    EXPECT_EQ(mlUnique(in1, 7, sizeof(int), compareInts), 3);
+    EXPECT_EQ(in1[0], 1);
+    EXPECT_EQ(in1[1], 2);
+    EXPECT_EQ(in1[2], 3);
+
+    int in2[] = { 5, 2, 2, 3, 3, 4, 4, 5, 1 };
+    EXPECT_EQ(mlUnique(in2, 9, sizeof(int), compareInts), 5);
+    const int out2[] = { 5, 2, 3, 4, 1 };
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(in2[i], out2[i]);
+
+    EXPECT_EQ(mlUnique(NULL, 0, sizeof(int), compareInts), 0);
+
+    // Only equality matters; the comparison need not order the entries.
+    std::vector<int> values = randomValues(3000, 500);
+    std::vector<int> expected = firstOccurrences(values);
+    int kept = mlUnique(values.data(), (int) values.size(), sizeof(int), differInts);
+    ASSERT_EQ(kept, (int) expected.size());
+    values.resize(kept);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(MleUniqueTest, OrderedCFunction) {
+    int in[] = { 5, 2, 2, 3, 3, 4, 4, 5, 1 };
+    EXPECT_EQ(mlUniqueOrdered(in, 9, sizeof(int), compareInts), 5);
+    const int out[] = { 5, 2, 3, 4, 1 };
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(in[i], out[i]);
+
+    EXPECT_EQ(mlUniqueOrdered(NULL, 0, sizeof(int), compareInts), 0);
+
+    std::vector<int> values = randomValues(200000, 40000);
+    std::vector<int> expected = firstOccurrences(values);
+    int kept = mlUniqueOrdered(values.data(), (int) values.size(), sizeof(int), compareInts);
+    ASSERT_EQ(kept, (int) expected.size());
+    values.resize(kept);
+    EXPECT_EQ(values, expected);
+}
+
+// A 16 byte identifier, such as an asset's.
+struct AssetId
+{
+    MlULong m_high;
+    MlULong m_low;
+};
+
+TEST(MleTypedUniqueTest, IntegerKeys) {
+    EXPECT_EQ((int) (MleUniqueKeySize<int, std::equal_to<int> >::value), 4);
+    EXPECT_EQ((int) (MleUniqueKeySize<MlLong, std::equal_to<MlLong> >::value), 8);
+    EXPECT_EQ((int) (MleUniqueKeySize<AssetId, MleBitwiseEqual>::value), 16);
+    EXPECT_EQ((int) (MleUniqueKeySize<float, std::equal_to<float> >::value), 0);
+    EXPECT_EQ((int) (MleUniqueKeySize<std::string, std::equal_to<std::string> >::value), 0);
+
+    // Few distinct keys are scanned; many go to the hash table.
+    const int ranges[] = { 1, 7, 100, MLE_UNIQUE_SCAN_LIMIT, MLE_UNIQUE_SCAN_LIMIT + 1, 20000 };
+    for (int r = 0; r < (int) (sizeof(ranges) / sizeof(ranges[0])); r++) {
+        std::vector<int> values = randomValues(30000, ranges[r]);
+        std::vector<int> expected = firstOccurrences(values);
+
+        std::vector<MlLong> wide(values.begin(), values.end());
+        for (size_t i = 0; i < wide.size(); i++)
+            wide[i] = (wide[i] << 32) | 0x5a5a;
+
+        int kept = mlUnique(values.data(), (int) values.size());
+        ASSERT_EQ(kept, (int) expected.size());
+        values.resize(kept);
+        EXPECT_EQ(values, expected);
+
+        ASSERT_EQ(mlUnique(wide.data(), (int) wide.size()), (int) expected.size());
+        for (int i = 0; i < kept; i++)
+            ASSERT_EQ(wide[i], ((MlLong) expected[i] << 32) | 0x5a5a);
+    }
+
+    // Keys differing only in the upper half of 8 bytes are distinct.
+    MlLong halves[] = { 1, 1 + (1LL << 32), 1, 2 + (1LL << 32), 1 + (1LL << 32) };
+    EXPECT_EQ(mlUnique(halves, 5), 3);
+    EXPECT_EQ(halves[2], 2 + (1LL << 32));
+}
+
+TEST(MleTypedUniqueTest, BitwiseKeys) {
+    std::vector<int> values = randomValues(5000, 600);
+    std::vector<int> expected = firstOccurrences(values);
+
+    std::vector<AssetId> ids(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ids[i].m_high = (MlULong) (values[i] % 3);
+        ids[i].m_low = (MlULong) values[i];
+    }
+    int kept = mlUnique(ids.data(), (int) ids.size(), MleBitwiseEqual());
+    ASSERT_EQ(kept, (int) expected.size());
+    for (int i = 0; i < kept; i++) {
+        ASSERT_EQ(ids[i].m_low, (MlULong) expected[i]);
+        ASSERT_EQ(ids[i].m_high, (MlULong) (expected[i] % 3));
+    }
+
+    // Keys equal in one half only are distinct.
+    AssetId pair[4] = { { 1, 2 }, { 1, 3 }, { 4, 2 }, { 1, 2 } };
+    EXPECT_EQ(mlUnique(pair, 4, MleBitwiseEqual()), 3);
+}
+
+TEST(MleTypedUniqueTest, OtherTypes) {
+    MleArray<std::string> names;
+    const char *words[] = { "tree", "rock", "tree", "sky", "rock" };
+    for (int i = 0; i < 5; i++)
+        names.push_back(words[i]);
+    EXPECT_EQ(mlUnique(names), 3);
+    ASSERT_EQ(names.size(), 3);
+    EXPECT_EQ(names[2], "sky");
+
+    // The equality test decides what counts as a duplicate.
+    float values[] = { 1.0f, 1.25f, 2.0f, 2.5f, 3.0f };
+    EXPECT_EQ(mlUnique(values, 5, [](float a, float b) { return (int) a == (int) b; }), 3);
+    EXPECT_EQ(values[1], 2.0f);
+    EXPECT_EQ(values[2], 3.0f);
+
+    // The C function is still reached with its own signature.
+    int in[] = { 3, 3, 1 };
+    EXPECT_EQ(mlUnique(in, 3, sizeof(int), compareInts), 2);
+}
@@ -51,6 +51,13 @@
 #include <malloc.h>
 #endif
 
+#include <stdint.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <mach/mach.h>
+
 // Include Magic Lantern header files.
 #include "mle/MleMemoryManager.h"
 
@@ -71,16 +78,22 @@ MleMemoryManager::platformCleanup(void *&cookie)
 
 
 void *
-MleMemoryManager::platformAllocate(void * /* cookie */, MlUInt size)
+MleMemoryManager::platformAllocate(void * /* cookie */, MlULong size)
 {
-    return mlMalloc(size);
+    if (size > SIZE_MAX)
+        return NULL;
+
+    return mlMalloc((size_t) size);
 }
 
 
 void *
-MleMemoryManager::platformResize(void * /* cookie */, void *memory, MlUInt newSize)
+MleMemoryManager::platformResize(void * /* cookie */, void *memory, MlULong newSize)
 {
-    return mlRealloc(memory, newSize);
+    if (newSize > SIZE_MAX)
+        return NULL;
+
+    return mlRealloc(memory, (size_t) newSize);
 }
 
 
@@ -91,3 +104,71 @@ MleMemoryManager::platformRelease(void * /* cookie */, void *memory)
 
     return MLE_S_OK;
 }
+
+
+MlULong
+MleMemoryManager::platformUsableSize(void * /* cookie */, void *memory)
+{
+    return mlMallocUsableSize(memory);
+}
+
+
+void *
+MleMemoryManager::platformAllocateAligned(void * /* cookie */, MlULong size, uint_t alignment)
+{
+    if (size > SIZE_MAX)
+        return NULL;
+
+    void *memory;
+    if (posix_memalign(&memory, alignment, (size_t) size) != 0)
+        return NULL;
+
+    return memory;
+}
+
+
+MlResult
+MleMemoryManager::platformReleaseAligned(void * /* cookie */, void *memory)
+{
+    mlFree(memory);
+
+    return MLE_S_OK;
+}
+
+
+MlULong
+MleMemoryManager::platformResidentSize()
+{
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+    return info.resident_size;
+}
+
+
+uint_t
+MleMemoryManager::platformBacktrace(void **frames, uint_t maxFrames)
+{
+    int count = backtrace(frames, (int) maxFrames);
+    return (count > 0) ? (uint_t) count : 0;
+}
+
+
+MlBoolean
+MleMemoryManager::platformSymbolName(void *address, char *name, uint_t size)
+{
+    Dl_info info;
+    if ((size == 0) || (dladdr(address, &info) == 0) || (info.dli_sname == NULL))
+        return FALSE;
+
+    int status;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+    const char *symbol = (demangled != NULL) ? demangled : info.dli_sname;
+    strncpy(name, symbol, size - 1);
+    name[size - 1] = '\0';
+    free(demangled);
+
+    return TRUE;
+}
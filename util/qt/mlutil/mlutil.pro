@@ -30,8 +30,19 @@ SOURCES += \
     $$PWD/../../common/src/mlItoa.c \
     $$PWD/../../common/src/mlLogFile.c \
     $$PWD/../../common/src/mlUnique.c \
+    $$PWD/../../common/src/MleOutputSink.cxx \
+    $$PWD/../../common/src/MleAtom.cxx \
+    $$PWD/../../common/src/MleUnique.cxx \
+    $$PWD/../../common/src/MleThreadPool.cxx \
+    $$PWD/../../common/src/MleArrayOps.cxx \
+    $$PWD/../../common/src/MleAllocationReplay.cxx \
+    $$PWD/../../common/src/MleRecordingMemoryManager.cxx \
+    $$PWD/../../common/src/MleProfilingMemoryManager.cxx \
+    $$PWD/../../common/src/MleArenaMemoryManager.cxx \
+    $$PWD/../../common/src/MleThreadCacheMemoryManager.cxx \
     $$PWD/../../linux/src/MleLinuxMemoryManager.cxx \
-    $$PWD/../../linux/src/MleLinuxPath.cxx
+    $$PWD/../../linux/src/MleLinuxPath.cxx \
+    $$PWD/../../linux/src/MleLinuxNumaMemoryManager.cxx
 
 HEADERS += \
     $$PWD/../../common/include/mle/mlArray.h \
@@ -53,11 +64,28 @@ HEADERS += \
     $$PWD/../../common/include/mle/mlMalloc.h \
     $$PWD/../../common/include/mle/mlToken.h \
     $$PWD/../../common/include/mle/mlTypes.h \
+    $$PWD/../../common/include/mle/MleThreadCacheMemoryManager.h \
+    $$PWD/../../common/include/mle/MleArenaMemoryManager.h \
+    $$PWD/../../common/include/mle/MleProfilingMemoryManager.h \
+    $$PWD/../../common/include/mle/MleRecordingMemoryManager.h \
+    $$PWD/../../common/include/mle/MleAllocationReplay.h \
+    $$PWD/../../common/include/mle/mlSmallArray.h \
+    $$PWD/../../common/include/mle/mlAllocator.h \
+    $$PWD/../../common/include/mle/MleArrayOps.h \
+    $$PWD/../../common/include/mle/mlSoAArray.h \
+    $$PWD/../../common/include/mle/mlConcurrentArray.h \
+    $$PWD/../../common/include/mle/MleThreadPool.h \
+    $$PWD/../../common/include/mle/MleUnique.h \
+    $$PWD/../../common/include/mle/mlTypedUnique.h \
+    $$PWD/../../common/include/mle/mlHashTable.h \
+    $$PWD/../../common/include/mle/MleAtom.h \
+    $$PWD/../../common/include/mle/MleOutputSink.h \
     $$PWD/../../common/include/mle/mlUnique.h
 
 HEADERS += \
     $$PWD/../../linux/include/mle/MleLinuxPath.h \
-    $$PWD/../../linux/include/mle/mlPlatformDefs.h
+    $$PWD/../../linux/include/mle/mlPlatformDefs.h \
+    $$PWD/../../linux/include/mle/MleLinuxNumaMemoryManager.h
 
 # Default rules for deployment.
 unix {
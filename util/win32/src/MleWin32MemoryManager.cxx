@@ -43,6 +43,9 @@
 // Include system header files.
 #include <stdlib.h>
 #include <malloc.h>
+#include <stdint.h>
+#include <windows.h>
+#include <psapi.h>
 
 // Include Magic Lantern header files.
 #include "mle/MleMemoryManager.h"
@@ -64,16 +67,22 @@ MleMemoryManager::platformCleanup(void *&cookie)
 
 
 void *
-MleMemoryManager::platformAllocate(void * /* cookie */, MlUInt size)
+MleMemoryManager::platformAllocate(void * /* cookie */, MlULong size)
 {
-    return mlMalloc(size);
+    if (size > SIZE_MAX)
+        return NULL;
+
+    return mlMalloc((size_t) size);
 }
 
 
 void *
-MleMemoryManager::platformResize(void * /* cookie */, void *memory, MlUInt newSize)
+MleMemoryManager::platformResize(void * /* cookie */, void *memory, MlULong newSize)
 {
-    return mlRealloc(memory, newSize);
+    if (newSize > SIZE_MAX)
+        return NULL;
+
+    return mlRealloc(memory, (size_t) newSize);
 }
 
 
@@ -84,3 +93,54 @@ MleMemoryManager::platformRelease(void * /* cookie */, void *memory)
 
     return MLE_S_OK;
 }
+
+
+MlULong
+MleMemoryManager::platformUsableSize(void * /* cookie */, void *memory)
+{
+    return mlMallocUsableSize(memory);
+}
+
+
+void *
+MleMemoryManager::platformAllocateAligned(void * /* cookie */, MlULong size, uint_t alignment)
+{
+    if (size > SIZE_MAX)
+        return NULL;
+
+    return _aligned_malloc((size_t) size, alignment);
+}
+
+
+MlResult
+MleMemoryManager::platformReleaseAligned(void * /* cookie */, void *memory)
+{
+    _aligned_free(memory);
+
+    return MLE_S_OK;
+}
+
+
+MlULong
+MleMemoryManager::platformResidentSize()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if (! K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize;
+}
+
+
+uint_t
+MleMemoryManager::platformBacktrace(void **frames, uint_t maxFrames)
+{
+    return CaptureStackBackTrace(0, maxFrames, frames, NULL);
+}
+
+
+MlBoolean
+MleMemoryManager::platformSymbolName(void * /* address */, char * /* name */, uint_t /* size */)
+{
+    // Symbol lookup needs the debug help library; addresses are reported instead.
+    return FALSE;
+}